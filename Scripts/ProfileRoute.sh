@@ -0,0 +1,30 @@
+#!/usr/bin/env bash
+# Runs the scripted bot route headless on each map and collects the profiling summaries.
+# Usage: Scripts/ProfileRoute.sh <path to packaged game binary or UnrealEditor-Cmd> [maps...]
+# Summaries land in Saved/Profiling/BotwRoute, CSV profiles in Saved/Profiling/CSV.
+set -euo pipefail
+
+if [ $# -lt 1 ]; then
+	echo "Usage: $0 <game binary or UnrealEditor-Cmd> [maps...]" >&2
+	exit 1
+fi
+
+BINARY="$1"
+shift
+
+PROJECT_DIR="$(cd "$(dirname "$0")/.." && pwd)"
+MAPS=("$@")
+if [ ${#MAPS[@]} -eq 0 ]; then
+	MAPS=(/Game/Maps/CastleEnvironment /Game/ThirdPerson/Maps/ThirdPersonMap)
+fi
+
+PROJECT_ARGS=()
+case "$(basename "$BINARY")" in
+	UnrealEditor*) PROJECT_ARGS=("$PROJECT_DIR/Botw.uproject" -game) ;;
+esac
+
+for MAP in "${MAPS[@]}"; do
+	echo "Profiling route on $MAP"
+	"$BINARY" "${PROJECT_ARGS[@]}" "$MAP" -BotwProfileRoute -nullrhi -nosound -unattended -nosplash \
+		-fixedseed -log -stdout
+done
@@ -0,0 +1,87 @@
+#!/usr/bin/env bash
+# Starts a local dedicated server and N headless bot clients against it, then summarizes the server's load report.
+# Usage: Scripts/RunLoadTest.sh <server binary or UnrealEditor> <client binary or UnrealEditor> [players] [seconds] [map]
+# Defaults: 64 players for 300 seconds on /Game/Maps/CastleEnvironment. Logs and the per-interval CSV land in
+# Saved/LoadTest/<timestamp>.
+set -euo pipefail
+
+if [ $# -lt 2 ]; then
+	echo "Usage: $0 <server binary> <client binary> [players] [seconds] [map]" >&2
+	exit 1
+fi
+
+SERVER="$1"
+CLIENT="$2"
+PLAYERS="${3:-64}"
+SECONDS="${4:-300}"
+MAP="${5:-/Game/Maps/CastleEnvironment}"
+PORT=7777
+
+PROJECT_DIR="$(cd "$(dirname "$0")/.." && pwd)"
+OUT_DIR="$PROJECT_DIR/Saved/LoadTest/$(date +%Y%m%d_%H%M%S)"
+REPORT="$OUT_DIR/ServerLoad.csv"
+mkdir -p "$OUT_DIR"
+
+SERVER_ARGS=()
+CLIENT_ARGS=()
+case "$(basename "$SERVER")" in
+	UnrealEditor*) SERVER_ARGS=("$PROJECT_DIR/Botw.uproject" -server) ;;
+esac
+case "$(basename "$CLIENT")" in
+	UnrealEditor*) CLIENT_ARGS=("$PROJECT_DIR/Botw.uproject" -game) ;;
+esac
+
+PIDS=()
+cleanup() {
+	for PID in "${PIDS[@]}"; do
+		kill "$PID" 2>/dev/null || true
+	done
+	wait 2>/dev/null || true
+}
+trap cleanup EXIT
+
+echo "Starting server on $MAP, port $PORT"
+"$SERVER" "${SERVER_ARGS[@]}" "$MAP" -port=$PORT -unattended -nosound -log -BotwLoadReport="$REPORT" \
+	-ExecCmds="botw.Server.ReportInterval 10" > "$OUT_DIR/Server.log" 2>&1 &
+SERVER_PID=$!
+PIDS+=("$SERVER_PID")
+
+# give the server time to load the map before clients knock
+sleep 20
+
+echo "Starting $PLAYERS bot clients"
+for ((I = 0; I < PLAYERS; I++)); do
+	# clients render nothing and are capped at 30 fps, so 64 of them fit next to the server
+	"$CLIENT" "${CLIENT_ARGS[@]}" "127.0.0.1:$PORT?Bot=1" -nullrhi -nosound -unattended -nosplash -BotSeed=$I \
+		-ExecCmds="t.MaxFPS 30" > "$OUT_DIR/Client_$I.log" 2>&1 &
+	PIDS+=("$!")
+	sleep 0.5
+done
+
+echo "Running for $SECONDS seconds"
+sleep "$SECONDS"
+
+kill -INT "$SERVER_PID" 2>/dev/null || true
+cleanup
+trap - EXIT
+
+if [ ! -s "$REPORT" ]; then
+	echo "No load report written; see $OUT_DIR/Server.log" >&2
+	exit 1
+fi
+
+# Only intervals with every bot connected count towards the summary.
+awk -F, -v players="$PLAYERS" '
+	NR == 1 { next }
+	$2 >= players {
+		n++; gt += $3; if ($4 > gtmax) gtmax = $4; mb = $6; in_kbps += $7; out_kbps += $8
+		if ($9 > out_max) out_max = $9; corr += $10
+	}
+	END {
+		if (n == 0) { print "No interval had all " players " players connected"; exit 1 }
+		printf "Players:                      %d\n", players
+		printf "Server game thread:           %.2f ms mean, %.2f ms max\n", gt / n, gtmax
+		printf "Memory per player:            %.1f MB\n", mb
+		printf "Bandwidth per connection:     %.1f KB/s in, %.1f KB/s out (%.1f KB/s max out)\n", in_kbps / n, out_kbps / n, out_max
+		printf "Corrections per player/min:   %.2f\n", corr / n
+	}' "$REPORT" | tee "$OUT_DIR/Summary.txt"
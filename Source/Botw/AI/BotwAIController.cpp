@@ -0,0 +1,158 @@
+#include "BotwAIController.h"
+#include "BotwClimbPathFollowingComponent.h"
+#include "BotwNavFilter_NoClimb.h"
+#include "BotwPerceptionSubsystem.h"
+#include "../MyCharacterMovementComponent.h"
+#include "GameFramework/Character.h"
+#include "NavigationSystem.h"
+#include "NavFilters/NavigationQueryFilter.h"
+
+ABotwAIController::ABotwAIController(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<UBotwClimbPathFollowingComponent>(TEXT("PathFollowingComponent")))
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+}
+
+void ABotwAIController::BeginPlay()
+{
+	Super::BeginPlay();
+
+	TickActivation.Init(*this);
+}
+
+void ABotwAIController::OnPossess(APawn* InPawn)
+{
+	Super::OnPossess(InPawn);
+
+	const ACharacter* PossessedCharacter = Cast<ACharacter>(InPawn);
+	const bool bCanClimb = PossessedCharacter && Cast<UMyCharacterMovementComponent>(PossessedCharacter->GetCharacterMovement());
+
+	if (!bCanClimb)
+	{
+		DefaultNavigationFilterClass = UBotwNavFilter_NoClimb::StaticClass();
+	}
+
+	if (UBotwPerceptionSubsystem* Perception = GetWorld()->GetSubsystem<UBotwPerceptionSubsystem>())
+	{
+		Perception->RegisterPerceiver(this);
+	}
+}
+
+void ABotwAIController::OnUnPossess()
+{
+	if (UBotwPerceptionSubsystem* Perception = GetWorld()->GetSubsystem<UBotwPerceptionSubsystem>())
+	{
+		Perception->UnregisterPerceiver(this);
+	}
+
+	Super::OnUnPossess();
+}
+
+void ABotwAIController::PursueActor(AActor* Target)
+{
+	PursuitTarget = Target;
+	TickActivation.Add(EBotwTickReason::Pursuit);
+
+	RequestPathAsync();
+}
+
+void ABotwAIController::StopPursuit()
+{
+	PursuitTarget.Reset();
+	PendingQueryId = INVALID_NAVQUERYID;
+	TickActivation.Remove(EBotwTickReason::Pursuit);
+
+	StopMovement();
+}
+
+void ABotwAIController::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	const AActor* Target = PursuitTarget.Get();
+	if (!Target || PendingQueryId != INVALID_NAVQUERYID)
+	{
+		return;
+	}
+
+	const bool bTargetMoved = FVector::DistSquared(Target->GetActorLocation(), QueriedTargetLocation) > FMath::Square(RepathDistance);
+	const bool bLostPath = GetMoveStatus() == EPathFollowingStatus::Idle &&
+		FVector::DistSquared(Target->GetActorLocation(), GetNavAgentLocation()) > FMath::Square(PursuitAcceptanceRadius);
+
+	if (bTargetMoved || bLostPath)
+	{
+		RequestPathAsync();
+	}
+}
+
+void ABotwAIController::SetFocalPoint(FVector NewFocus, EAIFocusPriority::Type InPriority)
+{
+	Super::SetFocalPoint(NewFocus, InPriority);
+
+	TickActivation.Add(EBotwTickReason::Focus);
+}
+
+void ABotwAIController::SetFocus(AActor* NewFocus, EAIFocusPriority::Type InPriority)
+{
+	Super::SetFocus(NewFocus, InPriority);
+
+	TickActivation.Add(EBotwTickReason::Focus);
+}
+
+void ABotwAIController::ClearFocus(EAIFocusPriority::Type InPriority)
+{
+	Super::ClearFocus(InPriority);
+
+	if (!FAISystem::IsValidLocation(GetFocalPoint()))
+	{
+		TickActivation.Remove(EBotwTickReason::Focus);
+	}
+}
+
+void ABotwAIController::RequestPathAsync()
+{
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	const AActor* Target = PursuitTarget.Get();
+	if (!NavSys || !Target || !GetPawn() || PendingQueryId != INVALID_NAVQUERYID)
+	{
+		return;
+	}
+
+	const FNavAgentProperties& AgentProperties = GetNavAgentPropertiesRef();
+	const ANavigationData* NavData = NavSys->GetNavDataForProps(AgentProperties, GetNavAgentLocation());
+	if (!NavData)
+	{
+		return;
+	}
+
+	QueriedTargetLocation = Target->GetActorLocation();
+
+	const FPathFindingQuery Query(this, *NavData, GetNavAgentLocation(), QueriedTargetLocation,
+		UNavigationQueryFilter::GetQueryFilter(*NavData, this, GetDefaultNavigationFilterClass()));
+
+	PendingQueryId = NavSys->FindPathAsync(AgentProperties, Query,
+		FNavPathQueryDelegate::CreateUObject(this, &ABotwAIController::OnPathFound));
+}
+
+void ABotwAIController::OnPathFound(uint32 QueryId, ENavigationQueryResult::Type Result, FNavPathSharedPtr NewPath)
+{
+	if (QueryId != PendingQueryId)
+	{
+		return;
+	}
+
+	PendingQueryId = INVALID_NAVQUERYID;
+
+	AActor* Target = PursuitTarget.Get();
+	if (Result != ENavigationQueryResult::Success || !NewPath.IsValid() || !Target)
+	{
+		return;
+	}
+
+	FAIMoveRequest MoveRequest(Target);
+	MoveRequest.SetAcceptanceRadius(PursuitAcceptanceRadius);
+	MoveRequest.SetNavigationFilter(GetDefaultNavigationFilterClass());
+
+	GetPathFollowingComponent()->RequestMove(MoveRequest, NewPath);
+}
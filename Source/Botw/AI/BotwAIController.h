@@ -0,0 +1,65 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIController.h"
+#include "AI/Navigation/NavigationTypes.h"
+#include "../BotwTickActivation.h"
+#include "BotwAIController.generated.h"
+
+/**
+ * AI controller that chases a target over the climb links of UBotwClimbGraphSubsystem.
+ * Paths are found with async queries, a new one only when the target has moved RepathDistance;
+ * pawns that cannot climb get UBotwNavFilter_NoClimb and stay on the navmesh.
+ * The controller only ticks while it pursues a target or has a focus to turn towards.
+ * While it possesses a pawn it is a perceiver of UBotwPerceptionSubsystem.
+ */
+UCLASS()
+class BOTW_API ABotwAIController : public AAIController, public IBotwTickActivated
+{
+	GENERATED_BODY()
+
+public:
+	ABotwAIController(const FObjectInitializer& ObjectInitializer);
+
+	UFUNCTION(BlueprintCallable, Category = "AI")
+	void PursueActor(AActor* Target);
+
+	UFUNCTION(BlueprintCallable, Category = "AI")
+	void StopPursuit();
+
+	virtual void Tick(float DeltaSeconds) override;
+
+	virtual void SetFocalPoint(FVector NewFocus, EAIFocusPriority::Type InPriority = EAIFocusPriority::Gameplay) override;
+
+	virtual void SetFocus(AActor* NewFocus, EAIFocusPriority::Type InPriority = EAIFocusPriority::Gameplay) override;
+
+	virtual void ClearFocus(EAIFocusPriority::Type InPriority) override;
+
+	virtual FBotwTickActivation& GetTickActivation() override { return TickActivation; }
+
+protected:
+	virtual void BeginPlay() override;
+
+	virtual void OnPossess(APawn* InPawn) override;
+
+	virtual void OnUnPossess() override;
+
+	UPROPERTY(EditDefaultsOnly, Category = "AI")
+	float RepathDistance = 300.f;
+
+	UPROPERTY(EditDefaultsOnly, Category = "AI")
+	float PursuitAcceptanceRadius = 80.f;
+
+private:
+	void RequestPathAsync();
+
+	void OnPathFound(uint32 QueryId, ENavigationQueryResult::Type Result, FNavPathSharedPtr NewPath);
+
+	TWeakObjectPtr<AActor> PursuitTarget;
+
+	FVector QueriedTargetLocation = FVector::ZeroVector;
+
+	uint32 PendingQueryId = INVALID_NAVQUERYID;
+
+	FBotwTickActivation TickActivation;
+};
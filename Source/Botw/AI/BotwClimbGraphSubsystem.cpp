@@ -0,0 +1,490 @@
+#include "BotwClimbGraphSubsystem.h"
+#include "BotwNavArea_Climb.h"
+#include "../Botw.h"
+#include "../MyCharacterMovementComponent.h"
+#include "AI/Navigation/NavLinkDefinition.h"
+#include "AI/NavigationSystemBase.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/Level.h"
+#include "Engine/LevelBounds.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/GameModeBase.h"
+#include "HAL/IConsoleManager.h"
+#include "NavLinkComponent.h"
+#include "NavMesh/RecastNavMesh.h"
+#include "NavigationSystem.h"
+
+DECLARE_CYCLE_STAT(TEXT("Climb graph generation"), STAT_BotwClimbGraphGeneration, STATGROUP_Botw);
+
+static TAutoConsoleVariable<float> CVarClimbGraphBudgetMs(
+	TEXT("botw.ClimbGraph.BudgetMs"),
+	0.5f,
+	TEXT("Game thread milliseconds per frame spent generating climb nav links."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarClimbGraphCellSize(
+	TEXT("botw.ClimbGraph.CellSize"),
+	300.f,
+	TEXT("Spacing of the navmesh samples that look for climbable walls. Takes effect on the next rebuild."),
+	ECVF_Default);
+
+static FAutoConsoleCommandWithWorld CmdClimbGraphRebuild(
+	TEXT("botw.ClimbGraph.Rebuild"),
+	TEXT("Regenerates the climb nav links of the current world."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (UBotwClimbGraphSubsystem* ClimbGraph = World ? World->GetSubsystem<UBotwClimbGraphSubsystem>() : nullptr)
+		{
+			ClimbGraph->Rebuild();
+		}
+	}));
+
+namespace BotwClimbGraph
+{
+	/** Lower walls are left to the navmesh step height and jumping. */
+	constexpr float MinLedgeHeight = 100.f;
+
+	constexpr float MaxLedgeHeight = 3000.f;
+
+	/** How far from the foot of the wall the wall is looked for. */
+	constexpr float ApproachDistance = 150.f;
+
+	/** How far past the wall face the ledge is looked for. */
+	constexpr float LedgeDepth = 60.f;
+
+	/** Links are deduplicated on a grid of this size. */
+	constexpr float LinkSpacing = 150.f;
+
+	constexpr int32 NumDirections = 8;
+
+	constexpr int32 LinksPerCommit = 32;
+
+	/** Links that move less than this when their cell is regenerated are the same link. */
+	constexpr float SameLinkTolerance = 1.f;
+
+	static bool IsSameLink(const FNavigationLink& A, const FNavigationLink& B)
+	{
+		return A.Left.Equals(B.Left, SameLinkTolerance) && A.Right.Equals(B.Right, SameLinkTolerance);
+	}
+}
+
+bool UBotwClimbGraphSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UBotwClimbGraphSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UBotwClimbGraphSubsystem, STATGROUP_Tickables);
+}
+
+void UBotwClimbGraphSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UBotwClimbGraphSubsystem::OnLevelAddedToWorld);
+	LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject(this, &UBotwClimbGraphSubsystem::OnLevelRemovedFromWorld);
+	NavigationDirtyHandle = UNavigationSystemV1::NavigationDirtyEvent.AddUObject(this, &UBotwClimbGraphSubsystem::OnNavigationDirtied);
+}
+
+void UBotwClimbGraphSubsystem::Deinitialize()
+{
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+	UNavigationSystemV1::NavigationDirtyEvent.Remove(NavigationDirtyHandle);
+
+	Super::Deinitialize();
+}
+
+void UBotwClimbGraphSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	Rebuild();
+}
+
+void UBotwClimbGraphSubsystem::OnLevelAddedToWorld(ULevel* Level, UWorld* World)
+{
+	// Levels streamed in before BeginPlay are covered by the first build.
+	if (World == GetWorld() && World->HasBegunPlay())
+	{
+		RebuildArea(ALevelBounds::CalculateLevelBounds(Level));
+	}
+}
+
+void UBotwClimbGraphSubsystem::OnLevelRemovedFromWorld(ULevel* Level, UWorld* World)
+{
+	// A null level means the whole world is going away.
+	if (Level && World == GetWorld() && World->HasBegunPlay())
+	{
+		RebuildArea(ALevelBounds::CalculateLevelBounds(Level));
+	}
+}
+
+void UBotwClimbGraphSubsystem::OnNavigationDirtied(const FBox& DirtyBounds)
+{
+	// Committing the links dirties their own bounds; regenerating those would only commit them again.
+	const int32 CommittedIndex = CommittedAreas.IndexOfByPredicate([&DirtyBounds](const FBox& Area)
+	{
+		return Area.Min.Equals(DirtyBounds.Min, BotwClimbGraph::SameLinkTolerance) &&
+			Area.Max.Equals(DirtyBounds.Max, BotwClimbGraph::SameLinkTolerance);
+	});
+
+	if (CommittedIndex != INDEX_NONE)
+	{
+		CommittedAreas.RemoveAt(CommittedIndex);
+		return;
+	}
+
+	RebuildArea(DirtyBounds);
+}
+
+int32 UBotwClimbGraphSubsystem::GetNumLinks() const
+{
+	return LinkComponent ? LinkComponent->Links.Num() : 0;
+}
+
+bool UBotwClimbGraphSubsystem::InitClimbRules()
+{
+	const AGameModeBase* GameMode = GetWorld()->GetAuthGameMode();
+	const ACharacter* PawnDefaults = GameMode && GameMode->DefaultPawnClass
+		? Cast<ACharacter>(GameMode->DefaultPawnClass->GetDefaultObject())
+		: nullptr;
+
+	ClimbRules = PawnDefaults ? Cast<UMyCharacterMovementComponent>(PawnDefaults->GetCharacterMovement()) : nullptr;
+	if (!ClimbRules.IsValid())
+	{
+		return false;
+	}
+
+	CapsuleShape = PawnDefaults->GetCapsuleComponent()->GetCollisionShape();
+	return true;
+}
+
+void UBotwClimbGraphSubsystem::Rebuild()
+{
+	UWorld* World = GetWorld();
+	const UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(World);
+
+	// Only the server plans paths.
+	if (!NavSys || World->GetNetMode() == NM_Client)
+	{
+		return;
+	}
+
+	if (!InitClimbRules())
+	{
+		UE_LOG(LogBotw, Warning, TEXT("Climb graph not built: the default pawn does not use UMyCharacterMovementComponent"));
+		return;
+	}
+
+	if (!LinkComponent)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.ObjectFlags |= RF_Transient;
+
+		AActor* LinkActor = World->SpawnActor<AActor>(SpawnParams);
+		LinkComponent = NewObject<UNavLinkComponent>(LinkActor, TEXT("ClimbLinks"));
+		LinkComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		LinkActor->SetRootComponent(LinkComponent);
+		LinkComponent->RegisterComponent();
+	}
+
+	LinkComponent->Links.Reset();
+	LinkKeys.Reset();
+	LinkSources.Reset();
+	RemovedLinks.Reset();
+	CommittedAreas.Reset();
+	UncommittedLinks = 1;
+	CommitLinks();
+
+	const ARecastNavMesh* NavMesh = Cast<ARecastNavMesh>(NavSys->GetDefaultNavDataInstance());
+	if (NavMesh && NavMesh->GetRuntimeGenerationMode() == ERuntimeGenerationType::Static)
+	{
+		UE_LOG(LogBotw, Warning, TEXT("Climb graph: %s has static runtime generation and will ignore the climb links"),
+			*NavMesh->GetName());
+	}
+
+	const float MaxCellSize = FMath::Max(50.f, CVarClimbGraphCellSize.GetValueOnGameThread());
+
+	Bounds = NavSys->GetNavigableWorldBounds();
+	NumCells = FIntPoint(
+		FMath::Max(1, FMath::CeilToInt(Bounds.GetSize().X / MaxCellSize)),
+		FMath::Max(1, FMath::CeilToInt(Bounds.GetSize().Y / MaxCellSize)));
+
+	// The cells divide the bounds exactly, so they are rarely square.
+	CellSize = FVector2D(Bounds.GetSize().X / NumCells.X, Bounds.GetSize().Y / NumCells.Y);
+
+	DirtyCells.Init(Bounds.IsValid, NumCells.X * NumCells.Y);
+	NextCell = 0;
+
+	bBuilding = Bounds.IsValid;
+	bBuilt = false;
+}
+
+void UBotwClimbGraphSubsystem::RebuildArea(const FBox& Area)
+{
+	if (!Area.IsValid || !LinkComponent)
+	{
+		return;
+	}
+
+	// Walls up to the approach distance outside the area are found from samples inside it.
+	const FBox SampledArea = Area.ExpandBy(FVector(BotwClimbGraph::ApproachDistance, BotwClimbGraph::ApproachDistance, 0.f));
+
+	// New ground past the edge of the grid changes the navigable bounds the grid is laid over.
+	if (!Bounds.IsValid || SampledArea.Min.X < Bounds.Min.X || SampledArea.Min.Y < Bounds.Min.Y ||
+		SampledArea.Max.X > Bounds.Max.X || SampledArea.Max.Y > Bounds.Max.Y)
+	{
+		const UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+		if (NavSys && !(NavSys->GetNavigableWorldBounds() == Bounds))
+		{
+			Rebuild();
+			return;
+		}
+	}
+
+	if (!Bounds.IsValid || !SampledArea.IntersectXY(Bounds))
+	{
+		return;
+	}
+
+	const FIntPoint MinCell(
+		FMath::Clamp(FMath::FloorToInt((SampledArea.Min.X - Bounds.Min.X) / CellSize.X), 0, NumCells.X - 1),
+		FMath::Clamp(FMath::FloorToInt((SampledArea.Min.Y - Bounds.Min.Y) / CellSize.Y), 0, NumCells.Y - 1));
+	const FIntPoint MaxCell(
+		FMath::Clamp(FMath::FloorToInt((SampledArea.Max.X - Bounds.Min.X) / CellSize.X), 0, NumCells.X - 1),
+		FMath::Clamp(FMath::FloorToInt((SampledArea.Max.Y - Bounds.Min.Y) / CellSize.Y), 0, NumCells.Y - 1));
+
+	for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+	{
+		for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+		{
+			DirtyCells[Y * NumCells.X + X] = true;
+		}
+	}
+
+	// Take the old links of the cells out; the cells put back the ones they still find.
+	TArray<FNavigationLink>& Links = LinkComponent->Links;
+	for (int32 Index = Links.Num() - 1; Index >= 0; --Index)
+	{
+		const TPair<FIntVector, int32>& Source = LinkSources[Index];
+		if (DirtyCells[Source.Value])
+		{
+			LinkKeys.Remove(Source.Key);
+			RemovedLinks.Add(Source.Key, Links[Index]);
+			Links.RemoveAtSwap(Index, EAllowShrinking::No);
+			LinkSources.RemoveAtSwap(Index, EAllowShrinking::No);
+		}
+	}
+
+	NextCell = FMath::Min(NextCell, MinCell.Y * NumCells.X + MinCell.X);
+	bBuilding = true;
+}
+
+void UBotwClimbGraphSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (!bBuilding)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_BotwClimbGraphGeneration);
+
+	const double EndTime = FPlatformTime::Seconds() + CVarClimbGraphBudgetMs.GetValueOnGameThread() / 1000.0;
+
+	bool bDone = false;
+	while (FPlatformTime::Seconds() < EndTime)
+	{
+		const TConstSetBitIterator<> Cell(DirtyCells, NextCell);
+		if (!Cell)
+		{
+			bDone = true;
+			break;
+		}
+
+		NextCell = Cell.GetIndex() + 1;
+		DirtyCells[Cell.GetIndex()] = false;
+		ProcessCell(Cell.GetIndex());
+	}
+
+	if (bDone)
+	{
+		// Links that were taken out and not put back are gone.
+		UncommittedLinks += RemovedLinks.Num();
+		RemovedLinks.Reset();
+	}
+
+	// Partial commits while cells are being regenerated would take out links the cells have yet to put back.
+	if ((UncommittedLinks >= BotwClimbGraph::LinksPerCommit && RemovedLinks.IsEmpty()) || (bDone && UncommittedLinks > 0))
+	{
+		CommitLinks();
+	}
+
+	if (bDone)
+	{
+		bBuilding = false;
+		NextCell = 0;
+
+		if (!bBuilt)
+		{
+			bBuilt = true;
+			UE_LOG(LogBotw, Log, TEXT("Climb graph built: %d links from %d cells"), GetNumLinks(), NumCells.X * NumCells.Y);
+		}
+	}
+}
+
+void UBotwClimbGraphSubsystem::ProcessCell(int32 CellIndex)
+{
+	const UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	if (!NavSys || !ClimbRules.IsValid())
+	{
+		return;
+	}
+
+	const ARecastNavMesh* NavMesh = Cast<ARecastNavMesh>(NavSys->GetDefaultNavDataInstance());
+	if (!NavMesh)
+	{
+		return;
+	}
+
+	const FVector CellCenter(
+		Bounds.Min.X + (CellIndex % NumCells.X + 0.5f) * CellSize.X,
+		Bounds.Min.Y + (CellIndex / NumCells.X + 0.5f) * CellSize.Y,
+		Bounds.GetCenter().Z);
+
+	CellFloors.Reset();
+	if (!NavMesh->ProjectPointMulti(CellCenter, CellFloors, FVector(CellSize.X / 2, CellSize.Y / 2, Bounds.GetExtent().Z),
+		Bounds.Min.Z, Bounds.Max.Z))
+	{
+		return;
+	}
+
+	// Every polygon in the cell projects a point, so points closer in height than the capsule are on the same floor.
+	// The one closest to the cell center stands in for it.
+	CellFloors.Sort([](const FNavLocation& A, const FNavLocation& B) { return A.Location.Z < B.Location.Z; });
+
+	const float FloorSeparation = CapsuleShape.GetCapsuleHalfHeight() * 2;
+	for (int32 First = 0; First < CellFloors.Num();)
+	{
+		int32 Closest = First;
+		int32 Next = First + 1;
+		for (; Next < CellFloors.Num() && CellFloors[Next].Location.Z - CellFloors[First].Location.Z < FloorSeparation; ++Next)
+		{
+			if (FVector::DistSquared2D(CellFloors[Next].Location, CellCenter) < FVector::DistSquared2D(CellFloors[Closest].Location, CellCenter))
+			{
+				Closest = Next;
+			}
+		}
+
+		for (int32 Index = 0; Index < BotwClimbGraph::NumDirections; ++Index)
+		{
+			const float Angle = UE_TWO_PI * Index / BotwClimbGraph::NumDirections;
+			TryAddLink(CellIndex, CellFloors[Closest].Location, FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.f));
+		}
+
+		First = Next;
+	}
+}
+
+void UBotwClimbGraphSubsystem::TryAddLink(int32 CellIndex, const FVector& GroundLocation, const FVector& Direction)
+{
+	UWorld* World = GetWorld();
+	const UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(World);
+
+	const FCollisionQueryParams Params(SCENE_QUERY_STAT(BotwClimbGraph));
+	const float HalfHeight = CapsuleShape.GetCapsuleHalfHeight();
+
+	// A wall in front of the sample that the player could start climbing when running at it.
+	const FVector WallTraceStart = GroundLocation + FVector::UpVector * HalfHeight;
+	FHitResult WallHit;
+	if (!World->LineTraceSingleByChannel(WallHit, WallTraceStart, WallTraceStart + Direction * BotwClimbGraph::ApproachDistance,
+		ECC_Climbable, Params) || Cast<APawn>(WallHit.GetActor()))
+	{
+		return;
+	}
+
+	if (WallHit.ImpactNormal.Z >= ClimbRules->GetWalkableFloorZ() ||
+		!ClimbRules->CanStartClimbingSurface(Direction, WallHit.ImpactNormal))
+	{
+		return;
+	}
+
+	const FVector WallNormal2D = WallHit.ImpactNormal.GetSafeNormal2D();
+	const FIntVector Key(FVector(WallHit.ImpactPoint.X, WallHit.ImpactPoint.Y, GroundLocation.Z) / BotwClimbGraph::LinkSpacing);
+	if (LinkKeys.Contains(Key))
+	{
+		return;
+	}
+
+	// The first walkable surface just behind the wall face is the ledge the climb ends on.
+	const FVector LedgeProbe = WallHit.ImpactPoint - WallNormal2D * BotwClimbGraph::LedgeDepth;
+	FHitResult LedgeHit;
+	if (!World->LineTraceSingleByChannel(LedgeHit,
+		FVector(LedgeProbe.X, LedgeProbe.Y, GroundLocation.Z + BotwClimbGraph::MaxLedgeHeight),
+		FVector(LedgeProbe.X, LedgeProbe.Y, GroundLocation.Z + BotwClimbGraph::MinLedgeHeight),
+		ECC_WorldStatic, Params) || LedgeHit.bStartPenetrating)
+	{
+		return;
+	}
+
+	if (LedgeHit.ImpactNormal.Z < ClimbRules->GetWalkableFloorZ())
+	{
+		return;
+	}
+
+	// Same as the ledge-up check: the capsule has to fit on the ledge.
+	const FVector StandLocation = LedgeHit.ImpactPoint + FVector::UpVector * (HalfHeight + 2.f);
+	if (World->OverlapBlockingTestByChannel(StandLocation, FQuat::Identity, ECC_WorldStatic, CapsuleShape, Params))
+	{
+		return;
+	}
+
+	const FVector NavExtent(50.f, 50.f, HalfHeight);
+	const FVector WallFoot = FVector(WallHit.ImpactPoint.X, WallHit.ImpactPoint.Y, GroundLocation.Z) +
+		WallNormal2D * CapsuleShape.GetCapsuleRadius();
+
+	FNavLocation LinkStart;
+	FNavLocation LinkEnd;
+	if (!NavSys->ProjectPointToNavigation(WallFoot, LinkStart, NavExtent) ||
+		!NavSys->ProjectPointToNavigation(LedgeHit.ImpactPoint, LinkEnd, NavExtent))
+	{
+		return;
+	}
+
+	FNavigationLink& Link = LinkComponent->Links.Emplace_GetRef(LinkStart.Location, LinkEnd.Location);
+	Link.Direction = ENavLinkDirection::LeftToRight;
+	Link.SnapRadius = CapsuleShape.GetCapsuleRadius();
+	Link.SetAreaClass(UBotwNavArea_Climb::StaticClass());
+
+	LinkKeys.Add(Key);
+	LinkSources.Emplace(Key, CellIndex);
+
+	// Putting back the link a regenerated cell had is no change to the navmesh.
+	FNavigationLink RemovedLink;
+	if (!RemovedLinks.RemoveAndCopyValue(Key, RemovedLink) || !BotwClimbGraph::IsSameLink(RemovedLink, Link))
+	{
+		++UncommittedLinks;
+	}
+}
+
+void UBotwClimbGraphSubsystem::CommitLinks()
+{
+	UncommittedLinks = 0;
+
+	const FBox OldBounds = LinkComponent->Bounds.GetBox();
+	LinkComponent->UpdateBounds();
+	FNavigationSystem::UpdateComponentData(*LinkComponent);
+
+	// The update dirties the navigation where the links were and where they are now. The navigation system reports
+	// that within a frame or two, so the areas of the last two commits are enough.
+	if (CommittedAreas.Num() >= 4)
+	{
+		CommittedAreas.RemoveAt(0, 2);
+	}
+	CommittedAreas.Add(OldBounds);
+	CommittedAreas.Add(LinkComponent->Bounds.GetBox());
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AI/Navigation/NavLinkDefinition.h"
+#include "AI/Navigation/NavigationTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "BotwClimbGraphSubsystem.generated.h"
+
+class ULevel;
+class UMyCharacterMovementComponent;
+class UNavLinkComponent;
+
+/**
+ * Turns climbable walls next to the navmesh into one-way nav links from the foot of the wall to the ledge on top,
+ * using the same rules the player climbs by: the wall must be startable per UMyCharacterMovementComponent, and the
+ * ledge walkable with room for the capsule. Links live in the UBotwNavArea_Climb area so regular path queries,
+ * including async ones, route over walls without any probing at runtime.
+ * Generation walks the navigable bounds in cells, a small time budget per frame; see botw.ClimbGraph.BudgetMs.
+ * Every floor the navmesh has in a cell is sampled, so stacked ground gets its own links. Levels streaming in or out
+ * and navigation changes only regenerate the cells they touch.
+ * Needs a navmesh with RuntimeGeneration of at least DynamicModifiersOnly, or the links are never added to it.
+ */
+UCLASS()
+class BOTW_API UBotwClimbGraphSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	/** Throws away the links and generates them again, e.g. after streaming in a level. */
+	void Rebuild();
+
+	/** Regenerates the links of the cells overlapping Area. */
+	void RebuildArea(const FBox& Area);
+
+	bool IsBuilt() const { return bBuilt; }
+
+	int32 GetNumLinks() const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	bool InitClimbRules();
+
+	void OnLevelAddedToWorld(ULevel* Level, UWorld* World);
+
+	void OnLevelRemovedFromWorld(ULevel* Level, UWorld* World);
+
+	void OnNavigationDirtied(const FBox& DirtyBounds);
+
+	void ProcessCell(int32 CellIndex);
+
+	void TryAddLink(int32 CellIndex, const FVector& GroundLocation, const FVector& Direction);
+
+	void CommitLinks();
+
+	UPROPERTY(Transient)
+	TObjectPtr<UNavLinkComponent> LinkComponent;
+
+	/** Movement defaults of the player pawn, the source of the climb rules. */
+	TWeakObjectPtr<const UMyCharacterMovementComponent> ClimbRules;
+
+	FCollisionShape CapsuleShape;
+
+	FBox Bounds;
+
+	FIntPoint NumCells = FIntPoint::ZeroValue;
+
+	FVector2D CellSize = FVector2D::ZeroVector;
+
+	/** Cells still to generate. */
+	TBitArray<> DirtyCells;
+
+	int32 NextCell = 0;
+
+	int32 UncommittedLinks = 0;
+
+	/** Quantized foot locations of the links, so neighbouring cells do not add the same link twice. */
+	TSet<FIntVector> LinkKeys;
+
+	/** Key and cell of each link in LinkComponent, so regenerating a cell replaces its links. */
+	TArray<TPair<FIntVector, int32>> LinkSources;
+
+	/** Links taken out of regenerated cells, by key, until the cells put them back or turn out to have lost them. */
+	TMap<FIntVector, FNavigationLink> RemovedLinks;
+
+	/** Bounds the last commits dirtied the navigation in, which are not changes to the walls. */
+	TArray<FBox, TInlineAllocator<4>> CommittedAreas;
+
+	/** Floors found in a cell, kept to avoid allocating per cell. */
+	TArray<FNavLocation> CellFloors;
+
+	FDelegateHandle LevelAddedHandle;
+
+	FDelegateHandle LevelRemovedHandle;
+
+	FDelegateHandle NavigationDirtyHandle;
+
+	bool bBuilding = false;
+
+	bool bBuilt = false;
+};
@@ -0,0 +1,62 @@
+#include "BotwClimbPathFollowingComponent.h"
+#include "BotwNavArea_Climb.h"
+#include "../MyCharacterMovementComponent.h"
+#include "AIController.h"
+#include "GameFramework/Character.h"
+#include "NavMesh/RecastNavMesh.h"
+#include "NavigationData.h"
+
+ACharacter* UBotwClimbPathFollowingComponent::GetCharacter() const
+{
+	const AController* Controller = Cast<AController>(GetOwner());
+	return Controller ? Cast<ACharacter>(Controller->GetPawn()) : nullptr;
+}
+
+bool UBotwClimbPathFollowingComponent::IsClimbLinkSegment(int32 SegmentStartIndex) const
+{
+	const ANavigationData* NavData = Path.IsValid() ? Path->GetNavigationDataUsed() : nullptr;
+	if (!NavData || !Path->GetPathPoints().IsValidIndex(SegmentStartIndex))
+	{
+		return false;
+	}
+
+	const FNavMeshNodeFlags Flags(Path->GetPathPoints()[SegmentStartIndex].Flags);
+	return Flags.IsNavLink() && Flags.Area == NavData->GetAreaID(UBotwNavArea_Climb::StaticClass());
+}
+
+void UBotwClimbPathFollowingComponent::SetMoveSegment(int32 SegmentStartIndex)
+{
+	Super::SetMoveSegment(SegmentStartIndex);
+
+	bOnClimbLink = IsClimbLinkSegment(SegmentStartIndex);
+}
+
+void UBotwClimbPathFollowingComponent::FollowPathSegment(float DeltaTime)
+{
+	ACharacter* Character = bOnClimbLink ? GetCharacter() : nullptr;
+	UMyCharacterMovementComponent* MovementComponent = Character
+		? Cast<UMyCharacterMovementComponent>(Character->GetCharacterMovement())
+		: nullptr;
+
+	if (!MovementComponent)
+	{
+		Super::FollowPathSegment(DeltaTime);
+		return;
+	}
+
+	const FVector ToLedge = GetCurrentTargetLocation() - Character->GetActorLocation();
+
+	if (!MovementComponent->IsClimbing())
+	{
+		// Walk into the wall facing it; the link was generated from a spot where climbing can start.
+		Character->SetActorRotation(ToLedge.GetSafeNormal2D().Rotation());
+		Super::FollowPathSegment(DeltaTime);
+
+		MovementComponent->TryClimbing();
+		return;
+	}
+
+	// Up the wall the ledge is mostly straight above; steer along the surface like the player input does.
+	const FVector AlongWall = FVector::VectorPlaneProject(ToLedge, MovementComponent->GetClimbSurfaceNormal());
+	Character->AddMovementInput(AlongWall.GetSafeNormal());
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Navigation/PathFollowingComponent.h"
+#include "BotwClimbPathFollowingComponent.generated.h"
+
+class ACharacter;
+class UMyCharacterMovementComponent;
+
+/**
+ * Path following that climbs the UBotwNavArea_Climb links: at the foot of the wall it turns to face it and starts
+ * climbing, then steers along the wall towards the ledge. Everything else is regular navmesh path following.
+ */
+UCLASS()
+class BOTW_API UBotwClimbPathFollowingComponent : public UPathFollowingComponent
+{
+	GENERATED_BODY()
+
+protected:
+	virtual void SetMoveSegment(int32 SegmentStartIndex) override;
+
+	virtual void FollowPathSegment(float DeltaTime) override;
+
+private:
+	bool IsClimbLinkSegment(int32 SegmentStartIndex) const;
+
+	ACharacter* GetCharacter() const;
+
+	bool bOnClimbLink = false;
+};
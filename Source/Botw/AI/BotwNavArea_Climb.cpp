@@ -0,0 +1,9 @@
+#include "BotwNavArea_Climb.h"
+
+UBotwNavArea_Climb::UBotwNavArea_Climb(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	// Climbing is a lot slower than running, prefer stairs and ramps when they are not much longer.
+	DefaultCost = 4.f;
+	DrawColor = FColor(255, 140, 0);
+}
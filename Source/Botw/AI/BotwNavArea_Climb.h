@@ -0,0 +1,15 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NavAreas/NavArea.h"
+#include "BotwNavArea_Climb.generated.h"
+
+/** Nav links up climbable walls, generated by UBotwClimbGraphSubsystem. Only characters that can climb should use it. */
+UCLASS()
+class BOTW_API UBotwNavArea_Climb : public UNavArea
+{
+	GENERATED_BODY()
+
+public:
+	UBotwNavArea_Climb(const FObjectInitializer& ObjectInitializer);
+};
@@ -0,0 +1,10 @@
+#include "BotwNavFilter_NoClimb.h"
+#include "BotwNavArea_Climb.h"
+
+UBotwNavFilter_NoClimb::UBotwNavFilter_NoClimb(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	FNavigationFilterArea& ClimbArea = Areas.AddDefaulted_GetRef();
+	ClimbArea.AreaClass = UBotwNavArea_Climb::StaticClass();
+	ClimbArea.bIsExcluded = true;
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NavFilters/NavigationQueryFilter.h"
+#include "BotwNavFilter_NoClimb.generated.h"
+
+/** Keeps pawns that cannot climb off the climb links. */
+UCLASS()
+class BOTW_API UBotwNavFilter_NoClimb : public UNavigationQueryFilter
+{
+	GENERATED_BODY()
+
+public:
+	UBotwNavFilter_NoClimb(const FObjectInitializer& ObjectInitializer);
+};
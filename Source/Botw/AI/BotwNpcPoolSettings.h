@@ -0,0 +1,24 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DeveloperSettings.h"
+#include "BotwNpcPoolSettings.generated.h"
+
+/** What UBotwNpcPoolSubsystem spawns ahead of time. */
+UCLASS(config = Game, defaultconfig, meta = (DisplayName = "Botw NPC Pool"))
+class BOTW_API UBotwNpcPoolSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(config, EditAnywhere, Category = "Pool")
+	TSoftClassPtr<AActor> NpcClass = TSoftClassPtr<AActor>(FSoftObjectPath(TEXT("/Game/Characters/NPC/test_ai.test_ai_C")));
+
+	/** Instances spawned while the map loads. */
+	UPROPERTY(config, EditAnywhere, Category = "Pool", meta = (ClampMin = "0", ClampMax = "256"))
+	int32 PrewarmCount = 8;
+
+	/** Spawn a new instance when the pool runs dry instead of failing the acquire. Such spawns hitch and are counted. */
+	UPROPERTY(config, EditAnywhere, Category = "Pool")
+	bool bGrowOnDemand = true;
+};
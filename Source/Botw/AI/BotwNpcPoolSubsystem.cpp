@@ -0,0 +1,257 @@
+#include "BotwNpcPoolSubsystem.h"
+#include "BotwNpcPoolSettings.h"
+#include "../Botw.h"
+#include "../BotwTickActivation.h"
+#include "AIController.h"
+#include "BrainComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("NPC pool prewarm"), STAT_BotwNpcPoolPrewarm, STATGROUP_Botw);
+DECLARE_CYCLE_STAT(TEXT("NPC spawn"), STAT_BotwNpcSpawn, STATGROUP_Botw);
+DECLARE_CYCLE_STAT(TEXT("NPC acquire"), STAT_BotwNpcAcquire, STATGROUP_Botw);
+DECLARE_CYCLE_STAT(TEXT("NPC release"), STAT_BotwNpcRelease, STATGROUP_Botw);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled NPCs free"), STAT_BotwNpcPoolFree, STATGROUP_Botw);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled NPCs active"), STAT_BotwNpcPoolActive, STATGROUP_Botw);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("NPC spawns on demand"), STAT_BotwNpcPoolGrowSpawns, STATGROUP_Botw);
+
+static FAutoConsoleCommandWithWorldAndArgs CmdNpcPoolAcquire(
+	TEXT("botw.NpcPool.Acquire"),
+	TEXT("botw.NpcPool.Acquire <Count>: places pooled NPCs in a ring around the first player."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UBotwNpcPoolSubsystem* Pool = World ? World->GetSubsystem<UBotwNpcPoolSubsystem>() : nullptr;
+		const APlayerController* Player = World ? World->GetFirstPlayerController() : nullptr;
+		if (!Pool || !Player || !Player->GetPawn())
+		{
+			return;
+		}
+
+		const int32 Count = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 1;
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			const FVector Offset = FRotator(0.f, 360.f * Index / Count, 0.f).Vector() * 400.f;
+			Pool->AcquireNpc(FTransform(Player->GetPawn()->GetActorLocation() + Offset));
+		}
+	}));
+
+namespace BotwNpcPool
+{
+	/** Where free NPCs wait, out of sight. They do not tick, so they cannot fall out of the world. */
+	static const FVector ParkingLocation(0.f, 0.f, -50000.f);
+
+	static AAIController* GetAIController(const AActor* Npc)
+	{
+		const APawn* Pawn = Cast<APawn>(Npc);
+		return Pawn ? Cast<AAIController>(Pawn->GetController()) : nullptr;
+	}
+}
+
+bool UBotwNpcPoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UBotwNpcPoolSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// NPCs are replicated from the server.
+	if (InWorld.GetNetMode() == NM_Client)
+	{
+		return;
+	}
+
+	const UBotwNpcPoolSettings* Settings = GetDefault<UBotwNpcPoolSettings>();
+
+	NpcClass = Settings->NpcClass.LoadSynchronous();
+	if (!NpcClass)
+	{
+		UE_LOG(LogBotw, Warning, TEXT("NPC pool disabled: could not load %s"), *Settings->NpcClass.ToString());
+		return;
+	}
+
+	if (const ACharacter* Defaults = Cast<ACharacter>(NpcClass->GetDefaultObject()))
+	{
+		MeshRelativeTransform = Defaults->GetMesh()->GetRelativeTransform();
+		MeshLinearDamping = Defaults->GetMesh()->GetLinearDamping();
+		MeshAngularDamping = Defaults->GetMesh()->GetAngularDamping();
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_BotwNpcPoolPrewarm);
+
+	for (int32 Index = 0; Index < Settings->PrewarmCount; ++Index)
+	{
+		if (AActor* Npc = SpawnPooledNpc())
+		{
+			Deactivate(Npc);
+			FreeNpcs.Add(Npc);
+		}
+	}
+
+	SET_DWORD_STAT(STAT_BotwNpcPoolFree, FreeNpcs.Num());
+}
+
+void UBotwNpcPoolSubsystem::Deinitialize()
+{
+	FreeNpcs.Reset();
+	ActiveNpcs.Reset();
+
+	SET_DWORD_STAT(STAT_BotwNpcPoolFree, 0);
+	SET_DWORD_STAT(STAT_BotwNpcPoolActive, 0);
+
+	Super::Deinitialize();
+}
+
+AActor* UBotwNpcPoolSubsystem::SpawnPooledNpc()
+{
+	SCOPE_CYCLE_COUNTER(STAT_BotwNpcSpawn);
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	AActor* Npc = GetWorld()->SpawnActor<AActor>(NpcClass, FTransform(BotwNpcPool::ParkingLocation), SpawnParams);
+
+	// Spawned actors only get their AI controller automatically when AutoPossessAI allows it; pooled ones always need one.
+	APawn* Pawn = Cast<APawn>(Npc);
+	if (Pawn && !Pawn->GetController())
+	{
+		Pawn->SpawnDefaultController();
+	}
+
+	return Npc;
+}
+
+AActor* UBotwNpcPoolSubsystem::AcquireNpc(const FTransform& Transform)
+{
+	SCOPE_CYCLE_COUNTER(STAT_BotwNpcAcquire);
+
+	if (!NpcClass)
+	{
+		return nullptr;
+	}
+
+	AActor* Npc = nullptr;
+	while (!Npc && !FreeNpcs.IsEmpty())
+	{
+		Npc = FreeNpcs.Pop(EAllowShrinking::No);
+		Npc = IsValid(Npc) ? Npc : nullptr;
+	}
+
+	if (!Npc)
+	{
+		if (!GetDefault<UBotwNpcPoolSettings>()->bGrowOnDemand)
+		{
+			return nullptr;
+		}
+
+		Npc = SpawnPooledNpc();
+		if (!Npc)
+		{
+			return nullptr;
+		}
+
+		INC_DWORD_STAT(STAT_BotwNpcPoolGrowSpawns);
+		UE_LOG(LogBotw, Verbose, TEXT("NPC pool ran dry, spawned %s on demand"), *Npc->GetName());
+	}
+
+	Activate(Npc, Transform);
+	ActiveNpcs.Add(Npc);
+
+	SET_DWORD_STAT(STAT_BotwNpcPoolFree, FreeNpcs.Num());
+	SET_DWORD_STAT(STAT_BotwNpcPoolActive, ActiveNpcs.Num());
+
+	return Npc;
+}
+
+void UBotwNpcPoolSubsystem::ReleaseNpc(AActor* Npc)
+{
+	SCOPE_CYCLE_COUNTER(STAT_BotwNpcRelease);
+
+	if (!IsValid(Npc) || ActiveNpcs.Remove(Npc) == 0)
+	{
+		return;
+	}
+
+	Deactivate(Npc);
+	FreeNpcs.Add(Npc);
+
+	SET_DWORD_STAT(STAT_BotwNpcPoolFree, FreeNpcs.Num());
+	SET_DWORD_STAT(STAT_BotwNpcPoolActive, ActiveNpcs.Num());
+}
+
+void UBotwNpcPoolSubsystem::Deactivate(AActor* Npc)
+{
+	if (ACharacter* Character = Cast<ACharacter>(Npc))
+	{
+		// Undo the ragdoll from ABotwCharacter::CheckOverlapDuringPunch and put the mesh back on the capsule.
+		USkeletalMeshComponent* Mesh = Character->GetMesh();
+		if (Mesh->IsSimulatingPhysics())
+		{
+			Mesh->SetSimulatePhysics(false);
+			Mesh->AttachToComponent(Character->GetCapsuleComponent(), FAttachmentTransformRules::KeepRelativeTransform);
+			Mesh->SetRelativeTransform(MeshRelativeTransform, false, nullptr, ETeleportType::ResetPhysics);
+		}
+
+		Mesh->SetLinearDamping(MeshLinearDamping);
+		Mesh->SetAngularDamping(MeshAngularDamping);
+		Mesh->SetComponentTickEnabled(false);
+
+		if (UAnimInstance* AnimInstance = Mesh->GetAnimInstance())
+		{
+			AnimInstance->StopAllMontages(0.f);
+		}
+
+		UCharacterMovementComponent* Movement = Character->GetCharacterMovement();
+		Movement->StopMovementImmediately();
+		Movement->DisableMovement();
+		Movement->SetComponentTickEnabled(false);
+	}
+
+	if (AAIController* AIController = BotwNpcPool::GetAIController(Npc))
+	{
+		AIController->StopMovement();
+		if (AIController->BrainComponent)
+		{
+			AIController->BrainComponent->StopLogic(TEXT("Pooled"));
+		}
+
+		AIController->SetActorTickEnabled(false);
+	}
+
+	Npc->SetActorHiddenInGame(true);
+	Npc->SetActorEnableCollision(false);
+	Npc->SetActorTickEnabled(false);
+	Npc->SetActorLocation(BotwNpcPool::ParkingLocation, false, nullptr, ETeleportType::ResetPhysics);
+}
+
+void UBotwNpcPoolSubsystem::Activate(AActor* Npc, const FTransform& Transform)
+{
+	Npc->SetActorLocationAndRotation(Transform.GetLocation(), Transform.GetRotation(), false, nullptr, ETeleportType::ResetPhysics);
+	Npc->SetActorHiddenInGame(false);
+	Npc->SetActorEnableCollision(true);
+	BotwTickActivation::RestoreActorTick(Npc);
+
+	if (ACharacter* Character = Cast<ACharacter>(Npc))
+	{
+		Character->GetMesh()->SetComponentTickEnabled(true);
+
+		UCharacterMovementComponent* Movement = Character->GetCharacterMovement();
+		Movement->SetComponentTickEnabled(true);
+		Movement->SetDefaultMovementMode();
+	}
+
+	if (AAIController* AIController = BotwNpcPool::GetAIController(Npc))
+	{
+		BotwTickActivation::RestoreActorTick(AIController);
+		if (AIController->BrainComponent)
+		{
+			AIController->BrainComponent->RestartLogic();
+		}
+	}
+}
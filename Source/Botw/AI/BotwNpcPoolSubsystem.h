@@ -0,0 +1,59 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "BotwNpcPoolSubsystem.generated.h"
+
+/**
+ * Keeps NPC instances spawned ahead of time, so encounters do not pay for actor construction, component
+ * registration, anim instance creation and physics setup in the middle of combat.
+ * Released NPCs are parked hidden, without collision or ticking, and their ragdoll is undone.
+ */
+UCLASS()
+class BOTW_API UBotwNpcPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	virtual void Deinitialize() override;
+
+	/** Places a pooled NPC at Transform and wakes it up. Null when the pool is empty and may not grow. */
+	UFUNCTION(BlueprintCallable, Category = "NPC Pool")
+	AActor* AcquireNpc(const FTransform& Transform);
+
+	/** Puts an NPC from AcquireNpc back into the pool. */
+	UFUNCTION(BlueprintCallable, Category = "NPC Pool")
+	void ReleaseNpc(AActor* Npc);
+
+	int32 GetNumFree() const { return FreeNpcs.Num(); }
+
+	int32 GetNumActive() const { return ActiveNpcs.Num(); }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	AActor* SpawnPooledNpc();
+
+	void Deactivate(AActor* Npc);
+
+	void Activate(AActor* Npc, const FTransform& Transform);
+
+	UPROPERTY(Transient)
+	TSubclassOf<AActor> NpcClass;
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<AActor>> FreeNpcs;
+
+	UPROPERTY(Transient)
+	TSet<TObjectPtr<AActor>> ActiveNpcs;
+
+	/** Mesh placement on the capsule, to put it back after a ragdoll. */
+	FTransform MeshRelativeTransform;
+
+	float MeshLinearDamping = 0.f;
+
+	float MeshAngularDamping = 0.f;
+};
@@ -0,0 +1,329 @@
+#include "BotwPerceptionSubsystem.h"
+#include "../Botw.h"
+#include "../BotwCharacter.h"
+#include "../MyCharacterMovementComponent.h"
+#include "../Events/BotwEventBusSubsystem.h"
+#include "AIController.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Perception update"), STAT_BotwPerceptionUpdate, STATGROUP_Botw);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Perceivers"), STAT_BotwPerceivers, STATGROUP_Botw);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Perception traces"), STAT_BotwPerceptionTraces, STATGROUP_Botw);
+
+static TAutoConsoleVariable<int32> CVarPerceptionTracesPerFrame(
+	TEXT("botw.Perception.TracesPerFrame"),
+	8,
+	TEXT("Line-of-sight traces the AI perception issues per frame, however many NPCs there are."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarPerceptionSightRadius(
+	TEXT("botw.Perception.SightRadius"),
+	3000.f,
+	TEXT("How far AI controllers can see."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarPerceptionStimulusSeconds(
+	TEXT("botw.Perception.StimulusSeconds"),
+	3.f,
+	TEXT("How long climbing and punching events keep drawing AI attention to their instigator."),
+	ECVF_Default);
+
+namespace BotwPerception
+{
+	/** Cosine of the half angle of the view cone; stimuli are noticed from any direction. */
+	constexpr float ViewConeCos = 0.34f; // ~70 degrees
+
+	/** How much more a perceiver wants to look at a target that is climbing, punching or just made noise. */
+	constexpr float StimulusWeight = 4.f;
+
+	/** Keeps far targets from starving entirely. */
+	constexpr float MinDistanceWeight = 0.1f;
+
+	static bool IsStimulusEvent(EBotwGameplayEventType Type)
+	{
+		switch (Type)
+		{
+		case EBotwGameplayEventType::ClimbStart:
+		case EBotwGameplayEventType::ClimbDash:
+		case EBotwGameplayEventType::LedgeUp:
+		case EBotwGameplayEventType::AttackStarted:
+		case EBotwGameplayEventType::PunchHit:
+			return true;
+		default:
+			return false;
+		}
+	}
+}
+
+bool UBotwPerceptionSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UBotwPerceptionSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UBotwPerceptionSubsystem, STATGROUP_Tickables);
+}
+
+void UBotwPerceptionSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (UBotwEventBusSubsystem* EventBus = Collection.InitializeDependency<UBotwEventBusSubsystem>())
+	{
+		EventBus->OnEvents.AddUObject(this, &UBotwPerceptionSubsystem::OnGameplayEvents);
+	}
+}
+
+void UBotwPerceptionSubsystem::Deinitialize()
+{
+	Perceivers.Empty();
+	StimulusTimes.Empty();
+
+	SET_DWORD_STAT(STAT_BotwPerceivers, 0);
+
+	Super::Deinitialize();
+}
+
+void UBotwPerceptionSubsystem::RegisterPerceiver(AAIController* Controller)
+{
+	if (!Controller || Perceivers.ContainsByPredicate([Controller](const FPerceiver& Perceiver) { return Perceiver.Controller == Controller; }))
+	{
+		return;
+	}
+
+	FPerceiver& Perceiver = Perceivers.AddDefaulted_GetRef();
+	Perceiver.Controller = Controller;
+
+	SET_DWORD_STAT(STAT_BotwPerceivers, Perceivers.Num());
+}
+
+void UBotwPerceptionSubsystem::UnregisterPerceiver(AAIController* Controller)
+{
+	Perceivers.RemoveAllSwap([Controller](const FPerceiver& Perceiver) { return Perceiver.Controller == Controller; }, EAllowShrinking::No);
+
+	SET_DWORD_STAT(STAT_BotwPerceivers, Perceivers.Num());
+}
+
+AActor* UBotwPerceptionSubsystem::GetPerceivedTarget(const AAIController* Controller, FVector& OutLastSeenLocation) const
+{
+	const FPerceiver* Perceiver = Perceivers.FindByPredicate([Controller](const FPerceiver& Entry) { return Entry.Controller == Controller; });
+	if (!Perceiver || !Perceiver->bSeen)
+	{
+		return nullptr;
+	}
+
+	OutLastSeenLocation = Perceiver->LastSeenLocation;
+	return Perceiver->Target.Get();
+}
+
+void UBotwPerceptionSubsystem::OnGameplayEvents(TConstArrayView<FBotwGameplayEvent> Events)
+{
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	for (const FBotwGameplayEvent& Event : Events)
+	{
+		if (BotwPerception::IsStimulusEvent(Event.Type) && Event.Instigator.IsValid())
+		{
+			StimulusTimes.Add(Event.Instigator, Now);
+		}
+	}
+}
+
+void UBotwPerceptionSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// NPCs think on the server only.
+	if (GetWorld()->GetNetMode() == NM_Client || Perceivers.IsEmpty())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_BotwPerceptionUpdate);
+
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	TArray<FTarget, TInlineAllocator<8>> Targets;
+	GatherTargets(Now, Targets);
+
+	// The perceivers that need a trace most, paired with the target they look at, most urgent first.
+	const int32 MaxTraces = FMath::Max(0, CVarPerceptionTracesPerFrame.GetValueOnGameThread());
+	TArray<TPair<int32, const FTarget*>, TInlineAllocator<32>> Selected;
+
+	Perceivers.RemoveAllSwap([](const FPerceiver& Perceiver) { return !Perceiver.Controller.IsValid(); }, EAllowShrinking::No);
+
+	for (int32 Index = 0; Index < Perceivers.Num(); ++Index)
+	{
+		FPerceiver& Perceiver = Perceivers[Index];
+
+		// Pooled NPCs wait hidden and do not look around.
+		const APawn* Pawn = Perceiver.Controller->GetPawn();
+		if (!Pawn || Pawn->IsHidden())
+		{
+			SetSeen(Perceiver, nullptr, false);
+			continue;
+		}
+
+		const FTarget* Target = nullptr;
+		const float Score = ChooseTarget(Perceiver, Targets, Target);
+		if (!Target)
+		{
+			SetSeen(Perceiver, nullptr, false);
+			Perceiver.LastCheckTime = Now;
+			continue;
+		}
+
+		Perceiver.Urgency = float(Now - Perceiver.LastCheckTime) * Score;
+
+		// Insertion into a short sorted list; MaxTraces is small, so this stays linear in the number of perceivers.
+		int32 Position = Selected.Num();
+		while (Position > 0 && Perceivers[Selected[Position - 1].Key].Urgency < Perceiver.Urgency)
+		{
+			--Position;
+		}
+
+		if (Position < MaxTraces)
+		{
+			Selected.Insert(TPair<int32, const FTarget*>(Index, Target), Position);
+			if (Selected.Num() > MaxTraces)
+			{
+				Selected.Pop(EAllowShrinking::No);
+			}
+		}
+	}
+
+	for (const TPair<int32, const FTarget*>& Entry : Selected)
+	{
+		CheckLineOfSight(Perceivers[Entry.Key], *Entry.Value, Now);
+	}
+
+	SET_DWORD_STAT(STAT_BotwPerceivers, Perceivers.Num());
+}
+
+void UBotwPerceptionSubsystem::GatherTargets(double Now, TArray<FTarget, TInlineAllocator<8>>& OutTargets)
+{
+	const double StimulusSeconds = CVarPerceptionStimulusSeconds.GetValueOnGameThread();
+
+	for (auto It = StimulusTimes.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().IsValid() || Now - It.Value() > StimulusSeconds)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		APawn* Pawn = It->IsValid() ? (*It)->GetPawn() : nullptr;
+		if (!Pawn)
+		{
+			continue;
+		}
+
+		FTarget& Target = OutTargets.AddDefaulted_GetRef();
+		Target.Actor = Pawn;
+		Target.EyeLocation = Pawn->GetPawnViewLocation();
+		Target.bStimulus = StimulusTimes.Contains(Pawn);
+
+		// Climbing and punching are visible activity even between events.
+		if (const ABotwCharacter* Character = Cast<ABotwCharacter>(Pawn))
+		{
+			const UMyCharacterMovementComponent* Movement = Character->GetCustomCharacterMovement();
+			Target.bStimulus |= Character->bIsPunching || (Movement && Movement->IsClimbing());
+		}
+	}
+}
+
+float UBotwPerceptionSubsystem::ChooseTarget(FPerceiver& Perceiver, TConstArrayView<FTarget> Targets, const FTarget*& OutTarget) const
+{
+	const APawn* Pawn = Perceiver.Controller->GetPawn();
+	const FVector EyeLocation = Pawn->GetPawnViewLocation();
+	const FVector Forward = Pawn->GetActorForwardVector();
+	const float SightRadius = CVarPerceptionSightRadius.GetValueOnGameThread();
+
+	float BestScore = 0.f;
+	OutTarget = nullptr;
+
+	for (const FTarget& Target : Targets)
+	{
+		if (Target.Actor == Pawn)
+		{
+			continue;
+		}
+
+		const FVector ToTarget = Target.EyeLocation - EyeLocation;
+		const float Distance = ToTarget.Size();
+		if (Distance > SightRadius)
+		{
+			continue;
+		}
+
+		const bool bInViewCone = FVector::DotProduct(ToTarget, Forward) >= BotwPerception::ViewConeCos * Distance;
+		if (!bInViewCone && !Target.bStimulus)
+		{
+			continue;
+		}
+
+		float Score = FMath::Max(1.f - Distance / SightRadius, BotwPerception::MinDistanceWeight);
+		Score *= Target.bStimulus ? BotwPerception::StimulusWeight : 1.f;
+
+		// Whoever is already being watched stays the favourite, so targets do not flicker between close players.
+		Score *= Target.Actor == Perceiver.Target.Get() && Perceiver.bSeen ? 2.f : 1.f;
+
+		if (Score > BestScore)
+		{
+			BestScore = Score;
+			OutTarget = &Target;
+		}
+	}
+
+	return BestScore;
+}
+
+void UBotwPerceptionSubsystem::CheckLineOfSight(FPerceiver& Perceiver, const FTarget& Target, double Now)
+{
+	const APawn* Pawn = Perceiver.Controller->GetPawn();
+
+	FCollisionQueryParams Params(SCENE_QUERY_STAT(BotwPerception));
+	Params.AddIgnoredActor(Pawn);
+	Params.AddIgnoredActor(Target.Actor);
+
+	INC_DWORD_STAT(STAT_BotwPerceptionTraces);
+
+	FHitResult Hit;
+	const bool bBlocked = GetWorld()->LineTraceSingleByChannel(Hit, Pawn->GetPawnViewLocation(), Target.EyeLocation, ECC_Visibility, Params);
+
+	Perceiver.LastCheckTime = Now;
+	if (!bBlocked)
+	{
+		Perceiver.LastSeenLocation = Target.Actor->GetActorLocation();
+	}
+
+	SetSeen(Perceiver, Target.Actor, !bBlocked);
+}
+
+void UBotwPerceptionSubsystem::SetSeen(FPerceiver& Perceiver, AActor* Target, bool bSeen)
+{
+	AActor* OldTarget = Perceiver.Target.Get();
+	const bool bWasSeen = Perceiver.bSeen && OldTarget;
+
+	if (bSeen)
+	{
+		Perceiver.Target = Target;
+	}
+
+	Perceiver.bSeen = bSeen;
+
+	if (bWasSeen && (!bSeen || OldTarget != Target))
+	{
+		OnPerceptionChanged.Broadcast(Perceiver.Controller.Get(), OldTarget, false);
+	}
+
+	if (bSeen && (!bWasSeen || OldTarget != Target))
+	{
+		OnPerceptionChanged.Broadcast(Perceiver.Controller.Get(), Target, true);
+	}
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "BotwPerceptionSubsystem.generated.h"
+
+class AAIController;
+struct FBotwGameplayEvent;
+
+/** Called when a perceiver starts or stops seeing its target. */
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FBotwPerceptionChanged, AAIController* /*Controller*/, AActor* /*Target*/, bool /*bSeen*/);
+
+/**
+ * Sight for AI controllers at a constant trace cost. Every frame each perceiver cheaply picks the player pawn it
+ * should look at, by distance, view cone and stimuli; climbing, climb dashes, ledge-ups and punches count as stimuli
+ * without any trace, through the pawn's state and the event bus. Only the botw.Perception.TracesPerFrame perceivers
+ * that waited longest, weighted by that score, get a line-of-sight trace; the others keep their last result.
+ * Runs on the server; ABotwAIController registers itself, other controllers can call RegisterPerceiver.
+ */
+UCLASS()
+class BOTW_API UBotwPerceptionSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	UFUNCTION(BlueprintCallable, Category = "AI|Perception")
+	void RegisterPerceiver(AAIController* Controller);
+
+	UFUNCTION(BlueprintCallable, Category = "AI|Perception")
+	void UnregisterPerceiver(AAIController* Controller);
+
+	/** The target the controller saw on its last check, if it still sees it, and where it was last seen. */
+	UFUNCTION(BlueprintCallable, Category = "AI|Perception")
+	AActor* GetPerceivedTarget(const AAIController* Controller, FVector& OutLastSeenLocation) const;
+
+	FBotwPerceptionChanged OnPerceptionChanged;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FPerceiver
+	{
+		TWeakObjectPtr<AAIController> Controller;
+
+		TWeakObjectPtr<AActor> Target;
+
+		FVector LastSeenLocation = FVector::ZeroVector;
+
+		double LastCheckTime = 0.0;
+
+		/** Scratch for the current frame: how much the perceiver needs a trace. */
+		float Urgency = 0.f;
+
+		bool bSeen = false;
+	};
+
+	struct FTarget
+	{
+		AActor* Actor = nullptr;
+
+		FVector EyeLocation = FVector::ZeroVector;
+
+		bool bStimulus = false;
+	};
+
+	void OnGameplayEvents(TConstArrayView<FBotwGameplayEvent> Events);
+
+	void GatherTargets(double Now, TArray<FTarget, TInlineAllocator<8>>& OutTargets);
+
+	/** Picks the perceiver's target for this frame and returns its score, or 0 if it cannot see anything. */
+	float ChooseTarget(FPerceiver& Perceiver, TConstArrayView<FTarget> Targets, const FTarget*& OutTarget) const;
+
+	void CheckLineOfSight(FPerceiver& Perceiver, const FTarget& Target, double Now);
+
+	void SetSeen(FPerceiver& Perceiver, AActor* Target, bool bSeen);
+
+	TArray<FPerceiver> Perceivers;
+
+	/** When each actor last made noise: climb starts and dashes, ledge-ups, attacks and hits. */
+	TMap<TWeakObjectPtr<AActor>, double> StimulusTimes;
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AnimationBudgetAllocatorParameters.h"
+#include "Engine/DeveloperSettings.h"
+#include "BotwAnimationBudgetSettings.generated.h"
+
+/** How UBotwAnimationBudgetSubsystem sets up the animation budget allocator and ranks characters for it. */
+UCLASS(config = Game, defaultconfig, meta = (DisplayName = "Botw Animation Budget"))
+class BOTW_API UBotwAnimationBudgetSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+	/** Applied to the allocator of every game world. BudgetInMs is the game thread time all budgeted meshes share. */
+	UPROPERTY(config, EditAnywhere, Category = "Budget")
+	FAnimationBudgetAllocatorParameters Parameters;
+
+	/** Distance from the camera at which a character's significance reaches zero. */
+	UPROPERTY(config, EditAnywhere, Category = "Significance", meta = (ClampMin = "100"))
+	float SignificanceDistance = 5000.f;
+
+	/** Added to the significance of characters that are punching, climbing or ragdolling. */
+	UPROPERTY(config, EditAnywhere, Category = "Significance", meta = (ClampMin = "0"))
+	float CombatSignificanceBonus = 0.5f;
+
+	/** Characters in combat closer than this are updated every frame. */
+	UPROPERTY(config, EditAnywhere, Category = "Significance", meta = (ClampMin = "0"))
+	float NeverSkipCombatDistance = 1500.f;
+};
@@ -0,0 +1,239 @@
+#include "BotwAnimationBudgetSubsystem.h"
+#include "BotwAnimationBudgetSettings.h"
+#include "../Botw.h"
+#include "../BotwCharacter.h"
+#include "../MyCharacterMovementComponent.h"
+#include "Animation/AnimInstance.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerController.h"
+#include "IAnimationBudgetAllocator.h"
+#include "SkeletalMeshComponentBudgeted.h"
+
+DECLARE_CYCLE_STAT(TEXT("Animation significance"), STAT_BotwAnimationSignificance, STATGROUP_Botw);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Budgeted animated characters"), STAT_BotwBudgetedCharacters, STATGROUP_Botw);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Throttled skeletal meshes"), STAT_BotwThrottledMeshes, STATGROUP_Botw);
+
+bool UBotwAnimationBudgetSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UBotwAnimationBudgetSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UBotwAnimationBudgetSubsystem, STATGROUP_Tickables);
+}
+
+void UBotwAnimationBudgetSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	UWorld* World = GetWorld();
+	ActorPreSpawnHandle = World->AddOnActorPreSpawnInitialization(FOnActorSpawned::FDelegate::CreateUObject(this, &UBotwAnimationBudgetSubsystem::OnActorPreSpawn));
+	ActorSpawnedHandle = World->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &UBotwAnimationBudgetSubsystem::OnActorSpawned));
+}
+
+void UBotwAnimationBudgetSubsystem::Deinitialize()
+{
+	UWorld* World = GetWorld();
+	World->RemoveOnActorPreSpawnInitialization(ActorPreSpawnHandle);
+	World->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+
+	if (Allocator)
+	{
+		Allocator->SetEnabled(false);
+		Allocator = nullptr;
+	}
+
+	BudgetedCharacters.Empty();
+	ThrottledMeshes.Empty();
+
+	SET_DWORD_STAT(STAT_BotwBudgetedCharacters, 0);
+	SET_DWORD_STAT(STAT_BotwThrottledMeshes, 0);
+
+	Super::Deinitialize();
+}
+
+void UBotwAnimationBudgetSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// Nothing is rendered on a dedicated server; ABotwCharacter already only ticks montages there.
+	if (InWorld.GetNetMode() == NM_DedicatedServer)
+	{
+		return;
+	}
+
+	Allocator = IAnimationBudgetAllocator::Get(&InWorld);
+	if (!Allocator)
+	{
+		return;
+	}
+
+	Allocator->SetParameters(GetDefault<UBotwAnimationBudgetSettings>()->Parameters);
+	Allocator->SetEnabled(true);
+
+	// Actors loaded with the map were never spawned.
+	for (TActorIterator<AActor> It(&InWorld); It; ++It)
+	{
+		OnActorSpawned(*It);
+	}
+}
+
+void UBotwAnimationBudgetSubsystem::OnActorPreSpawn(AActor* Actor)
+{
+	// Dedicated servers leave animation unbudgeted, so their characters keep the meshes they were built with.
+	ACharacter* Character = Cast<ACharacter>(Actor);
+	if (Character && GetWorld()->GetNetMode() != NM_DedicatedServer)
+	{
+		SwapInBudgetedMesh(*Character);
+	}
+}
+
+void UBotwAnimationBudgetSubsystem::SwapInBudgetedMesh(ACharacter& Character)
+{
+	USkeletalMeshComponent* PlainMesh = Character.GetMesh();
+	if (!PlainMesh || PlainMesh->IsA<USkeletalMeshComponentBudgeted>() || PlainMesh->IsRegistered())
+	{
+		return;
+	}
+
+	// The budgeted mesh takes over the name, so Blueprint components attached to the mesh find it during construction.
+	const FName MeshName = PlainMesh->GetFName();
+	PlainMesh->Rename(*MakeUniqueObjectName(&Character, PlainMesh->GetClass(), *(MeshName.ToString() + TEXT("_Unbudgeted"))).ToString(),
+		nullptr, REN_DontCreateRedirectors | REN_NonTransactional);
+
+	// Not registered yet, the plain mesh holds only what the Blueprint set and its attachment to the capsule.
+	USkeletalMeshComponentBudgeted* BudgetedMesh = NewObject<USkeletalMeshComponentBudgeted>(&Character, MeshName, PlainMesh->GetFlags());
+	UEngine::CopyPropertiesForUnrelatedObjects(PlainMesh, BudgetedMesh);
+
+	// ACharacter keeps its mesh private, with no setter.
+	static FObjectProperty* const MeshProperty = FindFProperty<FObjectProperty>(ACharacter::StaticClass(), TEXT("Mesh"));
+	MeshProperty->SetObjectPropertyValue_InContainer(&Character, BudgetedMesh);
+
+	PlainMesh->DestroyComponent();
+}
+
+void UBotwAnimationBudgetSubsystem::OnActorSpawned(AActor* Actor)
+{
+	if (!Allocator)
+	{
+		return;
+	}
+
+	TInlineComponentArray<USkeletalMeshComponent*> Meshes(Actor);
+	for (USkeletalMeshComponent* Mesh : Meshes)
+	{
+		ACharacter* Character = Cast<ACharacter>(Actor);
+		USkeletalMeshComponentBudgeted* BudgetedMesh = Cast<USkeletalMeshComponentBudgeted>(Mesh);
+
+		if (Character && BudgetedMesh && Mesh == Character->GetMesh())
+		{
+			BudgetedCharacters.Add({ Character, BudgetedMesh });
+			continue;
+		}
+
+		// Meshes outside the budget still get distance based update rates, and skip their pose while off-screen
+		// unless their owner asked for something else.
+		Mesh->bEnableUpdateRateOptimizations = true;
+		if (Mesh->VisibilityBasedAnimTickOption == EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones)
+		{
+			Mesh->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
+			ThrottledMeshes.Add(Mesh);
+		}
+	}
+
+	SET_DWORD_STAT(STAT_BotwBudgetedCharacters, BudgetedCharacters.Num());
+	SET_DWORD_STAT(STAT_BotwThrottledMeshes, ThrottledMeshes.Num());
+}
+
+void UBotwAnimationBudgetSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (!Allocator)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_BotwAnimationSignificance);
+
+	const APlayerController* Player = GetWorld()->GetFirstPlayerController();
+	if (Player && Player->PlayerCameraManager)
+	{
+		UpdateSignificance(Player->PlayerCameraManager->GetCameraLocation());
+	}
+
+	UpdateThrottledMeshes();
+}
+
+void UBotwAnimationBudgetSubsystem::UpdateSignificance(const FVector& ViewLocation)
+{
+	const UBotwAnimationBudgetSettings* Settings = GetDefault<UBotwAnimationBudgetSettings>();
+	const float NeverSkipCombatDistanceSquared = FMath::Square(Settings->NeverSkipCombatDistance);
+
+	for (int32 Index = BudgetedCharacters.Num() - 1; Index >= 0; --Index)
+	{
+		const ACharacter* Character = BudgetedCharacters[Index].Character.Get();
+		USkeletalMeshComponentBudgeted* Mesh = BudgetedCharacters[Index].Mesh.Get();
+		if (!Character || !Mesh)
+		{
+			BudgetedCharacters.RemoveAtSwap(Index, EAllowShrinking::No);
+			continue;
+		}
+
+		if (!Mesh->IsRegistered() || !Mesh->IsComponentTickEnabled())
+		{
+			continue;
+		}
+
+		// Only our own characters punch and climb; NPCs are in combat while they are ragdolls.
+		const ABotwCharacter* BotwCharacter = Cast<ABotwCharacter>(Character);
+		const UMyCharacterMovementComponent* Movement = BotwCharacter ? BotwCharacter->GetCustomCharacterMovement() : nullptr;
+		const bool bPunching = BotwCharacter && BotwCharacter->bIsPunching;
+		const UAnimInstance* AnimInstance = Mesh->GetAnimInstance();
+
+		const bool bPlayingMontage = AnimInstance && AnimInstance->IsAnyMontagePlaying();
+		const bool bInCombat = bPunching || Mesh->IsSimulatingPhysics() || (Movement && Movement->IsClimbing());
+
+		const float DistanceSquared = FVector::DistSquared(ViewLocation, Mesh->GetComponentLocation());
+		const float Distance = FMath::Sqrt(DistanceSquared);
+
+		float Significance = 1.f - FMath::Clamp(Distance / Settings->SignificanceDistance, 0.f, 1.f);
+		if (bInCombat)
+		{
+			Significance += Settings->CombatSignificanceBonus;
+		}
+
+		// Our own character and close fights never drop frames; everyone else is fair game for the budget.
+		const bool bNeverSkip = Character->IsLocallyControlled() || (bInCombat && DistanceSquared < NeverSkipCombatDistanceSquared);
+
+		// Punch notifies and ledge-up root motion drive gameplay, so they have to play out even off-screen.
+		const bool bTickEvenIfNotRendered = bPlayingMontage || bPunching;
+
+		Allocator->SetComponentSignificance(Mesh, Significance, bNeverSkip, bTickEvenIfNotRendered, !bNeverSkip);
+	}
+}
+
+void UBotwAnimationBudgetSubsystem::UpdateThrottledMeshes()
+{
+	for (int32 Index = ThrottledMeshes.Num() - 1; Index >= 0; --Index)
+	{
+		USkeletalMeshComponent* Mesh = ThrottledMeshes[Index].Get();
+		if (!Mesh)
+		{
+			ThrottledMeshes.RemoveAtSwap(Index, EAllowShrinking::No);
+			continue;
+		}
+
+		// A ragdoll that stops refreshing its bones off-screen keeps stale bounds and may never be seen again.
+		Mesh->VisibilityBasedAnimTickOption = Mesh->IsSimulatingPhysics()
+			? EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones
+			: EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
+	}
+
+	SET_DWORD_STAT(STAT_BotwThrottledMeshes, ThrottledMeshes.Num());
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "BotwAnimationBudgetSubsystem.generated.h"
+
+class ACharacter;
+class IAnimationBudgetAllocator;
+class USkeletalMeshComponent;
+class USkeletalMeshComponentBudgeted;
+
+/**
+ * Caps animation cost on clients. Characters share the fixed time budget of the world's animation budget allocator,
+ * which ticks the less significant ones at lower rates and interpolates the skipped frames. Significance comes from
+ * distance to the camera and combat state, and is pushed every frame.
+ * ABotwCharacter has a budgeted mesh of its own. Spawned characters whose Blueprint gives them a plain skeletal mesh,
+ * like the test_ai NPCs, get a budgeted copy swapped in before they initialize. Other skeletal meshes, like skeletal
+ * mesh actors and characters placed in the map, get update rate optimizations and only tick montages while
+ * off-screen, unless they are ragdolls.
+ */
+UCLASS()
+class BOTW_API UBotwAnimationBudgetSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FBudgetedCharacter
+	{
+		TWeakObjectPtr<ACharacter> Character;
+
+		TWeakObjectPtr<USkeletalMeshComponentBudgeted> Mesh;
+	};
+
+	void OnActorPreSpawn(AActor* Actor);
+
+	void OnActorSpawned(AActor* Actor);
+
+	/** Replaces the character's plain mesh, not yet registered, with a budgeted one of the same name and settings. */
+	static void SwapInBudgetedMesh(ACharacter& Character);
+
+	void UpdateSignificance(const FVector& ViewLocation);
+
+	void UpdateThrottledMeshes();
+
+	IAnimationBudgetAllocator* Allocator = nullptr;
+
+	TArray<FBudgetedCharacter> BudgetedCharacters;
+
+	TArray<TWeakObjectPtr<USkeletalMeshComponent>> ThrottledMeshes;
+
+	FDelegateHandle ActorPreSpawnHandle;
+
+	FDelegateHandle ActorSpawnedHandle;
+};
@@ -0,0 +1,294 @@
+#include "BotwBotPlayerController.h"
+#include "../Botw.h"
+#include "../BotwCharacter.h"
+#include "../MyCharacterMovementComponent.h"
+#include "../AI/BotwNpcPoolSubsystem.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+
+ABotwBotPlayerController::ABotwBotPlayerController()
+{
+	bShowMouseCursor = false;
+}
+
+void ABotwBotPlayerController::SetActions(const TArray<FBotwBotAction>& InActions, int32 InLoops)
+{
+	Actions = InActions;
+	Loops = FMath::Max(1, InLoops);
+	CurrentLoop = 0;
+	CurrentIndex = INDEX_NONE;
+	bFinished = false;
+}
+
+bool ABotwBotPlayerController::ChooseNextActions()
+{
+	return false;
+}
+
+void ABotwBotPlayerController::StartAction(int32 Index)
+{
+	if (Index >= Actions.Num())
+	{
+		++CurrentLoop;
+
+		if (CurrentLoop >= Loops && !ChooseNextActions())
+		{
+			bFinished = true;
+			return;
+		}
+
+		Index = 0;
+	}
+
+	CurrentIndex = Index;
+	ActionTime = 0.f;
+	CooldownTime = 0.f;
+	ActionCounter = 0;
+	bHasClimbed = false;
+	bHasWallTarget = false;
+	PunchTarget.Reset();
+}
+
+void ABotwBotPlayerController::PlayerTick(float DeltaTime)
+{
+	Super::PlayerTick(DeltaTime);
+
+	ABotwCharacter* BotwCharacter = Cast<ABotwCharacter>(GetPawn());
+	if (bFinished || !BotwCharacter)
+	{
+		return;
+	}
+
+	if (!bHasBaseYaw)
+	{
+		BaseYaw = BotwCharacter->GetActorRotation().Yaw;
+		bHasBaseYaw = true;
+	}
+
+	if (CurrentIndex == INDEX_NONE)
+	{
+		StartAction(0);
+	}
+
+	if (bFinished || !Actions.IsValidIndex(CurrentIndex))
+	{
+		bFinished = true;
+		return;
+	}
+
+	ActionTime += DeltaTime;
+	CooldownTime = FMath::Max(0.f, CooldownTime - DeltaTime);
+
+	const FBotwBotAction& Action = Actions[CurrentIndex];
+
+	bool bDone = false;
+	switch (Action.Type)
+	{
+	case EBotwBotActionType::Walk:
+		bDone = TickWalk(BotwCharacter, Action);
+		break;
+	case EBotwBotActionType::ClimbWall:
+		bDone = TickClimb(BotwCharacter, Action, false);
+		break;
+	case EBotwBotActionType::ClimbDash:
+		bDone = TickClimb(BotwCharacter, Action, true);
+		break;
+	case EBotwBotActionType::PunchNearest:
+		bDone = TickPunch(BotwCharacter, Action);
+		break;
+	case EBotwBotActionType::SpawnNpcs:
+		bDone = TickSpawnNpcs(BotwCharacter, Action);
+		break;
+	case EBotwBotActionType::ReleaseNpcs:
+		ReleaseNpcs();
+		bDone = true;
+		break;
+	case EBotwBotActionType::Wait:
+		bDone = ActionTime >= Action.Duration;
+		break;
+	}
+
+	if (bDone)
+	{
+		StartAction(CurrentIndex + 1);
+	}
+}
+
+bool ABotwBotPlayerController::TickWalk(ABotwCharacter* BotwCharacter, const FBotwBotAction& Action)
+{
+	const FVector Direction = FRotator(0.f, BaseYaw + Action.Yaw, 0.f).Vector();
+	BotwCharacter->AddMovementInput(Direction, 1.f);
+
+	return ActionTime >= Action.Duration;
+}
+
+bool ABotwBotPlayerController::TickClimb(ABotwCharacter* BotwCharacter, const FBotwBotAction& Action, bool bDash)
+{
+	UMyCharacterMovementComponent* Movement = BotwCharacter->GetCustomCharacterMovement();
+
+	if (Movement->IsClimbing())
+	{
+		bHasClimbed = true;
+
+		// Same mapping as ABotwCharacter::Move for "forward" while on a wall.
+		const FVector Up = FVector::CrossProduct(Movement->GetClimbSurfaceNormal(), -BotwCharacter->GetActorRightVector());
+		BotwCharacter->AddMovementInput(Up, 1.f);
+
+		if (bDash && CooldownTime <= 0.f)
+		{
+			Movement->TryClimbDashing();
+			CooldownTime = ClimbDashInterval;
+		}
+
+		if (ActionTime >= Action.Duration)
+		{
+			BotwCharacter->CancelClimb();
+			return true;
+		}
+
+		return false;
+	}
+
+	// Either pulled up over the ledge or dropped off the wall.
+	if (bHasClimbed || ActionTime >= Action.Duration)
+	{
+		return true;
+	}
+
+	if (!bHasWallTarget)
+	{
+		bHasWallTarget = FindWallTarget(BotwCharacter, WallTarget);
+		if (!bHasWallTarget)
+		{
+			UE_LOG(LogBotw, Warning, TEXT("Bot %s found no climbable wall, skipping action"), *GetNameSafe(this));
+			return true;
+		}
+	}
+
+	const FVector ToWall = WallTarget - BotwCharacter->GetActorLocation();
+	BotwCharacter->AddMovementInput(ToWall.GetSafeNormal2D(), 1.f);
+
+	if (ToWall.Size2D() < WallSearchRadius * 0.2f && CooldownTime <= 0.f)
+	{
+		BotwCharacter->Climb();
+		CooldownTime = 0.25f;
+	}
+
+	return false;
+}
+
+bool ABotwBotPlayerController::TickPunch(ABotwCharacter* BotwCharacter, const FBotwBotAction& Action)
+{
+	ACharacter* Target = PunchTarget.Get();
+	if (!Target)
+	{
+		Target = FindPunchTarget(BotwCharacter);
+		PunchTarget = Target;
+
+		if (!Target)
+		{
+			return true;
+		}
+	}
+
+	const FVector ToTarget = Target->GetActorLocation() - BotwCharacter->GetActorLocation();
+
+	if (ToTarget.Size2D() > PunchRange)
+	{
+		BotwCharacter->AddMovementInput(ToTarget.GetSafeNormal2D(), 1.f);
+	}
+	else if (CooldownTime <= 0.f && !BotwCharacter->bIsPunching && ActionCounter < Action.Count)
+	{
+		BotwCharacter->SetActorRotation(FRotator(0.f, ToTarget.Rotation().Yaw, 0.f));
+		BotwCharacter->Attack();
+
+		CooldownTime = PunchInterval;
+		++ActionCounter;
+	}
+
+	return (ActionCounter >= Action.Count && CooldownTime <= 0.f) || ActionTime >= Action.Duration;
+}
+
+bool ABotwBotPlayerController::TickSpawnNpcs(ABotwCharacter* BotwCharacter, const FBotwBotAction& Action)
+{
+	UBotwNpcPoolSubsystem* Pool = GetWorld()->GetSubsystem<UBotwNpcPoolSubsystem>();
+	if (!Pool)
+	{
+		return true;
+	}
+
+	if (ActionCounter == 0)
+	{
+		ActionCounter = Action.Count;
+
+		for (int32 Index = 0; Index < Action.Count; ++Index)
+		{
+			const FVector Offset = FRotator(0.f, BaseYaw + 360.f * Index / Action.Count, 0.f).Vector() * PunchRange * 4.f;
+			SpawnedNpcs.Add(Pool->AcquireNpc(FTransform(BotwCharacter->GetActorLocation() + Offset)));
+		}
+	}
+
+	return ActionTime >= Action.Duration;
+}
+
+void ABotwBotPlayerController::ReleaseNpcs()
+{
+	if (UBotwNpcPoolSubsystem* Pool = GetWorld()->GetSubsystem<UBotwNpcPoolSubsystem>())
+	{
+		for (const TWeakObjectPtr<AActor>& Npc : SpawnedNpcs)
+		{
+			Pool->ReleaseNpc(Npc.Get());
+		}
+	}
+
+	SpawnedNpcs.Reset();
+}
+
+bool ABotwBotPlayerController::FindWallTarget(const ACharacter* BotwCharacter, FVector& OutLocation) const
+{
+	constexpr int32 NumDirections = 16;
+
+	FCollisionQueryParams Params(SCENE_QUERY_STAT(BotwBotWallSearch), false, BotwCharacter);
+
+	const FVector Start = BotwCharacter->GetActorLocation();
+	float BestDistance = TNumericLimits<float>::Max();
+
+	for (int32 Index = 0; Index < NumDirections; ++Index)
+	{
+		const FVector Direction = FRotator(0.f, BaseYaw + 360.f * Index / NumDirections, 0.f).Vector();
+
+		FHitResult Hit;
+		if (GetWorld()->LineTraceSingleByChannel(Hit, Start, Start + Direction * WallSearchRadius, ECC_Climbable, Params)
+			&& FMath::Abs(Hit.ImpactNormal.Z) < 0.5f && Hit.Distance < BestDistance)
+		{
+			BestDistance = Hit.Distance;
+			OutLocation = Hit.ImpactPoint;
+		}
+	}
+
+	return BestDistance < TNumericLimits<float>::Max();
+}
+
+ACharacter* ABotwBotPlayerController::FindPunchTarget(const ACharacter* BotwCharacter) const
+{
+	ACharacter* BestTarget = nullptr;
+	float BestDistanceSquared = FMath::Square(PunchSearchRadius);
+
+	for (TActorIterator<ACharacter> It(GetWorld()); It; ++It)
+	{
+		// Pooled NPCs wait hidden.
+		if (*It == BotwCharacter || It->IsHidden())
+		{
+			continue;
+		}
+
+		const float DistanceSquared = FVector::DistSquared(It->GetActorLocation(), BotwCharacter->GetActorLocation());
+		if (DistanceSquared < BestDistanceSquared)
+		{
+			BestDistanceSquared = DistanceSquared;
+			BestTarget = *It;
+		}
+	}
+
+	return BestTarget;
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/PlayerController.h"
+#include "BotwBotPlayerController.generated.h"
+
+class ABotwCharacter;
+class ACharacter;
+
+UENUM()
+enum class EBotwBotActionType : uint8
+{
+	/** Run for Duration seconds along Yaw, relative to the heading the route started with. */
+	Walk,
+	/** Run at the nearest climbable wall and climb it until the ledge-up, or give up after Duration. */
+	ClimbWall,
+	/** Same as ClimbWall, climb-dashing whenever the dash is available. */
+	ClimbDash,
+	/** Run to the nearest other character and punch it Count times. */
+	PunchNearest,
+	/** Take Count NPCs from the pool and place them around the bot, then wait for Duration. */
+	SpawnNpcs,
+	/** Hand every NPC the bot took back to the pool. */
+	ReleaseNpcs,
+	Wait,
+};
+
+USTRUCT()
+struct FBotwBotAction
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, Category = "Bot")
+	EBotwBotActionType Type = EBotwBotActionType::Wait;
+
+	UPROPERTY(EditAnywhere, Category = "Bot")
+	float Duration = 3.f;
+
+	UPROPERTY(EditAnywhere, Category = "Bot")
+	float Yaw = 0.f;
+
+	UPROPERTY(EditAnywhere, Category = "Bot")
+	int32 Count = 1;
+};
+
+/**
+ * Player controller that drives an ABotwCharacter through a list of scripted actions instead of input.
+ * Used for repeatable profiling runs; only ticks its script on the machine that owns the player.
+ */
+UCLASS()
+class BOTW_API ABotwBotPlayerController : public APlayerController
+{
+	GENERATED_BODY()
+
+public:
+	ABotwBotPlayerController();
+
+	void SetActions(const TArray<FBotwBotAction>& InActions, int32 InLoops = 1);
+
+	bool IsFinished() const { return bFinished; }
+
+	virtual void PlayerTick(float DeltaTime) override;
+
+protected:
+	/** Picks the next action once the list runs out. Returns false to finish. */
+	virtual bool ChooseNextActions();
+
+	TArray<FBotwBotAction> Actions;
+
+private:
+	void StartAction(int32 Index);
+
+	bool TickWalk(ABotwCharacter* BotwCharacter, const FBotwBotAction& Action);
+
+	bool TickClimb(ABotwCharacter* BotwCharacter, const FBotwBotAction& Action, bool bDash);
+
+	bool TickPunch(ABotwCharacter* BotwCharacter, const FBotwBotAction& Action);
+
+	bool TickSpawnNpcs(ABotwCharacter* BotwCharacter, const FBotwBotAction& Action);
+
+	void ReleaseNpcs();
+
+	bool FindWallTarget(const ACharacter* BotwCharacter, FVector& OutLocation) const;
+
+	ACharacter* FindPunchTarget(const ACharacter* BotwCharacter) const;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Bot")
+	float WallSearchRadius = 1500.f;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Bot")
+	float PunchSearchRadius = 3000.f;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Bot")
+	float PunchRange = 120.f;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Bot")
+	float ClimbDashInterval = 1.5f;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Bot")
+	float PunchInterval = 1.2f;
+
+	int32 Loops = 1;
+
+	int32 CurrentLoop = 0;
+
+	int32 CurrentIndex = INDEX_NONE;
+
+	float ActionTime = 0.f;
+
+	float CooldownTime = 0.f;
+
+	int32 ActionCounter = 0;
+
+	float BaseYaw = 0.f;
+
+	bool bHasBaseYaw = false;
+
+	bool bHasClimbed = false;
+
+	bool bHasWallTarget = false;
+
+	FVector WallTarget;
+
+	TWeakObjectPtr<ACharacter> PunchTarget;
+
+	TArray<TWeakObjectPtr<AActor>> SpawnedNpcs;
+
+	bool bFinished = false;
+};
@@ -0,0 +1,44 @@
+#include "BotwLoadTestPlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "Misc/CommandLine.h"
+
+bool ABotwLoadTestPlayerController::ChooseNextActions()
+{
+	if (!bSeeded)
+	{
+		int32 Seed = PlayerState ? PlayerState->GetPlayerId() : 0;
+		FParse::Value(FCommandLine::Get(), TEXT("BotSeed="), Seed);
+
+		Random.Initialize(Seed);
+		bSeeded = true;
+	}
+
+	Actions.Reset();
+
+	FBotwBotAction& Wander = Actions.AddDefaulted_GetRef();
+	Wander.Type = EBotwBotActionType::Walk;
+	Wander.Yaw = Random.FRandRange(0.f, 360.f);
+	Wander.Duration = Random.FRandRange(1.f, 5.f);
+
+	// Roughly how players split their time: mostly climbing, some fighting.
+	const float Roll = Random.FRand();
+	if (Roll < 0.6f)
+	{
+		FBotwBotAction& Climb = Actions.AddDefaulted_GetRef();
+		Climb.Type = Random.FRand() < 0.4f ? EBotwBotActionType::ClimbDash : EBotwBotActionType::ClimbWall;
+		Climb.Duration = Random.FRandRange(4.f, 12.f);
+	}
+	else if (Roll < 0.9f)
+	{
+		FBotwBotAction& Punch = Actions.AddDefaulted_GetRef();
+		Punch.Type = EBotwBotActionType::PunchNearest;
+		Punch.Count = Random.RandRange(1, 4);
+		Punch.Duration = 8.f;
+	}
+
+	FBotwBotAction& Idle = Actions.AddDefaulted_GetRef();
+	Idle.Type = EBotwBotActionType::Wait;
+	Idle.Duration = Random.FRandRange(0.2f, 2.f);
+
+	return true;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BotwBotPlayerController.h"
+#include "BotwLoadTestPlayerController.generated.h"
+
+/**
+ * Bot for server load tests: plays an endless random mix of wandering, running at walls to climb (with dashes and
+ * ledge-ups) and punching whoever is nearby. The game mode hands it to players that join with ?Bot=1; it runs on
+ * the client like a real player, so the server sees ordinary movement RPCs. Seeded with -BotSeed=N when given.
+ */
+UCLASS()
+class BOTW_API ABotwLoadTestPlayerController : public ABotwBotPlayerController
+{
+	GENERATED_BODY()
+
+protected:
+	virtual bool ChooseNextActions() override;
+
+private:
+	FRandomStream Random;
+
+	bool bSeeded = false;
+};
@@ -8,6 +8,16 @@ public class Botw : ModuleRules
 	{
 		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
 
-		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "EnhancedInput" });
+		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "EnhancedInput", "PhysicsCore", "DeveloperSettings", "AIModule", "GameplayTasks", "NavigationSystem", "Landscape", "AnimationBudgetAllocator" });
+
+		if (Target.bBuildEditor)
+		{
+			PrivateDependencyModuleNames.AddRange(new string[] { "UnrealEd", "AssetRegistry" });
+		}
+
+		if (Target.bUseGameplayDebugger)
+		{
+			PrivateDependencyModuleNames.Add("GameplayDebugger");
+		}
 	}
 }
@@ -3,5 +3,38 @@
 #include "Botw.h"
 #include "Modules/ModuleManager.h"
 
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, Botw, "Botw" );
- 
\ No newline at end of file
+#if WITH_GAMEPLAY_DEBUGGER
+#include "GameplayDebugger.h"
+#include "Debug/GameplayDebuggerCategory_BotwClimbing.h"
+#endif
+
+DEFINE_LOG_CATEGORY(LogBotw);
+
+class FBotwModule : public FDefaultGameModuleImpl
+{
+public:
+	virtual void StartupModule() override
+	{
+#if WITH_GAMEPLAY_DEBUGGER
+		IGameplayDebugger& GameplayDebugger = IGameplayDebugger::Get();
+		GameplayDebugger.RegisterCategory(TEXT("Climbing"),
+			IGameplayDebugger::FOnGetCategory::CreateStatic(&FGameplayDebuggerCategory_BotwClimbing::MakeInstance),
+			EGameplayDebuggerCategoryState::EnabledInGameAndSimulate, 6);
+		GameplayDebugger.NotifyCategoriesChanged();
+#endif
+	}
+
+	virtual void ShutdownModule() override
+	{
+#if WITH_GAMEPLAY_DEBUGGER
+		if (IGameplayDebugger::IsAvailable())
+		{
+			IGameplayDebugger& GameplayDebugger = IGameplayDebugger::Get();
+			GameplayDebugger.UnregisterCategory(TEXT("Climbing"));
+			GameplayDebugger.NotifyCategoriesChanged();
+		}
+#endif
+	}
+};
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FBotwModule, Botw, "Botw" );
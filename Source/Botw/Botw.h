@@ -3,3 +3,14 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogBotw, Log, All);
+
+DECLARE_STATS_GROUP(TEXT("Botw"), STATGROUP_Botw, STATCAT_Advanced);
+
+/**
+ * Trace channel of the climbing wall queries. Climb-collision proxies only respond to this channel. Floor and ledge
+ * checks stay on ECC_WorldStatic, against the collision the character actually stands on.
+ */
+#define ECC_Climbable ECC_GameTraceChannel2
@@ -11,7 +11,11 @@
 #include "EnhancedInputSubsystems.h"
 #include "InputActionValue.h"
 #include "MyCharacterMovementComponent.h" // Include the header here
-#include "Kismet/KismetMathLibrary.h"
+#include "BotwFrameScratch.h"
+#include "Combat/BotwCombatTargetSubsystem.h"
+#include "Events/BotwEventBusSubsystem.h"
+#include "Profiling/BotwFlightRecorder.h"
+#include "SkeletalMeshComponentBudgeted.h"
 
 
 DEFINE_LOG_CATEGORY(LogTemplateCharacter);
@@ -19,13 +23,19 @@ DEFINE_LOG_CATEGORY(LogTemplateCharacter);
 //////////////////////////////////////////////////////////////////////////
 // ABotwCharacter
 
-ABotwCharacter::ABotwCharacter(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer.SetDefaultSubobjectClass<UMyCharacterMovementComponent>(ACharacter::CharacterMovementComponentName))
+ABotwCharacter::ABotwCharacter(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer
+	.SetDefaultSubobjectClass<UMyCharacterMovementComponent>(ACharacter::CharacterMovementComponentName)
+	.SetDefaultSubobjectClass<USkeletalMeshComponentBudgeted>(ACharacter::MeshComponentName))
 {
+	// Significance is pushed every frame by UBotwAnimationBudgetSubsystem.
+	CastChecked<USkeletalMeshComponentBudgeted>(GetMesh())->SetAutoCalculateSignificance(false);
+
 	// Set size for collision capsule
 	GetCapsuleComponent()->InitCapsuleSize(42.f, 96.0f);
 
-	// Set this character to call Tick() every frame
+	// Tick is registered on demand by TickActivation; idle characters do not tick
     PrimaryActorTick.bCanEverTick = true;
+    PrimaryActorTick.bStartWithTickEnabled = false;
 		
 	// Don't rotate when the controller rotates. Let that just affect the camera.
 	bUseControllerRotationPitch = false;
@@ -85,18 +95,35 @@ ABotwCharacter::ABotwCharacter(const FObjectInitializer& ObjectInitializer) : Su
 
 void ABotwCharacter::SetPunching(bool bPunching)
 {
+    if (bPunching != bIsPunching)
+    {
+        BotwFlightRecorder::Record(bPunching ? EBotwFlightEventType::PunchBegin : EBotwFlightEventType::PunchEnd,
+            MovementComponent->GetFlightRecorderId());
+    }
+
+    // A new swing can hit everything again.
+    if (bPunching && !bIsPunching)
+    {
+        PunchHitActors.Reset();
+    }
+
     bIsPunching = bPunching;
 
     if (bIsPunching)
     {
+        TickActivation.Add(EBotwTickReason::Punch);
+
         // Call the overlap check immediately when punch starts
         CheckOverlapDuringPunch();
     }
+    else
+    {
+        TickActivation.Remove(EBotwTickReason::Punch);
+    }
 }
 
 bool ABotwCharacter::IsPunching() const
 {
-	GEngine->AddOnScreenDebugMessage(-1, 15.0f, FColor::Yellow, TEXT("isPunching"));
     return bIsPunching;
 }
 
@@ -122,66 +149,79 @@ void ABotwCharacter::EnableLeftClick()
 
 void ABotwCharacter::CheckOverlapDuringPunch()
 {
-    TArray<AActor*> OverlappingActors;
-    GetOverlappingActors(OverlappingActors);
+    BOTW_FLIGHT_PHASE(PunchOverlap, MovementComponent->GetFlightRecorderId());
 
-    auto HandleSkeletalMeshComponent = [&](USkeletalMeshComponent* SkeletalMeshComp, AActor* Actor)
+    const UBotwCombatTargetSubsystem* CombatTargets = GetWorld()->GetSubsystem<UBotwCombatTargetSubsystem>();
+    if (!CombatTargets || !FistCollision)
     {
-        if (SkeletalMeshComp)
-        {
-            if (!SkeletalMeshComp->IsSimulatingPhysics())
-            {
-                SkeletalMeshComp->SetSimulatePhysics(true);
-            }
-
-            FVector ImpactNormal = GetActorForwardVector();
-            FVector ImpactImpulse = ImpactNormal * 10000.0f; // Example force magnitude
-
-            SkeletalMeshComp->SetAngularDamping(5.0f); // Adjust value as needed
-            SkeletalMeshComp->SetLinearDamping(2.0f);  // Adjust value as needed
-
-            FRotator PlayerRotation = GetActorRotation();
-            FVector ForwardVector = UKismetMathLibrary::GetForwardVector(PlayerRotation);
+        return;
+    }
 
-            UE_LOG(LogTemp, Warning, TEXT("ImpactNormal %s"), *ImpactNormal.ToString());
-            UE_LOG(LogTemp, Warning, TEXT("ImpactImpulse %s"), *ImpactImpulse.ToString());
-            UE_LOG(LogTemp, Warning, TEXT("ForwardVector %s"), *ForwardVector.ToString());
+    MovementComponent->GetQueryCounter().AddState(EBotwQueryBudgetState::Punching);
 
-            SkeletalMeshComp->AddImpulse(ForwardVector * 10000.0f, NAME_None, true);
+    TBotwScratchArray<const FBotwCombatTarget*> HitTargets;
+    CombatTargets->QuerySphere(FistCollision->GetComponentLocation(), FistCollision->GetScaledSphereRadius(), this, *HitTargets);
 
-            UE_LOG(LogTemp, Warning, TEXT("Triggered ragdoll on %s"), *Actor->GetName());
-        }
-    };
-
-    for (AActor* Actor : OverlappingActors)
+    // The ragdoll and impulse are applied by UBotwCombatTargetSubsystem when the event bus is drained.
+    for (const FBotwCombatTarget* Target : *HitTargets)
     {
-        if (Actor)
+        bool bAlreadyHit = false;
+        PunchHitActors.Add(Target->Actor, &bAlreadyHit);
+        if (bAlreadyHit)
         {
-            UE_LOG(LogTemp, Warning, TEXT("Overlap with %s"), *Actor->GetName());
-
-            ACharacter* Character = Cast<ACharacter>(Actor);
-            if (Character)
-            {
-                USkeletalMeshComponent* SkeletalMeshComp = Character->GetMesh();
-                HandleSkeletalMeshComponent(SkeletalMeshComp, Actor);
-            }
-
-            auto SkeletalMeshActor = Cast<ASkeletalMeshActor>(Actor);
-            if (SkeletalMeshActor)
-            {
-                USkeletalMeshComponent* SkeletalMeshComp = SkeletalMeshActor->GetSkeletalMeshComponent();
-                HandleSkeletalMeshComponent(SkeletalMeshComp, Actor);
-            }
+            continue;
         }
+
+        UBotwEventBusSubsystem::Push(EBotwGameplayEventType::PunchHit, this, Target->Actor.Get(),
+            FistCollision->GetComponentLocation(), GetActorForwardVector());
     }
 }
 
 //----------------------------------------------------------------------------------------------------------
 
+void ABotwCharacter::PreRegisterAllComponents()
+{
+	Super::PreRegisterAllComponents();
+
+	if (GetNetMode() == NM_DedicatedServer)
+	{
+		CameraBoom->bAutoRegister = false;
+		FollowCamera->bAutoRegister = false;
+	}
+}
+
 void ABotwCharacter::BeginPlay()
 {
     Super::BeginPlay();
 
+    FistCollision = Cast<USphereComponent>(FindComponentByClass<USphereComponent>());
+
+    TickActivation.Init(*this);
+
+    // Dedicated servers only need the pose for montages (punch notifies, ledge-up root motion), and have no one to play
+    // music or show a cursor to.
+    if (IsNetMode(NM_DedicatedServer))
+    {
+        GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
+    }
+    else
+    {
+        BeginPlayCosmetics();
+    }
+
+    // Initialize the AnimInstance
+    if (GetMesh())
+    {
+        AnimInstance = GetMesh()->GetAnimInstance();
+        if (!AnimInstance)
+        {
+            UE_LOG(LogTemplateCharacter, Error, TEXT("AnimInstance is null in BeginPlay for %s"), *GetNameSafe(this));
+        }
+    }
+}
+
+void ABotwCharacter::BeginPlayCosmetics()
+{
     GEngine->AddOnScreenDebugMessage(-1, 15.0f, FColor::Yellow, TEXT("BEGIN PLAY"));
 
     // Example: Load your SoundWave asset
@@ -198,7 +238,8 @@ void ABotwCharacter::BeginPlay()
     }
 
     // Add Input Mapping Context
-    if (APlayerController* PlayerController = Cast<APlayerController>(Controller))
+    APlayerController* PlayerController = Cast<APlayerController>(Controller);
+    if (PlayerController && PlayerController->IsLocalController())
     {
         if (UEnhancedInputLocalPlayerSubsystem* Subsystem = ULocalPlayer::GetSubsystem<UEnhancedInputLocalPlayerSubsystem>(PlayerController->GetLocalPlayer()))
         {
@@ -216,21 +257,8 @@ void ABotwCharacter::BeginPlay()
         InputMode.SetHideCursorDuringCapture(false); // Ensure cursor stays visible
         PlayerController->SetInputMode(InputMode);
     }
-
-    FistCollision = Cast<USphereComponent>(FindComponentByClass<USphereComponent>());
-
-    // Initialize the AnimInstance
-    if (GetMesh())
-    {
-        AnimInstance = GetMesh()->GetAnimInstance();
-        if (!AnimInstance)
-        {
-            UE_LOG(LogTemplateCharacter, Error, TEXT("AnimInstance is null in BeginPlay for %s"), *GetNameSafe(this));
-        }
-    }
 }
 
-
 void ABotwCharacter::OnBoxHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
 {
     // Handle hit logic here
@@ -247,7 +275,7 @@ void ABotwCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputCompo
     {
 		
 		// Jumping
-		EnhancedInputComponent->BindAction(JumpAction, ETriggerEvent::Started, this, &ABotwCharacter::Jump);
+		EnhancedInputComponent->BindAction(JumpAction, ETriggerEvent::Started, this, &ABotwCharacter::JumpOrGlide);
 		EnhancedInputComponent->BindAction(JumpAction, ETriggerEvent::Completed, this, &ABotwCharacter::StopJumping);
 
 		// Moving
@@ -591,70 +619,97 @@ void ABotwCharacter::OnMiddleMouseReleased()
 
 void ABotwCharacter::Climb()
 {
-	GEngine->AddOnScreenDebugMessage(-1, 15.0f, FColor::Yellow, TEXT("+++ CLIMB +++"));
+	UBotwEventBusSubsystem::Push(EBotwGameplayEventType::ClimbRequested, this);
 	MovementComponent->TryClimbing();
 }
 
 void ABotwCharacter::CancelClimb()
 {
-	GEngine->AddOnScreenDebugMessage(-1, 15.0f, FColor::Yellow, TEXT("+++ CANCEL CLIMB +++"));
+	UBotwEventBusSubsystem::Push(EBotwGameplayEventType::ClimbCancelled, this);
 	MovementComponent->CancelClimbing();
 }
 
+void ABotwCharacter::JumpOrGlide()
+{
+	if (MovementComponent->IsGliding())
+	{
+		MovementComponent->CancelGliding();
+	}
+	else if (MovementComponent->IsFalling())
+	{
+		MovementComponent->TryGliding();
+	}
+	else
+	{
+		Jump();
+	}
+}
+
 void ABotwCharacter::Attack()
 {
-	GEngine->AddOnScreenDebugMessage(-1, 15.0f, FColor::Yellow, TEXT("+++ ATTACK +++"));
+	UBotwEventBusSubsystem::Push(EBotwGameplayEventType::AttackStarted, this);
 
-	ABotwCharacter* Character = Cast<ABotwCharacter>(MovementComponent->GetOwner());
+	if (!PlayAttackMontage())
+	{
+		return;
+	}
 
-	UE_LOG(LogTemp, Warning, TEXT("BEFORE IF: bIsPunching %s"), Character->IsPunching() ? TEXT("true") : TEXT("false"));
+	if (HasAuthority())
+	{
+		MulticastAttack();
+	}
+	else
+	{
+		ServerAttack();
+	}
+}
+
+void ABotwCharacter::ServerAttack_Implementation()
+{
+	Attack();
+}
+
+void ABotwCharacter::MulticastAttack_Implementation()
+{
+	if (GetLocalRole() == ROLE_SimulatedProxy)
+	{
+		PlayAttackMontage();
+	}
+}
+
+bool ABotwCharacter::PlayAttackMontage()
+{
+	ABotwCharacter* Character = Cast<ABotwCharacter>(MovementComponent->GetOwner());
 
     if (Character && Punching_UE_Montage && !Character->IsPunching())
     {
-		UE_LOG(LogTemp, Warning, TEXT("AFTER IF: bIsPunching %s"), Character->IsPunching() ? TEXT("true") : TEXT("false"));
-
 		if (!AnimInstance)
         {
             AnimInstance = GetMesh()->GetAnimInstance();
             if (!AnimInstance)
             {
                 UE_LOG(LogTemplateCharacter, Error, TEXT("AnimInstance is null in Attack for %s"), *GetNameSafe(this));
-                return;
+                return false;
             }
         }
 
         AnimInstance->Montage_Play(Punching_UE_Montage);
 
-		UE_LOG(LogTemp, Warning, TEXT("ice cream and beans"));
-
         // Set up a notification or callback to reset the flag when the montage ends
         FOnMontageEnded MontageEndedDelegate;
         MontageEndedDelegate.BindUObject(this, &ABotwCharacter::OnPunchingMontageEnded);
         AnimInstance->Montage_SetEndDelegate(MontageEndedDelegate, Punching_UE_Montage);
+        return true;
     }
+
+    return false;
 }
 
 void ABotwCharacter::OnPunchingMontageEnded(UAnimMontage* Montage, bool bInterrupted)
 {
-	UE_LOG(LogTemp, Warning, TEXT("[OnPunchingMontageEnded]"));
-    if (Montage && Montage == Punching_UE_Montage && MovementComponent)
-    {
-
-    }
-    else
+    // An interrupted montage never reaches UMyAnimNotify_PunchEnd; close the punch window so the tick goes idle
+    if (Montage == Punching_UE_Montage && bIsPunching)
     {
-        if (!Montage)
-        {
-
-        }
-        else if (Montage != Punching_UE_Montage)
-        {
-
-        }
-
-        if (!MovementComponent)
-        {
-
-        }
+        SetPunching(false);
     }
-}
\ No newline at end of file
+}
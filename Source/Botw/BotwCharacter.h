@@ -11,6 +11,7 @@
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Sound/SoundWave.h"
 #include "Kismet/GameplayStatics.h"
+#include "BotwTickActivation.h"
 #include "BotwCharacter.generated.h"
 
 // Forward declaration
@@ -25,11 +26,11 @@ struct FInputActionValue;
 DECLARE_LOG_CATEGORY_EXTERN(LogTemplateCharacter, Log, All);
 
 UCLASS(config=Game)
-class ABotwCharacter : public ACharacter
+class ABotwCharacter : public ACharacter, public IBotwTickActivated
 {
 	GENERATED_BODY()
 
-	/** Camera boom positioning the camera behind the character */
+	/** Camera boom positioning the camera behind the character. Not registered on dedicated servers, like FollowCamera. */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
 	USpringArmComponent* CameraBoom;
 
@@ -92,17 +93,41 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Character")
     bool IsPunching() const;
 
+    /** Only registered while a punch window is open, or when a Blueprint subclass implements Event Tick. */
     virtual void Tick(float DeltaTime) override;
 
+	virtual FBotwTickActivation& GetTickActivation() override { return TickActivation; }
+
 	void DisableLeftClick();
     void EnableLeftClick();
 
 	UPROPERTY(Category="Character Movement: Punching", EditDefaultsOnly)
 	UAnimMontage* Punching_UE_Montage;
 
+	// Gameplay actions bound to input, also driven directly by bot controllers
+	void Climb();
+
+	void CancelClimb();
+
+	void Attack();
+
+	/** Jumps on the ground, opens the glider while falling and closes it while gliding. */
+	void JumpOrGlide();
+
 private:
     void CheckOverlapDuringPunch();
 
+	/** False if a punch is already playing. */
+	bool PlayAttackMontage();
+
+	/** Punch hits are decided on the server, so it plays the punch too; see UBotwCombatTargetSubsystem::ApplyPunchHit. */
+	UFUNCTION(Server, Reliable)
+	void ServerAttack();
+
+	/** Only the animation, for simulated proxies. */
+	UFUNCTION(NetMulticast, Unreliable)
+	void MulticastAttack();
+
 	bool bDisableLeftClick;
 
 	UPROPERTY(Category="Character Movement: Punching", EditDefaultsOnly)
@@ -117,6 +142,11 @@ private:
 
 	FVector2D OriginalCursorPosition;
 
+	FBotwTickActivation TickActivation;
+
+	/** Targets the open punch window has hit. Each swing hits a target once, however many ticks it stays in the fist. */
+	TSet<TWeakObjectPtr<AActor>, DefaultKeyFuncs<TWeakObjectPtr<AActor>>, TInlineSetAllocator<8>> PunchHitActors;
+
 protected:
 
     // New methods for mouse input handling
@@ -164,18 +194,18 @@ protected:
 	// APawn interface
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 	
+	/** Keeps the cameras from registering on dedicated servers. They still exist, so Blueprints and cooked data match. */
+	virtual void PreRegisterAllComponents() override;
+
 	// To add mapping context
 	virtual void BeginPlay();
 
+	/** Music, input mapping and cursor setup; skipped on dedicated servers. */
+	void BeginPlayCosmetics();
+
 	UPROPERTY(Category=Character, VisibleAnywhere, BlueprintReadOnly)
 	UMyCharacterMovementComponent* MovementComponent;
 
-	void Climb();
-
-	void CancelClimb();
-
-	void Attack();
-
 	void OnPunchingMontageEnded(UAnimMontage* Montage, bool bInterrupted);
 
 public:
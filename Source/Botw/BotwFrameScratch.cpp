@@ -0,0 +1,43 @@
+#include "BotwFrameScratch.h"
+#include "Botw.h"
+#include "Misc/CoreDelegates.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Scratch arrays borrowed"), STAT_BotwScratchBorrows, STATGROUP_Botw);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Scratch arrays grown"), STAT_BotwScratchArraysGrown, STATGROUP_Botw);
+
+namespace BotwFrameScratch
+{
+	static int32 Outstanding = 0;
+
+	static uint32 NumGrown = 0;
+
+	static void CheckEndOfFrame()
+	{
+		ensureMsgf(Outstanding == 0, TEXT("%d Botw scratch arrays were not returned by the end of the frame"), Outstanding);
+	}
+}
+
+void BotwFrameScratch::OnBorrow()
+{
+	static FDelegateHandle EndFrameHandle = FCoreDelegates::OnEndFrame.AddStatic(&CheckEndOfFrame);
+
+	++Outstanding;
+
+	INC_DWORD_STAT(STAT_BotwScratchBorrows);
+}
+
+void BotwFrameScratch::OnReturn(bool bGrew)
+{
+	--Outstanding;
+
+	if (bGrew)
+	{
+		++NumGrown;
+		INC_DWORD_STAT(STAT_BotwScratchArraysGrown);
+	}
+}
+
+uint32 BotwFrameScratch::GetNumGrown()
+{
+	return NumGrown;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Game-thread scratch storage for per-tick query results.
+ * A TBotwScratchArray borrows an array for its scope and hands it back emptied with its capacity kept, so the query
+ * results of ticks in steady state are not allocated again. This only covers the scratch arrays: the engine's own
+ * queries, moves and RPCs allocate as they need. Temporaries that are not filled by engine APIs can use
+ * TArray<T, TMemStackAllocator<>> under an FMemMark instead. Every borrow must be returned by the end of the frame.
+ */
+namespace BotwFrameScratch
+{
+	/** Arrays grown past this many bytes are freed on return instead of being kept around for the next frame. */
+	constexpr SIZE_T MaxRetainedBytes = 64 * 1024;
+
+	BOTW_API void OnBorrow();
+
+	BOTW_API void OnReturn(bool bGrew);
+
+	/** Borrowed arrays that had to grow, since startup. Stays flat once every per-tick caller has warmed up. */
+	BOTW_API uint32 GetNumGrown();
+
+	template<typename ElementType>
+	struct TPool
+	{
+		TArray<TUniquePtr<TArray<ElementType>>> Free;
+
+		static TPool& Get()
+		{
+			static TPool Pool;
+			return Pool;
+		}
+	};
+}
+
+template<typename ElementType>
+class TBotwScratchArray
+{
+public:
+	TBotwScratchArray()
+	{
+		check(IsInGameThread());
+
+		TArray<TUniquePtr<TArray<ElementType>>>& Free = BotwFrameScratch::TPool<ElementType>::Get().Free;
+		Array = Free.IsEmpty() ? new TArray<ElementType>() : Free.Pop(EAllowShrinking::No).Release();
+		InitialMax = Array->Max();
+
+		BotwFrameScratch::OnBorrow();
+	}
+
+	~TBotwScratchArray()
+	{
+		BotwFrameScratch::OnReturn(Array->Max() > InitialMax);
+
+		if (Array->GetAllocatedSize() > BotwFrameScratch::MaxRetainedBytes)
+		{
+			Array->Empty();
+		}
+		else
+		{
+			Array->Reset();
+		}
+
+		BotwFrameScratch::TPool<ElementType>::Get().Free.Emplace(Array);
+	}
+
+	UE_NONCOPYABLE(TBotwScratchArray);
+
+	TArray<ElementType>& operator*() const { return *Array; }
+
+	TArray<ElementType>* operator->() const { return Array; }
+
+private:
+	TArray<ElementType>* Array;
+
+	int32 InitialMax;
+};
@@ -2,8 +2,31 @@
 
 #include "BotwGameMode.h"
 #include "BotwCharacter.h"
+#include "Bots/BotwBotPlayerController.h"
+#include "Bots/BotwLoadTestPlayerController.h"
+#include "Botw.h"
+#include "Combat/BotwCombatTargetSubsystem.h"
+#include "Profiling/BotwProfilingSubsystem.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "TimerManager.h"
 #include "UObject/ConstructorHelpers.h"
 
+CSV_DEFINE_CATEGORY(BotwServer, true);
+
+static TAutoConsoleVariable<float> CVarServerReportInterval(
+	TEXT("botw.Server.ReportInterval"),
+	30.f,
+	TEXT("Seconds between dedicated server load reports. 0 disables them."),
+	ECVF_Default);
+
 ABotwGameMode::ABotwGameMode()
 {
 	// set default pawn class to our Blueprinted character
@@ -12,4 +35,145 @@ ABotwGameMode::ABotwGameMode()
 	{
 		DefaultPawnClass = PlayerPawnBPClass.Class;
 	}
+
+	// only ticks on dedicated servers, to average the game thread time between load reports
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+}
+
+void ABotwGameMode::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage)
+{
+	Super::InitGame(MapName, Options, ErrorMessage);
+
+	// the profiling route is driven by a bot instead of input
+	if (UBotwProfilingSubsystem::IsProfilingRun())
+	{
+		PlayerControllerClass = ABotwBotPlayerController::StaticClass();
+	}
+}
+
+APlayerController* ABotwGameMode::SpawnPlayerController(ENetRole InRemoteRole, const FString& Options)
+{
+	// load test clients join with ?Bot=1 and are driven by a random bot on their side
+	if (UGameplayStatics::HasOption(Options, TEXT("Bot")))
+	{
+		TGuardValue<TSubclassOf<APlayerController>> BotControllerClass(PlayerControllerClass, ABotwLoadTestPlayerController::StaticClass());
+		return Super::SpawnPlayerController(InRemoteRole, Options);
+	}
+
+	return Super::SpawnPlayerController(InRemoteRole, Options);
+}
+
+void ABotwGameMode::StartPlay()
+{
+	Super::StartPlay();
+
+	const float ReportInterval = CVarServerReportInterval.GetValueOnGameThread();
+	if (GetNetMode() == NM_DedicatedServer && ReportInterval > 0.f)
+	{
+		BaselineUsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+		GetWorldTimerManager().SetTimer(ServerReportTimer, this, &ABotwGameMode::ReportServerLoad, ReportInterval, true);
+
+		FParse::Value(FCommandLine::Get(), TEXT("BotwLoadReport="), LoadReportPath);
+		if (!LoadReportPath.IsEmpty())
+		{
+			FFileHelper::SaveStringToFile(TEXT("Seconds,Players,GameThreadMs,MaxGameThreadMs,UsedMB,MBPerPlayer,InKBpsPerConnection,OutKBpsPerConnection,MaxOutKBps,CorrectionsPerPlayerMinute\n"), *LoadReportPath);
+		}
+
+		SetActorTickEnabled(true);
+	}
+}
+
+void ABotwGameMode::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	const float GameThreadMs = FPlatformTime::ToMilliseconds(GGameThreadTime);
+	ReportGameThreadMs += GameThreadMs;
+	ReportMaxGameThreadMs = FMath::Max(ReportMaxGameThreadMs, GameThreadMs);
+	++ReportFrames;
+}
+
+void ABotwGameMode::ReportServerLoad()
+{
+	const FPlatformMemoryStats Memory = FPlatformMemory::GetStats();
+	const int32 NumPlayers = GetNumPlayers();
+	const float ReportSeconds = GetWorldTimerManager().GetTimerRate(ServerReportTimer);
+
+	const double UsedMB = Memory.UsedPhysical / (1024.0 * 1024.0);
+	const double PlayersMB = (double(Memory.UsedPhysical) - double(BaselineUsedPhysical)) / (1024.0 * 1024.0);
+	const float GameThreadMs = ReportFrames > 0 ? ReportGameThreadMs / ReportFrames : 0.f;
+	const float MaxGameThreadMs = ReportMaxGameThreadMs;
+	const float CpuPercent = FPlatformTime::GetCPUTime().CPUTimePct;
+	const int32 Corrections = ReportCorrections;
+
+	int32 Ragdolls = 0;
+	int32 RagdollBytes = 0;
+	if (UBotwCombatTargetSubsystem* CombatTargets = GetWorld()->GetSubsystem<UBotwCombatTargetSubsystem>())
+	{
+		CombatTargets->ConsumeRagdollStats(Ragdolls, RagdollBytes);
+	}
+	const int32 BytesPerRagdoll = Ragdolls > 0 ? RagdollBytes / Ragdolls : 0;
+
+	ReportGameThreadMs = 0.f;
+	ReportMaxGameThreadMs = 0.f;
+	ReportFrames = 0;
+	ReportCorrections = 0;
+
+	// bandwidth as measured by the connections themselves, averaged over the last second
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	float InKBps = 0.f;
+	float OutKBps = 0.f;
+	float MaxOutKBps = 0.f;
+	int32 NumConnections = 0;
+	if (NetDriver)
+	{
+		for (const UNetConnection* Connection : NetDriver->ClientConnections)
+		{
+			InKBps += Connection->InBytesPerSecond / 1024.f;
+			OutKBps += Connection->OutBytesPerSecond / 1024.f;
+			MaxOutKBps = FMath::Max(MaxOutKBps, Connection->OutBytesPerSecond / 1024.f);
+			++NumConnections;
+		}
+	}
+
+	const float InKBpsPerConnection = NumConnections > 0 ? InKBps / NumConnections : 0.f;
+	const float OutKBpsPerConnection = NumConnections > 0 ? OutKBps / NumConnections : 0.f;
+	const float CorrectionsPerPlayerMinute = NumPlayers > 0 && ReportSeconds > 0.f ? Corrections * 60.f / (NumPlayers * ReportSeconds) : 0.f;
+
+	CSV_CUSTOM_STAT(BotwServer, Players, NumPlayers, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(BotwServer, UsedMB, float(UsedMB), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(BotwServer, GameThreadMs, GameThreadMs, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(BotwServer, OutKBpsPerConnection, OutKBpsPerConnection, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(BotwServer, Corrections, Corrections, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(BotwServer, BytesPerRagdoll, BytesPerRagdoll, ECsvCustomStatOp::Set);
+
+	const double MBPerPlayer = NumPlayers > 0 ? FMath::Max(PlayersMB / NumPlayers, 1.0) : 0.0;
+
+	if (!LoadReportPath.IsEmpty())
+	{
+		const FString Row = FString::Printf(TEXT("%.0f,%d,%.3f,%.3f,%.0f,%.1f,%.2f,%.2f,%.2f,%.2f\n"), GetWorld()->GetTimeSeconds(),
+			NumPlayers, GameThreadMs, MaxGameThreadMs, UsedMB, MBPerPlayer, InKBpsPerConnection, OutKBpsPerConnection, MaxOutKBps,
+			CorrectionsPerPlayerMinute);
+		FFileHelper::SaveStringToFile(Row, *LoadReportPath, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+	}
+
+	if (NumPlayers == 0)
+	{
+		UE_LOG(LogBotw, Log, TEXT("Server load: no players, %.0f MB used, game thread %.2f ms, CPU %.1f%%"), UsedMB, GameThreadMs, CpuPercent);
+		return;
+	}
+
+	const float GameThreadMsPerPlayer = GameThreadMs / NumPlayers;
+
+	// Rough capacity: whichever runs out first, the memory left on the box or the game thread budget at the server tick rate.
+	const float TickBudgetMs = 1000.f / FMath::Max(1, NetDriver ? NetDriver->GetNetServerMaxTickRate() : 30);
+	const int32 MemoryCapacity = NumPlayers + FMath::FloorToInt(Memory.AvailablePhysical / (1024.0 * 1024.0) / MBPerPlayer);
+	const int32 CpuCapacity = GameThreadMsPerPlayer > 0.f ? FMath::FloorToInt(TickBudgetMs / GameThreadMsPerPlayer) : MAX_int32;
+
+	UE_LOG(LogBotw, Log, TEXT("Server load: %d players, %.0f MB used (%.1f MB per player), game thread %.2f ms (%.3f ms per player), ")
+		TEXT("CPU %.1f%%, %.1f/%.1f KB/s in/out per connection, %d corrections, %d ragdolls at %d bytes each; ")
+		TEXT("room for about %d players (memory %d, game thread %d)"),
+		NumPlayers, UsedMB, MBPerPlayer, GameThreadMs, GameThreadMsPerPlayer, CpuPercent, InKBpsPerConnection, OutKBpsPerConnection,
+		Corrections, Ragdolls, BytesPerRagdoll, FMath::Min(MemoryCapacity, CpuCapacity), MemoryCapacity, CpuCapacity);
 }
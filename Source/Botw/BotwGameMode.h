@@ -13,6 +13,39 @@ class ABotwGameMode : public AGameModeBase
 
 public:
 	ABotwGameMode();
+
+	virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
+
+	virtual APlayerController* SpawnPlayerController(ENetRole InRemoteRole, const FString& Options) override;
+
+	virtual void StartPlay() override;
+
+	virtual void Tick(float DeltaSeconds) override;
+
+	/** Counts a position correction the server sent to a client, for the load report. */
+	void AddMovementCorrection() { ++ReportCorrections; }
+
+private:
+	/**
+	 * Logs memory, game thread time, bandwidth and movement corrections per connected player on dedicated servers;
+	 * see botw.Server.ReportInterval. With -BotwLoadReport=<file>, also appends them to that CSV file.
+	 */
+	void ReportServerLoad();
+
+	FTimerHandle ServerReportTimer;
+
+	/** Memory in use before any player joined. */
+	uint64 BaselineUsedPhysical = 0;
+
+	FString LoadReportPath;
+
+	float ReportGameThreadMs = 0.f;
+
+	float ReportMaxGameThreadMs = 0.f;
+
+	int32 ReportFrames = 0;
+
+	int32 ReportCorrections = 0;
 };
 
 
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DeveloperSettings.h"
+#include "BotwSceneQuery.h"
+#include "BotwQueryBudgetSettings.generated.h"
+
+/**
+ * Scene queries one character may issue per frame in each state, checked by FBotwQueryCounter and scaled by
+ * botw.QueryBudget.Scale. Each is roughly 1.5x what the state issues; Botw.SceneQueries.Budgets drives every state
+ * and fails when one goes over.
+ */
+UCLASS(config = Game, defaultconfig, meta = (DisplayName = "Botw Query Budgets"))
+class BOTW_API UBotwQueryBudgetSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+	int32 GetBudget(EBotwQueryBudgetState State) const
+	{
+		switch (State)
+		{
+		case EBotwQueryBudgetState::Walking:			return Walking;
+		case EBotwQueryBudgetState::ClimbingIdle:		return ClimbingIdle;
+		case EBotwQueryBudgetState::ClimbingMoving:		return ClimbingMoving;
+		case EBotwQueryBudgetState::ClimbDashing:		return ClimbDashing;
+		case EBotwQueryBudgetState::LedgeUp:			return LedgeUp;
+		case EBotwQueryBudgetState::Punching:			return Punching;
+		case EBotwQueryBudgetState::Gliding:			return Gliding;
+		default:										return 0;
+		}
+	}
+
+	/** The wall sweep, when the character moved or turned enough to probe the wall contacts again. */
+	UPROPERTY(config, EditAnywhere, Category = "Budgets", meta = (ClampMin = "0"))
+	int32 Walking = 3;
+
+	/** The wall sweep, an assist sweep per wall contact, the floor trace, the move and the snap onto the wall. */
+	UPROPERTY(config, EditAnywhere, Category = "Budgets", meta = (ClampMin = "0"))
+	int32 ClimbingIdle = 10;
+
+	/** As idle, plus the eye-height trace for the top of the wall and, once it is reached, the ledge checks. */
+	UPROPERTY(config, EditAnywhere, Category = "Budgets", meta = (ClampMin = "0"))
+	int32 ClimbingMoving = 14;
+
+	/** As moving, with the dash split into moves that each find the wall again. */
+	UPROPERTY(config, EditAnywhere, Category = "Budgets", meta = (ClampMin = "0"))
+	int32 ClimbDashing = 16;
+
+	/** The ledge-up moves without sweeping; the frame it starts in also has the climbing checks that led to it. */
+	UPROPERTY(config, EditAnywhere, Category = "Budgets", meta = (ClampMin = "0"))
+	int32 LedgeUp = 10;
+
+	/** Added to the budget of whatever the character does while a punch window is open. */
+	UPROPERTY(config, EditAnywhere, Category = "Budgets", meta = (ClampMin = "0"))
+	int32 Punching = 2;
+
+	/** At most one ground sample for the ground-height cache, the trace close to the ground, and the move. */
+	UPROPERTY(config, EditAnywhere, Category = "Budgets", meta = (ClampMin = "0"))
+	int32 Gliding = 4;
+};
@@ -0,0 +1,191 @@
+#include "BotwSceneQuery.h"
+#include "Botw.h"
+#include "BotwQueryBudgetSettings.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Components/PrimitiveComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Scene queries"), STAT_BotwSceneQueries, STATGROUP_Botw);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Query budget violations"), STAT_BotwQueryBudgetViolations, STATGROUP_Botw);
+
+static TAutoConsoleVariable<int32> CVarQueryBudgetEnforce(
+	TEXT("botw.QueryBudget.Enforce"),
+	1,
+	TEXT("0: off, 1: warn when a character exceeds its per-frame scene-query budget, 2: log an error.\n")
+	TEXT("Violations are always errors while automation tests run, so they fail the run."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarQueryBudgetScale(
+	TEXT("botw.QueryBudget.Scale"),
+	1.f,
+	TEXT("Multiplier applied to every per-state scene-query budget."),
+	ECVF_Default);
+
+namespace BotwSceneQuery
+{
+	static const TCHAR* StateNames[static_cast<int32>(EBotwQueryBudgetState::Num)] =
+	{
+		TEXT("Walking"),
+		TEXT("ClimbingIdle"),
+		TEXT("ClimbingMoving"),
+		TEXT("ClimbDashing"),
+		TEXT("LedgeUp"),
+		TEXT("Punching"),
+		TEXT("Gliding"),
+	};
+}
+
+FBotwQueryCounter::FScopedQuery::FScopedQuery(FBotwQueryCounter& InCounter)
+	: Counter(InCounter)
+	, StartCycles(FPlatformTime::Cycles64())
+{
+	Counter.BeginFrame();
+}
+
+FBotwQueryCounter::FScopedQuery::~FScopedQuery()
+{
+	Counter.Cycles += FPlatformTime::Cycles64() - StartCycles;
+	++Counter.Queries;
+	++Counter.TotalQueries;
+
+	INC_DWORD_STAT(STAT_BotwSceneQueries);
+}
+
+int32 FBotwQueryCounter::GetBudget(EBotwQueryBudgetState State)
+{
+	return FMath::CeilToInt(GetDefault<UBotwQueryBudgetSettings>()->GetBudget(State) * CVarQueryBudgetScale.GetValueOnGameThread());
+}
+
+void FBotwQueryCounter::BeginFrame()
+{
+	if (Frame == GFrameCounter)
+	{
+		return;
+	}
+
+#if !UE_BUILD_SHIPPING
+	if (Frame + 1 == GFrameCounter)
+	{
+		CheckBudget();
+	}
+#endif
+
+	LastFrameQueries = Frame + 1 == GFrameCounter ? Queries : 0;
+	LastFrameCycles = Frame + 1 == GFrameCounter ? Cycles : 0;
+	LastFrameStateMask = Frame + 1 == GFrameCounter ? StateMask : 0;
+	LastFrameSimulationSteps = Frame + 1 == GFrameCounter ? SimulationSteps : 1;
+
+	Frame = GFrameCounter;
+	Queries = 0;
+	Cycles = 0;
+	StateMask = 0;
+	SimulationSteps = 1;
+}
+
+void FBotwQueryCounter::AddState(EBotwQueryBudgetState State)
+{
+	BeginFrame();
+
+	StateMask |= 1 << static_cast<uint8>(State);
+}
+
+void FBotwQueryCounter::SetSimulationSteps(int32 Steps)
+{
+	BeginFrame();
+
+	SimulationSteps = FMath::Max(SimulationSteps, Steps);
+}
+
+void FBotwQueryCounter::CheckBudget() const
+{
+	const int32 EnforceMode = CVarQueryBudgetEnforce.GetValueOnGameThread();
+	if (EnforceMode <= 0 || StateMask == 0)
+	{
+		return;
+	}
+
+	// States that overlap in one frame (punching while walking, or a climb starting) each contribute their allowance.
+	int32 Budget = 0;
+	FString States;
+	for (int32 Index = 0; Index < static_cast<int32>(EBotwQueryBudgetState::Num); ++Index)
+	{
+		if (StateMask & (1 << Index))
+		{
+			Budget += GetBudget(static_cast<EBotwQueryBudgetState>(Index));
+			const TCHAR* StateName = BotwSceneQuery::GetStateName(static_cast<EBotwQueryBudgetState>(Index));
+			States += States.IsEmpty() ? StateName : FString(TEXT("+")) + StateName;
+		}
+	}
+
+	Budget *= SimulationSteps;
+
+	if (Queries <= Budget)
+	{
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_BotwQueryBudgetViolations);
+
+	if (GIsAutomationTesting || EnforceMode >= 2)
+	{
+		UE_LOG(LogBotw, Error, TEXT("%s issued %d scene queries in one frame (%s), budget is %d"),
+			*GetNameSafe(Owner.Get()), Queries, *States, Budget);
+	}
+	else
+	{
+		UE_LOG(LogBotw, Warning, TEXT("%s issued %d scene queries in one frame (%s), budget is %d"),
+			*GetNameSafe(Owner.Get()), Queries, *States, Budget);
+	}
+}
+
+const TCHAR* BotwSceneQuery::GetStateName(EBotwQueryBudgetState State)
+{
+	return StateNames[static_cast<int32>(State)];
+}
+
+bool BotwSceneQuery::LineTraceSingle(FBotwQueryCounter& Counter, const UWorld* World, FHitResult& OutHit,
+	const FVector& Start, const FVector& End, ECollisionChannel Channel, const FCollisionQueryParams& Params)
+{
+	FBotwQueryCounter::FScopedQuery Scope(Counter);
+
+	return World->LineTraceSingleByChannel(OutHit, Start, End, Channel, Params);
+}
+
+bool BotwSceneQuery::SweepSingle(FBotwQueryCounter& Counter, const UWorld* World, FHitResult& OutHit,
+	const FVector& Start, const FVector& End, const FQuat& Rotation, ECollisionChannel Channel,
+	const FCollisionShape& Shape, const FCollisionQueryParams& Params)
+{
+	FBotwQueryCounter::FScopedQuery Scope(Counter);
+
+	return World->SweepSingleByChannel(OutHit, Start, End, Rotation, Channel, Shape, Params);
+}
+
+bool BotwSceneQuery::SweepMulti(FBotwQueryCounter& Counter, const UWorld* World, TArray<FHitResult>& OutHits,
+	const FVector& Start, const FVector& End, const FQuat& Rotation, ECollisionChannel Channel,
+	const FCollisionShape& Shape, const FCollisionQueryParams& Params)
+{
+	FBotwQueryCounter::FScopedQuery Scope(Counter);
+
+	return World->SweepMultiByChannel(OutHits, Start, End, Rotation, Channel, Shape, Params);
+}
+
+void BotwSceneQuery::GetOverlappingActors(FBotwQueryCounter& Counter, const AActor* Actor, TArray<AActor*>& OutActors)
+{
+	FBotwQueryCounter::FScopedQuery Scope(Counter);
+
+	// Same result as AActor::GetOverlappingActors, without the temporary set it builds per component.
+	OutActors.Reset();
+	Actor->ForEachComponent<UPrimitiveComponent>(false, [Actor, &OutActors](const UPrimitiveComponent* Component)
+	{
+		for (const FOverlapInfo& Overlap : Component->GetOverlapInfos())
+		{
+			AActor* OverlappingActor = Overlap.OverlapInfo.GetActor();
+			if (IsValid(OverlappingActor) && OverlappingActor != Actor)
+			{
+				OutActors.AddUnique(OverlappingActor);
+			}
+		}
+	});
+}
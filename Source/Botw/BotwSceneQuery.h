@@ -0,0 +1,128 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CoreGlobals.h"
+#include "CollisionQueryParams.h"
+#include "CollisionShape.h"
+#include "Engine/EngineTypes.h"
+
+class AActor;
+class UWorld;
+
+/** What a character was doing in a frame; each state has its own scene-query allowance. */
+enum class EBotwQueryBudgetState : uint8
+{
+	Walking,
+	ClimbingIdle,
+	ClimbingMoving,
+	ClimbDashing,
+	LedgeUp,
+	Punching,
+	Gliding,
+	Num
+};
+
+/**
+ * Counts the scene queries one character issues per frame and checks them against the budget of the states
+ * it was in. Budgets are checked when the next frame starts; see botw.QueryBudget.Enforce.
+ */
+struct BOTW_API FBotwQueryCounter
+{
+	/** Counts and times one query for the lifetime of the scope. */
+	struct FScopedQuery
+	{
+		explicit FScopedQuery(FBotwQueryCounter& InCounter);
+		~FScopedQuery();
+
+	private:
+		FBotwQueryCounter& Counter;
+		uint64 StartCycles;
+	};
+
+	void SetOwner(const UObject* InOwner) { Owner = InOwner; }
+
+	/** Rolls over to the current frame, checking the previous one against its budget. */
+	void BeginFrame();
+
+	void AddState(EBotwQueryBudgetState State);
+
+	/** Movement substeps simulated this frame; each one gets the full allowance of the frame's states. */
+	void SetSimulationSteps(int32 Steps);
+
+	int32 GetQueriesThisFrame() const { return Frame == GFrameCounter ? Queries : 0; }
+
+	/** The last completed frame, which is stable whenever during the current frame it is read. */
+	int32 GetQueriesLastFrame() const
+	{
+		return Frame == GFrameCounter ? LastFrameQueries : Frame + 1 == GFrameCounter ? Queries : 0;
+	}
+
+	double GetSecondsThisFrame() const { return Frame == GFrameCounter ? FPlatformTime::ToSeconds64(Cycles) : 0.0; }
+
+	double GetSecondsLastFrame() const
+	{
+		return FPlatformTime::ToSeconds64(Frame == GFrameCounter ? LastFrameCycles : Frame + 1 == GFrameCounter ? Cycles : 0);
+	}
+
+	/** States of the last completed frame, one bit per EBotwQueryBudgetState; its budget is the sum of theirs. */
+	uint8 GetStateMaskLastFrame() const
+	{
+		return Frame == GFrameCounter ? LastFrameStateMask : Frame + 1 == GFrameCounter ? StateMask : 0;
+	}
+
+	/** Movement substeps of the last completed frame, which its budget was multiplied by. */
+	int32 GetSimulationStepsLastFrame() const
+	{
+		return Frame == GFrameCounter ? LastFrameSimulationSteps : Frame + 1 == GFrameCounter ? SimulationSteps : 1;
+	}
+
+	/** Every query counted so far; the difference of two reads is what was issued in between. */
+	uint32 GetTotalQueries() const { return TotalQueries; }
+
+	/** Allowance per frame and simulation step, from UBotwQueryBudgetSettings. */
+	static int32 GetBudget(EBotwQueryBudgetState State);
+
+private:
+	void CheckBudget() const;
+
+	TWeakObjectPtr<const UObject> Owner;
+
+	uint64 Frame = 0;
+
+	uint64 Cycles = 0;
+
+	int32 Queries = 0;
+
+	int32 LastFrameQueries = 0;
+
+	uint32 TotalQueries = 0;
+
+	uint64 LastFrameCycles = 0;
+
+	uint8 StateMask = 0;
+
+	uint8 LastFrameStateMask = 0;
+
+	int32 SimulationSteps = 1;
+
+	int32 LastFrameSimulationSteps = 1;
+};
+
+/** Counting wrappers for every scene query the Botw characters issue. */
+namespace BotwSceneQuery
+{
+	BOTW_API const TCHAR* GetStateName(EBotwQueryBudgetState State);
+
+	BOTW_API bool LineTraceSingle(FBotwQueryCounter& Counter, const UWorld* World, FHitResult& OutHit, const FVector& Start,
+		const FVector& End, ECollisionChannel Channel, const FCollisionQueryParams& Params);
+
+	BOTW_API bool SweepSingle(FBotwQueryCounter& Counter, const UWorld* World, FHitResult& OutHit, const FVector& Start,
+		const FVector& End, const FQuat& Rotation, ECollisionChannel Channel, const FCollisionShape& Shape,
+		const FCollisionQueryParams& Params);
+
+	BOTW_API bool SweepMulti(FBotwQueryCounter& Counter, const UWorld* World, TArray<FHitResult>& OutHits, const FVector& Start,
+		const FVector& End, const FQuat& Rotation, ECollisionChannel Channel, const FCollisionShape& Shape,
+		const FCollisionQueryParams& Params);
+
+	BOTW_API void GetOverlappingActors(FBotwQueryCounter& Counter, const AActor* Actor, TArray<AActor*>& OutActors);
+}
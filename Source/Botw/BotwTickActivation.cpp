@@ -0,0 +1,134 @@
+#include "BotwTickActivation.h"
+#include "Botw.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+
+static FAutoConsoleCommandWithWorldAndArgs CmdListTicking(
+	TEXT("botw.ListTicking"),
+	TEXT("botw.ListTicking [all]: logs the Botw actors that tick and why. 'all' also lists the idle ones."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (!World)
+		{
+			return;
+		}
+
+		const bool bListIdle = Args.Num() > 0 && Args[0] == TEXT("all");
+		int32 NumTicking = 0;
+		int32 NumIdle = 0;
+
+		for (TActorIterator<AActor> It(World); It; ++It)
+		{
+			AActor* Actor = *It;
+
+			const UClass* NativeClass = Actor->GetClass();
+			while (NativeClass && !NativeClass->HasAnyClassFlags(CLASS_Native))
+			{
+				NativeClass = NativeClass->GetSuperClass();
+			}
+
+			if (!NativeClass || NativeClass->GetOutermost()->GetFName() != TEXT("/Script/Botw"))
+			{
+				continue;
+			}
+
+			IBotwTickActivated* TickActivated = Cast<IBotwTickActivated>(Actor);
+			const bool bTicking = Actor->IsActorTickEnabled();
+			const FString Reason = TickActivated ? LexToString(TickActivated->GetTickActivation().GetReasons()) : TEXT("always");
+
+			bTicking ? ++NumTicking : ++NumIdle;
+			if (bTicking || bListIdle)
+			{
+				UE_LOG(LogBotw, Display, TEXT("%-40s %-7s %s"), *Actor->GetName(), bTicking ? TEXT("ticking") : TEXT("idle"), *Reason);
+			}
+		}
+
+		UE_LOG(LogBotw, Display, TEXT("%d Botw actors ticking, %d idle"), NumTicking, NumIdle);
+	}));
+
+FString LexToString(EBotwTickReason Reasons)
+{
+	if (Reasons == EBotwTickReason::None)
+	{
+		return TEXT("none");
+	}
+
+	TArray<FString, TInlineAllocator<4>> Names;
+	if (EnumHasAnyFlags(Reasons, EBotwTickReason::Blueprint))
+	{
+		Names.Add(TEXT("Blueprint"));
+	}
+	if (EnumHasAnyFlags(Reasons, EBotwTickReason::Punch))
+	{
+		Names.Add(TEXT("Punch"));
+	}
+	if (EnumHasAnyFlags(Reasons, EBotwTickReason::Pursuit))
+	{
+		Names.Add(TEXT("Pursuit"));
+	}
+	if (EnumHasAnyFlags(Reasons, EBotwTickReason::Focus))
+	{
+		Names.Add(TEXT("Focus"));
+	}
+
+	return FString::Join(Names, TEXT("|"));
+}
+
+void FBotwTickActivation::Init(AActor& InOwner)
+{
+	Owner = &InOwner;
+
+	static const FName ReceiveTickName(TEXT("ReceiveTick"));
+	if (InOwner.GetClass()->IsFunctionImplementedInScript(ReceiveTickName))
+	{
+		Reasons |= EBotwTickReason::Blueprint;
+	}
+
+	Refresh();
+}
+
+void FBotwTickActivation::Add(EBotwTickReason Reason)
+{
+	const bool bWasActive = Reasons != EBotwTickReason::None;
+	Reasons |= Reason;
+
+	if (!bWasActive)
+	{
+		Refresh();
+	}
+}
+
+void FBotwTickActivation::Remove(EBotwTickReason Reason)
+{
+	const bool bWasActive = Reasons != EBotwTickReason::None;
+	Reasons &= ~Reason;
+
+	if (bWasActive && Reasons == EBotwTickReason::None)
+	{
+		Refresh();
+	}
+}
+
+void FBotwTickActivation::Refresh()
+{
+	AActor* Actor = Owner.Get();
+	if (!Actor)
+	{
+		return;
+	}
+
+	Actor->SetActorTickEnabled(Reasons != EBotwTickReason::None);
+}
+
+void BotwTickActivation::RestoreActorTick(AActor* Actor)
+{
+	if (IBotwTickActivated* TickActivated = Cast<IBotwTickActivated>(Actor))
+	{
+		TickActivated->GetTickActivation().Refresh();
+	}
+	else if (Actor)
+	{
+		Actor->SetActorTickEnabled(true);
+	}
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "BotwTickActivation.generated.h"
+
+/** Why an actor's tick is registered. Actors with no reason left do not tick at all. */
+enum class EBotwTickReason : uint8
+{
+	None = 0,
+	/** A Blueprint subclass implements Event Tick. */
+	Blueprint = 1 << 0,
+	/** The punch window between UMyAnimNotify_PunchStart and UMyAnimNotify_PunchEnd is open. */
+	Punch = 1 << 1,
+	/** An AI controller is chasing a target and may need to repath. */
+	Pursuit = 1 << 2,
+	/** An AI controller turns its pawn towards a focus. */
+	Focus = 1 << 3,
+};
+
+ENUM_CLASS_FLAGS(EBotwTickReason);
+
+BOTW_API FString LexToString(EBotwTickReason Reasons);
+
+/**
+ * Registers its actor's tick only while at least one reason needs it. Actors using it turn off
+ * PrimaryActorTick.bStartWithTickEnabled and call Init from BeginPlay.
+ */
+struct BOTW_API FBotwTickActivation
+{
+	void Init(AActor& InOwner);
+
+	void Add(EBotwTickReason Reason);
+
+	void Remove(EBotwTickReason Reason);
+
+	/** Reapplies the reasons, for code like the NPC pool that switched the tick by hand. */
+	void Refresh();
+
+	EBotwTickReason GetReasons() const { return Reasons; }
+
+private:
+	TWeakObjectPtr<AActor> Owner;
+
+	EBotwTickReason Reasons = EBotwTickReason::None;
+};
+
+UINTERFACE(MinimalAPI, meta = (CannotImplementInterfaceInBlueprint))
+class UBotwTickActivated : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/** Actors whose tick is driven by an FBotwTickActivation; botw.ListTicking shows their reasons. */
+class BOTW_API IBotwTickActivated
+{
+	GENERATED_BODY()
+
+public:
+	virtual FBotwTickActivation& GetTickActivation() = 0;
+};
+
+namespace BotwTickActivation
+{
+	/** Turns an actor's tick back on, or only as far as its reasons allow for IBotwTickActivated actors. */
+	BOTW_API void RestoreActorTick(AActor* Actor);
+}
@@ -0,0 +1,133 @@
+#include "BotwClimbContactManifold.h"
+#include "../Botw.h"
+#include "Components/PrimitiveComponent.h"
+#include "LandscapeHeightfieldCollisionComponent.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Climb probes"), STAT_BotwClimbProbes, STATGROUP_Botw);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Climb probes skipped"), STAT_BotwClimbProbesSkipped, STATGROUP_Botw);
+
+bool FBotwClimbContactManifold::NeedsProbe(const FVector& Location, const FQuat& Rotation, float DistanceTolerance,
+	float AngleToleranceDegrees, uint8 MaxAge) const
+{
+	if (!bProbed)
+	{
+		return true;
+	}
+
+	if (FVector::DistSquared(Location, ProbeLocation) > FMath::Square(DistanceTolerance))
+	{
+		return true;
+	}
+
+	if (ProbeRotation.AngularDistance(Rotation) > FMath::DegreesToRadians(AngleToleranceDegrees))
+	{
+		return true;
+	}
+
+	return ProbeAge >= MaxAge;
+}
+
+void FBotwClimbContactManifold::Update(TConstArrayView<FHitResult> Hits, const FVector& Location, const FQuat& Rotation)
+{
+	INC_DWORD_STAT(STAT_BotwClimbProbes);
+	++NumProbes;
+
+	static_assert(MaxContacts <= 32, "Contact masks are 32 bits");
+	uint32 FoundMask = 0;
+
+	// Multi sweeps return hits sorted by distance, so the closest walls win when the manifold is full.
+	for (const FHitResult& Hit : Hits)
+	{
+		const UPrimitiveComponent* Component = Hit.GetComponent();
+		const uint32 ComponentId = Component ? Component->GetUniqueID() : 0;
+
+		int32 Index = ComponentId != 0
+			? Contacts.IndexOfByPredicate([ComponentId](const FBotwClimbContact& Contact) { return Contact.ComponentId == ComponentId; })
+			: INDEX_NONE;
+
+		if (Index != INDEX_NONE && (FoundMask & (1u << Index)))
+		{
+			// A closer hit on the same component already refreshed it.
+			continue;
+		}
+
+		if (Index == INDEX_NONE)
+		{
+			if (Contacts.Num() < MaxContacts)
+			{
+				Index = Contacts.AddDefaulted();
+			}
+			else
+			{
+				// Full: the oldest contact this probe did not find makes room.
+				for (int32 Candidate = 0; Candidate < Contacts.Num(); ++Candidate)
+				{
+					if (!(FoundMask & (1u << Candidate)) && (Index == INDEX_NONE || Contacts[Candidate].Age > Contacts[Index].Age))
+					{
+						Index = Candidate;
+					}
+				}
+
+				if (Index == INDEX_NONE)
+				{
+					break;
+				}
+			}
+		}
+
+		FBotwClimbContact& Contact = Contacts[Index];
+		Contact.Position = FVector3f(Hit.ImpactPoint);
+		Contact.Normal = FVector3f(Hit.Normal);
+		Contact.ComponentId = ComponentId;
+		Contact.Age = 0;
+
+		const ULandscapeHeightfieldCollisionComponent* LandscapeComponent = Cast<ULandscapeHeightfieldCollisionComponent>(Component);
+		Contact.Landscape = LandscapeComponent ? LandscapeComponent->GetLandscapeProxy() : nullptr;
+
+		FoundMask |= 1u << Index;
+	}
+
+	ProbeLocation = Location;
+	ProbeRotation = Rotation;
+	ProbeAge = 0;
+	bProbed = true;
+}
+
+void FBotwClimbContactManifold::Keep()
+{
+	INC_DWORD_STAT(STAT_BotwClimbProbesSkipped);
+	++NumProbesSkipped;
+
+	ProbeAge = ProbeAge < MAX_uint8 ? ProbeAge + 1 : MAX_uint8;
+
+	for (FBotwClimbContact& Contact : Contacts)
+	{
+		Contact.Age = Contact.Age < MAX_uint8 ? Contact.Age + 1 : MAX_uint8;
+	}
+}
+
+void FBotwClimbContactManifold::Confirm(int32 Index, const FVector& Position, const FVector& Normal)
+{
+	FBotwClimbContact& Contact = Contacts[Index];
+	Contact.Position = FVector3f(Position);
+	Contact.Normal = FVector3f(Normal);
+	Contact.Age = 0;
+}
+
+void FBotwClimbContactManifold::Remove(uint32 ContactMask)
+{
+	// From the back, so the bits of the contacts not yet removed still match their indices.
+	for (int32 Index = Contacts.Num() - 1; Index >= 0; --Index)
+	{
+		if (ContactMask & (1u << Index))
+		{
+			Contacts.RemoveAt(Index, EAllowShrinking::No);
+		}
+	}
+}
+
+void FBotwClimbContactManifold::Invalidate()
+{
+	Contacts.Reset();
+	bProbed = false;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/HitResult.h"
+
+class ALandscapeProxy;
+
+/** One wall contact found by the climbing sweep, reduced to what the climbing code reads. */
+struct FBotwClimbContact
+{
+	FVector3f Position;
+
+	FVector3f Normal;
+
+	/** UObject unique id of the component hit, which matches the contact with the hits of later probes. */
+	uint32 ComponentId = 0;
+
+	/** Frames since a probe last found the contact. */
+	uint8 Age = 0;
+
+	/**
+	 * Landscape proxy the contact is on, whose heightfield can be sampled directly. Contacts at a seam between streaming
+	 * proxies are on different ones.
+	 */
+	TWeakObjectPtr<ALandscapeProxy> Landscape;
+};
+
+/**
+ * The climbable walls around a character, kept across frames.
+ * The wall sweep only runs again when the character moves or turns past a tolerance, or the last probe gets too old,
+ * so it runs when its result could have changed. Probes that found nothing age the same way, so walls that move in
+ * next to a standing character are still found.
+ * A probe is merged into the contacts rather than replacing them: hits on a component already in contact refresh that
+ * contact, and hits on other components are added. Contacts the probe missed are kept until they are probed on their
+ * own, with Confirm or Remove, so a sweep that grazes past a wall does not drop it.
+ */
+struct BOTW_API FBotwClimbContactManifold
+{
+	static constexpr int32 MaxContacts = 8;
+
+	/** Whether the contacts have to be probed again from this location and rotation. */
+	bool NeedsProbe(const FVector& Location, const FQuat& Rotation, float DistanceTolerance, float AngleToleranceDegrees,
+		uint8 MaxAge) const;
+
+	/** Merges the hits of a fresh probe into the contacts, closest first. */
+	void Update(TConstArrayView<FHitResult> Hits, const FVector& Location, const FQuat& Rotation);
+
+	/** Keeps the contacts, or the lack of them, for another frame without probing. */
+	void Keep();
+
+	/** The contact at Index was probed on its own and found at Position. */
+	void Confirm(int32 Index, const FVector& Position, const FVector& Normal);
+
+	/** Drops the contacts whose bit is set, bit 0 being the first contact; their walls are gone. */
+	void Remove(uint32 ContactMask);
+
+	/** Drops the contacts and forces a probe on the next update. */
+	void Invalidate();
+
+	bool IsEmpty() const { return Contacts.IsEmpty(); }
+
+	int32 Num() const { return Contacts.Num(); }
+
+	/** Probes run and skipped over the manifold's lifetime. */
+	uint32 GetNumProbes() const { return NumProbes; }
+
+	uint32 GetNumProbesSkipped() const { return NumProbesSkipped; }
+
+	const FBotwClimbContact* begin() const { return Contacts.GetData(); }
+
+	const FBotwClimbContact* end() const { return Contacts.GetData() + Contacts.Num(); }
+
+private:
+	TArray<FBotwClimbContact, TFixedAllocator<MaxContacts>> Contacts;
+
+	FVector ProbeLocation = FVector::ZeroVector;
+
+	FQuat ProbeRotation = FQuat::Identity;
+
+	/** Frames since the last probe. */
+	uint8 ProbeAge = 0;
+
+	uint32 NumProbes = 0;
+
+	uint32 NumProbesSkipped = 0;
+
+	bool bProbed = false;
+};
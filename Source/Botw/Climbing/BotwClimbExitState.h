@@ -0,0 +1,40 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Why a climb ends; checked at the start of every climbing substep. */
+enum class EBotwClimbExit : uint8
+{
+	None,
+	/** The character no longer wants to climb. */
+	Released,
+	/** No wall contacts are left to climb on. */
+	LostSurface,
+	Ceiling,
+	/** The character reached a walkable floor. */
+	Floor,
+};
+
+/**
+ * What the last floor trace of a climb found. With bSkipUnreachableFloorChecks the ground under the character is
+ * carried over between floor traces, so a character far up a wall does not trace for the floor until it drifts away
+ * from where it last looked or could have come down close to it.
+ */
+struct FBotwClimbExitState
+{
+	void Reset()
+	{
+		*this = FBotwClimbExitState();
+	}
+
+	/** Start of the last floor trace. */
+	FVector FloorCheckLocation = FVector::ZeroVector;
+
+	/** Height of the floor the last trace hit, if bGroundInRange. */
+	float GroundZ = 0.f;
+
+	/** Whether the last trace hit anything. If not, the ground was below its end, wherever that was. */
+	bool bGroundInRange = false;
+
+	bool bGroundKnown = false;
+};
@@ -0,0 +1,393 @@
+#include "BotwClimbKernels.h"
+#include "../Botw.h"
+#include "../MyCharacterMovementComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+
+namespace BotwClimbKernels
+{
+	static VectorRegister4Float Load(const FComponentArray& Component, int32 Index)
+	{
+		return VectorLoad(Component.GetData() + Index);
+	}
+
+	static void Store(const VectorRegister4Float& Value, FComponentArray& Component, int32 Index)
+	{
+		VectorStore(Value, Component.GetData() + Index);
+	}
+
+	static VectorRegister4Float CopySign(const VectorRegister4Float& Magnitude, const VectorRegister4Float& Sign)
+	{
+		return VectorSelect(VectorCompareGE(Sign, VectorZeroFloat()), Magnitude, VectorNegate(Magnitude));
+	}
+
+	/** Cosine and sine of half an angle from the cosine and sine of the angle, without trigonometry. */
+	static void GetHalfAngle(const VectorRegister4Float& Cos, const VectorRegister4Float& Sin, VectorRegister4Float& OutHalfCos,
+		VectorRegister4Float& OutHalfSin)
+	{
+		const VectorRegister4Float One = GlobalVectorConstants::FloatOne;
+		const VectorRegister4Float Half = GlobalVectorConstants::FloatOneHalf;
+
+		OutHalfCos = VectorSqrt(VectorMax(VectorMultiply(VectorAdd(One, Cos), Half), VectorZeroFloat()));
+		OutHalfSin = CopySign(VectorSqrt(VectorMax(VectorMultiply(VectorSubtract(One, Cos), Half), VectorZeroFloat())), Sin);
+	}
+}
+
+void BotwClimbKernels::EvaluateClimbStarts(const FVectorBatch& Facings, const FVectorBatch& Normals, float MaxHorizontalDegrees,
+	FScalarBatch& OutSteepness)
+{
+	check(Facings.Num() == Normals.Num());
+	OutSteepness.Init(Normals.Num());
+
+	const VectorRegister4Float MinCos = VectorSetFloat1(FMath::Cos(FMath::DegreesToRadians(MaxHorizontalDegrees)));
+	const VectorRegister4Float MinSizeSquared = VectorSetFloat1(UE_SMALL_NUMBER);
+	const VectorRegister4Float CeilingTolerance = VectorSetFloat1(UE_KINDA_SMALL_NUMBER);
+	const VectorRegister4Float NotClimbableSteepness = VectorSetFloat1(NotClimbable);
+
+	for (int32 Index = 0; Index < OutSteepness.Values.Num(); Index += NumLanes)
+	{
+		const VectorRegister4Float NormalX = Load(Normals.X, Index);
+		const VectorRegister4Float NormalY = Load(Normals.Y, Index);
+
+		const VectorRegister4Float HorizontalSizeSquared = VectorMultiplyAdd(NormalX, NormalX, VectorMultiply(NormalY, NormalY));
+		const VectorRegister4Float bHasHorizontal = VectorCompareGT(HorizontalSizeSquared, MinSizeSquared);
+		const VectorRegister4Float InvHorizontalSize = VectorReciprocalSqrt(VectorMax(HorizontalSizeSquared, MinSizeSquared));
+
+		// The normal dotted with its own horizontal direction is the length of its horizontal part.
+		const VectorRegister4Float Steepness = VectorSelect(bHasHorizontal, VectorMultiply(HorizontalSizeSquared, InvHorizontalSize),
+			VectorZeroFloat());
+
+		const VectorRegister4Float FacingDot = VectorMultiplyAdd(Load(Facings.X, Index), NormalX, VectorMultiply(Load(Facings.Y, Index), NormalY));
+		const VectorRegister4Float HorizontalCos = VectorNegate(VectorMultiply(FacingDot, InvHorizontalSize));
+
+		const VectorRegister4Float bClimbable = VectorBitwiseAnd(VectorCompareGE(HorizontalCos, MinCos),
+			VectorCompareGT(Steepness, CeilingTolerance));
+
+		Store(VectorSelect(bClimbable, Steepness, NotClimbableSteepness), OutSteepness.Values, Index);
+	}
+}
+
+void BotwClimbKernels::SafeNormalize(FVectorBatch& Vectors)
+{
+	const VectorRegister4Float MinSizeSquared = VectorSetFloat1(UE_SMALL_NUMBER);
+
+	for (int32 Index = 0; Index < Vectors.X.Num(); Index += NumLanes)
+	{
+		const VectorRegister4Float X = Load(Vectors.X, Index);
+		const VectorRegister4Float Y = Load(Vectors.Y, Index);
+		const VectorRegister4Float Z = Load(Vectors.Z, Index);
+
+		const VectorRegister4Float SizeSquared = VectorMultiplyAdd(X, X, VectorMultiplyAdd(Y, Y, VectorMultiply(Z, Z)));
+		const VectorRegister4Float bValid = VectorCompareGE(SizeSquared, MinSizeSquared);
+		const VectorRegister4Float Scale = VectorSelect(bValid, VectorReciprocalSqrt(VectorMax(SizeSquared, MinSizeSquared)),
+			VectorZeroFloat());
+
+		Store(VectorMultiply(X, Scale), Vectors.X, Index);
+		Store(VectorMultiply(Y, Scale), Vectors.Y, Index);
+		Store(VectorMultiply(Z, Scale), Vectors.Z, Index);
+	}
+}
+
+void BotwClimbKernels::AverageSurfaces(FVectorBatch& Positions, FVectorBatch& Normals, const FScalarBatch& NumContacts)
+{
+	check(Positions.Num() == NumContacts.Num() && Normals.Num() == NumContacts.Num());
+
+	const VectorRegister4Float One = GlobalVectorConstants::FloatOne;
+
+	for (int32 Index = 0; Index < Positions.X.Num(); Index += NumLanes)
+	{
+		const VectorRegister4Float Count = Load(NumContacts.Values, Index);
+		const VectorRegister4Float Scale = VectorSelect(VectorCompareGE(Count, One), VectorDivide(One, VectorMax(Count, One)), One);
+
+		Store(VectorMultiply(Load(Positions.X, Index), Scale), Positions.X, Index);
+		Store(VectorMultiply(Load(Positions.Y, Index), Scale), Positions.Y, Index);
+		Store(VectorMultiply(Load(Positions.Z, Index), Scale), Positions.Z, Index);
+	}
+
+	SafeNormalize(Normals);
+}
+
+void BotwClimbKernels::InterpolateClimbingRotations(FQuatBatch& Rotations, const FVectorBatch& Normals, const FScalarBatch& Alphas)
+{
+	check(Rotations.Num() == Normals.Num() && Rotations.Num() == Alphas.Num());
+
+	const VectorRegister4Float Zero = VectorZeroFloat();
+	const VectorRegister4Float One = GlobalVectorConstants::FloatOne;
+	const VectorRegister4Float MinSizeSquared = VectorSetFloat1(UE_SMALL_NUMBER);
+	// Below this angle FQuat::Slerp interpolates linearly, as sin(Omega) gets too small to divide by.
+	const VectorRegister4Float MaxSlerpCos = VectorSetFloat1(0.9999f);
+
+	for (int32 Index = 0; Index < Rotations.X.Num(); Index += NumLanes)
+	{
+		// The target faces into the wall, Direction: yaw and pitch towards it, then to a quaternion as FRotator does.
+		const VectorRegister4Float DirectionX = VectorNegate(Load(Normals.X, Index));
+		const VectorRegister4Float DirectionY = VectorNegate(Load(Normals.Y, Index));
+		const VectorRegister4Float DirectionZ = VectorNegate(Load(Normals.Z, Index));
+
+		const VectorRegister4Float HorizontalSizeSquared = VectorMultiplyAdd(DirectionX, DirectionX, VectorMultiply(DirectionY, DirectionY));
+		const VectorRegister4Float bHasYaw = VectorCompareGT(HorizontalSizeSquared, MinSizeSquared);
+		const VectorRegister4Float InvHorizontalSize = VectorReciprocalSqrt(VectorMax(HorizontalSizeSquared, MinSizeSquared));
+
+		// Straight up or down there is no yaw to take; MakeFromX then builds from the X axis, which turns facing up half around.
+		const VectorRegister4Float CosYaw = VectorSelect(bHasYaw, VectorMultiply(DirectionX, InvHorizontalSize),
+			CopySign(One, VectorNegate(DirectionZ)));
+		const VectorRegister4Float SinYaw = VectorSelect(bHasYaw, VectorMultiply(DirectionY, InvHorizontalSize), Zero);
+
+		const VectorRegister4Float SizeSquared = VectorMultiplyAdd(DirectionZ, DirectionZ, HorizontalSizeSquared);
+		const VectorRegister4Float bHasDirection = VectorCompareGE(SizeSquared, MinSizeSquared);
+		const VectorRegister4Float InvSize = VectorReciprocalSqrt(VectorMax(SizeSquared, MinSizeSquared));
+
+		const VectorRegister4Float CosPitch = VectorMultiply(VectorMultiply(HorizontalSizeSquared, InvHorizontalSize), InvSize);
+		const VectorRegister4Float SinPitch = VectorMultiply(DirectionZ, InvSize);
+
+		VectorRegister4Float CY, SY, CP, SP;
+		GetHalfAngle(CosYaw, SinYaw, CY, SY);
+		GetHalfAngle(CosPitch, SinPitch, CP, SP);
+
+		const VectorRegister4Float TargetX = VectorMultiply(SP, SY);
+		const VectorRegister4Float TargetY = VectorNegate(VectorMultiply(SP, CY));
+		const VectorRegister4Float TargetZ = VectorMultiply(CP, SY);
+		const VectorRegister4Float TargetW = VectorMultiply(CP, CY);
+
+		const VectorRegister4Float X = Load(Rotations.X, Index);
+		const VectorRegister4Float Y = Load(Rotations.Y, Index);
+		const VectorRegister4Float Z = Load(Rotations.Z, Index);
+		const VectorRegister4Float W = Load(Rotations.W, Index);
+
+		const VectorRegister4Float Alpha = VectorSelect(bHasDirection, Load(Alphas.Values, Index), Zero);
+
+		// FQuat::Slerp_NotNormalized.
+		const VectorRegister4Float RawCos = VectorMultiplyAdd(X, TargetX, VectorMultiplyAdd(Y, TargetY,
+			VectorMultiplyAdd(Z, TargetZ, VectorMultiply(W, TargetW))));
+		const VectorRegister4Float Cos = VectorAbs(RawCos);
+		const VectorRegister4Float bSlerp = VectorCompareLT(Cos, MaxSlerpCos);
+
+		const VectorRegister4Float Omega = VectorACos(VectorMin(Cos, MaxSlerpCos));
+		const VectorRegister4Float InvSin = VectorDivide(One, VectorSin(Omega));
+		const VectorRegister4Float InvAlpha = VectorSubtract(One, Alpha);
+
+		const VectorRegister4Float Scale0 = VectorSelect(bSlerp, VectorMultiply(VectorSin(VectorMultiply(InvAlpha, Omega)), InvSin), InvAlpha);
+		const VectorRegister4Float Scale1 = CopySign(
+			VectorSelect(bSlerp, VectorMultiply(VectorSin(VectorMultiply(Alpha, Omega)), InvSin), Alpha), RawCos);
+
+		const VectorRegister4Float ResultX = VectorMultiplyAdd(Scale0, X, VectorMultiply(Scale1, TargetX));
+		const VectorRegister4Float ResultY = VectorMultiplyAdd(Scale0, Y, VectorMultiply(Scale1, TargetY));
+		const VectorRegister4Float ResultZ = VectorMultiplyAdd(Scale0, Z, VectorMultiply(Scale1, TargetZ));
+		const VectorRegister4Float ResultW = VectorMultiplyAdd(Scale0, W, VectorMultiply(Scale1, TargetW));
+
+		// FQuat::GetNormalized, identity when there is nothing to normalize.
+		const VectorRegister4Float ResultSizeSquared = VectorMultiplyAdd(ResultX, ResultX, VectorMultiplyAdd(ResultY, ResultY,
+			VectorMultiplyAdd(ResultZ, ResultZ, VectorMultiply(ResultW, ResultW))));
+		const VectorRegister4Float bValid = VectorCompareGE(ResultSizeSquared, MinSizeSquared);
+		const VectorRegister4Float Scale = VectorSelect(bValid, VectorReciprocalSqrt(VectorMax(ResultSizeSquared, MinSizeSquared)), Zero);
+
+		Store(VectorMultiply(ResultX, Scale), Rotations.X, Index);
+		Store(VectorMultiply(ResultY, Scale), Rotations.Y, Index);
+		Store(VectorMultiply(ResultZ, Scale), Rotations.Z, Index);
+		Store(VectorSelect(bValid, VectorMultiply(ResultW, Scale), One), Rotations.W, Index);
+	}
+}
+
+namespace BotwClimbKernelBench
+{
+	constexpr int32 ContactsPerCharacter = 4;
+
+	/** Characters run through each kernel per measurement, whatever the batch size. */
+	constexpr int32 CharactersPerRun = 256 * 1024;
+
+	/** The per-character inputs in the layout of the movement component, and the same data as batches. */
+	struct FData
+	{
+		TArray<FVector> Facings;
+
+		TArray<FVector> Normals;
+
+		/** Sums of the contact normals of each character. */
+		TArray<FVector> NormalSums;
+
+		TArray<FVector> PositionSums;
+
+		TArray<FQuat> Rotations;
+
+		TArray<float> Alphas;
+
+		BotwClimbKernels::FVectorBatch FacingBatch;
+
+		BotwClimbKernels::FVectorBatch NormalBatch;
+
+		BotwClimbKernels::FVectorBatch NormalSumBatch;
+
+		BotwClimbKernels::FVectorBatch PositionBatch;
+
+		BotwClimbKernels::FQuatBatch RotationBatch;
+
+		BotwClimbKernels::FScalarBatch AlphaBatch;
+
+		BotwClimbKernels::FScalarBatch ContactBatch;
+	};
+
+	static FVector RandomWallNormal(FRandomStream& Random)
+	{
+		// Mostly walls, with some overhangs, slopes and ceilings.
+		return FVector(Random.FRandRange(-1.f, 1.f), Random.FRandRange(-1.f, 1.f), Random.FRandRange(-0.6f, 0.6f)).GetSafeNormal();
+	}
+
+	static void Generate(int32 NumCharacters, FData& Data)
+	{
+		FRandomStream Random(NumCharacters);
+		const int32 NumContacts = NumCharacters * ContactsPerCharacter;
+
+		Data.FacingBatch.Init(NumContacts);
+		Data.NormalBatch.Init(NumContacts);
+		for (int32 Index = 0; Index < NumContacts; ++Index)
+		{
+			const FVector Normal = RandomWallNormal(Random);
+			const FVector Facing = (-Normal.GetSafeNormal2D()).RotateAngleAxis(Random.FRandRange(-40.f, 40.f), FVector::UpVector);
+
+			Data.Normals.Add(Normal);
+			Data.Facings.Add(Facing);
+			Data.NormalBatch.Set(Index, FVector3f(Normal));
+			Data.FacingBatch.Set(Index, FVector3f(Facing));
+		}
+
+		Data.NormalSumBatch.Init(NumCharacters);
+		Data.PositionBatch.Init(NumCharacters);
+		Data.RotationBatch.Init(NumCharacters);
+		Data.AlphaBatch.Init(NumCharacters);
+		Data.ContactBatch.Init(NumCharacters);
+		for (int32 Index = 0; Index < NumCharacters; ++Index)
+		{
+			const FVector PositionSum = Random.GetUnitVector() * 200.f * ContactsPerCharacter;
+			const FQuat Rotation = FRotator(Random.FRandRange(-30.f, 30.f), Random.FRandRange(-180.f, 180.f), 0.f).Quaternion();
+			const float Alpha = Random.FRand();
+
+			FVector NormalSum = FVector::ZeroVector;
+			for (int32 Contact = 0; Contact < ContactsPerCharacter; ++Contact)
+			{
+				NormalSum += Data.Normals[Index * ContactsPerCharacter + Contact];
+			}
+
+			Data.NormalSums.Add(NormalSum);
+			Data.PositionSums.Add(PositionSum);
+			Data.Rotations.Add(Rotation);
+			Data.Alphas.Add(Alpha);
+			Data.NormalSumBatch.Set(Index, FVector3f(NormalSum));
+			Data.PositionBatch.Set(Index, FVector3f(PositionSum));
+			Data.RotationBatch.Set(Index, FQuat4f(Rotation));
+			Data.AlphaBatch[Index] = Alpha;
+			Data.ContactBatch[Index] = ContactsPerCharacter;
+		}
+	}
+
+	/** Runs Function over batches of a run and returns the nanoseconds per character. */
+	template<typename FunctionType>
+	static double Measure(int32 NumCharacters, FunctionType&& Function)
+	{
+		const int32 NumBatches = FMath::Max(1, CharactersPerRun / NumCharacters);
+
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		for (int32 Batch = 0; Batch < NumBatches; ++Batch)
+		{
+			Function();
+		}
+		const uint64 EndCycles = FPlatformTime::Cycles64();
+
+		return FPlatformTime::ToSeconds64(EndCycles - StartCycles) * 1e9 / (double(NumBatches) * NumCharacters);
+	}
+
+	static void Report(const TCHAR* Kernel, int32 NumCharacters, double ScalarNs, double BatchNs)
+	{
+		UE_LOG(LogBotw, Display, TEXT("%-16s %5d characters: scalar %7.1f ns, batch %7.1f ns per character (%.1fx)"),
+			Kernel, NumCharacters, ScalarNs, BatchNs, ScalarNs / FMath::Max(BatchNs, UE_DOUBLE_SMALL_NUMBER));
+	}
+
+	static void Run(int32 NumCharacters)
+	{
+		FData Data;
+		Generate(NumCharacters, Data);
+
+		const UMyCharacterMovementComponent* ClimbRules = GetDefault<UMyCharacterMovementComponent>();
+		const float MaxHorizontalDegrees = ClimbRules->GetMinHorizontalDegreesToStartClimbing();
+		const int32 NumContacts = NumCharacters * ContactsPerCharacter;
+
+		// CanStartClimbing: the surface test and steepness of every contact.
+		TArray<float> Steepness;
+		Steepness.SetNumZeroed(NumContacts);
+		const double ScalarStartNs = Measure(NumCharacters, [&]()
+		{
+			for (int32 Index = 0; Index < NumContacts; ++Index)
+			{
+				const FVector& Normal = Data.Normals[Index];
+				Steepness[Index] = ClimbRules->CanStartClimbingSurface(Data.Facings[Index], Normal)
+					? float(FVector::DotProduct(Normal, Normal.GetSafeNormal2D()))
+					: BotwClimbKernels::NotClimbable;
+			}
+		});
+
+		BotwClimbKernels::FScalarBatch SteepnessBatch;
+		const double BatchStartNs = Measure(NumCharacters, [&]()
+		{
+			BotwClimbKernels::EvaluateClimbStarts(Data.FacingBatch, Data.NormalBatch, MaxHorizontalDegrees, SteepnessBatch);
+		});
+
+		Report(TEXT("ClimbStart"), NumCharacters, ScalarStartNs, BatchStartNs);
+
+		// ComputeSurfaceInfo: averaging the assist hits of each character. The kernel works in place, so every run
+		// starts from a copy, in both paths.
+		TArray<FVector> Positions;
+		TArray<FVector> Normals;
+		const double ScalarSurfaceNs = Measure(NumCharacters, [&]()
+		{
+			Positions = Data.PositionSums;
+			Normals = Data.NormalSums;
+			for (int32 Index = 0; Index < NumCharacters; ++Index)
+			{
+				Positions[Index] /= ContactsPerCharacter;
+				Normals[Index] = Normals[Index].GetSafeNormal();
+			}
+		});
+
+		BotwClimbKernels::FVectorBatch PositionBatch;
+		BotwClimbKernels::FVectorBatch NormalBatch;
+		const double BatchSurfaceNs = Measure(NumCharacters, [&]()
+		{
+			PositionBatch = Data.PositionBatch;
+			NormalBatch = Data.NormalSumBatch;
+			BotwClimbKernels::AverageSurfaces(PositionBatch, NormalBatch, Data.ContactBatch);
+		});
+
+		Report(TEXT("SurfaceAverage"), NumCharacters, ScalarSurfaceNs, BatchSurfaceNs);
+
+		// GetClimbingRotation: turning each character towards its wall.
+		TArray<FQuat> Rotations;
+		Rotations.SetNumUninitialized(NumCharacters);
+		const double ScalarRotationNs = Measure(NumCharacters, [&]()
+		{
+			for (int32 Index = 0; Index < NumCharacters; ++Index)
+			{
+				const FQuat Target = FRotationMatrix::MakeFromX(-Data.NormalSums[Index]).ToQuat();
+				Rotations[Index] = FQuat::Slerp(Data.Rotations[Index], Target, Data.Alphas[Index]);
+			}
+		});
+
+		BotwClimbKernels::FQuatBatch RotationBatch;
+		const double BatchRotationNs = Measure(NumCharacters, [&]()
+		{
+			RotationBatch = Data.RotationBatch;
+			BotwClimbKernels::InterpolateClimbingRotations(RotationBatch, Data.NormalSumBatch, Data.AlphaBatch);
+		});
+
+		Report(TEXT("ClimbRotation"), NumCharacters, ScalarRotationNs, BatchRotationNs);
+	}
+}
+
+static FAutoConsoleCommand CmdClimbBenchKernels(
+	TEXT("botw.Climb.BenchKernels"),
+	TEXT("Times the batched climbing surface math against the scalar math for 1, 16 and 1000 characters and logs the results."),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		for (const int32 NumCharacters : {1, 16, 1000})
+		{
+			BotwClimbKernelBench::Run(NumCharacters);
+		}
+	}));
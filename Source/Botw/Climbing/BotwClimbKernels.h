@@ -0,0 +1,141 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BotwClimbContactManifold.h"
+
+/**
+ * Climbing surface math over batches of contacts or characters, four lanes at a time in the engine's vector registers.
+ * Batches keep one float array per component, padded with zeros to whole registers; padding lanes are computed along
+ * with the others and their results mean nothing. A batch of one character's contacts fits inline and does not
+ * allocate. Botw.Climbing.KernelsMatchScalar checks them against the scalar math; botw.Climb.BenchKernels times them.
+ * The movement component keeps the scalar math: its climbing update interleaves this math with scene queries one
+ * character at a time, and batches of a few contacts spend more on padding than the lanes save.
+ */
+namespace BotwClimbKernels
+{
+	constexpr int32 NumLanes = 4;
+
+	/** Steepness of contacts that cannot be climbed, see EvaluateClimbStarts. */
+	constexpr float NotClimbable = -1.f;
+
+	constexpr int32 GetPaddedNum(int32 Num)
+	{
+		return (Num + NumLanes - 1) / NumLanes * NumLanes;
+	}
+
+	using FComponentArray = TArray<float, TInlineAllocator<GetPaddedNum(FBotwClimbContactManifold::MaxContacts)>>;
+
+	struct FScalarBatch
+	{
+		void Init(int32 InNum)
+		{
+			NumValues = InNum;
+			Values.Reset();
+			Values.SetNumZeroed(GetPaddedNum(InNum));
+		}
+
+		int32 Num() const { return NumValues; }
+
+		float& operator[](int32 Index) { return Values[Index]; }
+
+		float operator[](int32 Index) const { return Values[Index]; }
+
+		FComponentArray Values;
+
+	private:
+		int32 NumValues = 0;
+	};
+
+	struct FVectorBatch
+	{
+		void Init(int32 InNum)
+		{
+			NumVectors = InNum;
+			for (FComponentArray* Component : {&X, &Y, &Z})
+			{
+				Component->Reset();
+				Component->SetNumZeroed(GetPaddedNum(InNum));
+			}
+		}
+
+		int32 Num() const { return NumVectors; }
+
+		void Set(int32 Index, const FVector3f& Vector)
+		{
+			X[Index] = Vector.X;
+			Y[Index] = Vector.Y;
+			Z[Index] = Vector.Z;
+		}
+
+		FVector3f Get(int32 Index) const { return FVector3f(X[Index], Y[Index], Z[Index]); }
+
+		FComponentArray X;
+
+		FComponentArray Y;
+
+		FComponentArray Z;
+
+	private:
+		int32 NumVectors = 0;
+	};
+
+	struct FQuatBatch
+	{
+		void Init(int32 InNum)
+		{
+			NumQuats = InNum;
+			for (FComponentArray* Component : {&X, &Y, &Z, &W})
+			{
+				Component->Reset();
+				Component->SetNumZeroed(GetPaddedNum(InNum));
+			}
+		}
+
+		int32 Num() const { return NumQuats; }
+
+		void Set(int32 Index, const FQuat4f& Quat)
+		{
+			X[Index] = Quat.X;
+			Y[Index] = Quat.Y;
+			Z[Index] = Quat.Z;
+			W[Index] = Quat.W;
+		}
+
+		FQuat4f Get(int32 Index) const { return FQuat4f(X[Index], Y[Index], Z[Index], W[Index]); }
+
+		FComponentArray X;
+
+		FComponentArray Y;
+
+		FComponentArray Z;
+
+		FComponentArray W;
+
+	private:
+		int32 NumQuats = 0;
+	};
+
+	/**
+	 * The surface test of UMyCharacterMovementComponent::CanStartClimbingSurface for each contact, approached facing
+	 * the matching entry of Facings. OutSteepness gets the steepness the eye-height check is scaled by, or NotClimbable.
+	 * Compares cosines instead of taking the arc cosine of every contact.
+	 */
+	BOTW_API void EvaluateClimbStarts(const FVectorBatch& Facings, const FVectorBatch& Normals, float MaxHorizontalDegrees,
+		FScalarBatch& OutSteepness);
+
+	/** FVector::GetSafeNormal of each vector, in place. */
+	BOTW_API void SafeNormalize(FVectorBatch& Vectors);
+
+	/**
+	 * Turns the sums of the assist hits of ComputeSurfaceInfo into the surface of each character: positions are divided
+	 * by the number of contacts they add up, normals are normalized. Characters without contacts are left as they are.
+	 */
+	BOTW_API void AverageSurfaces(FVectorBatch& Positions, FVectorBatch& Normals, const FScalarBatch& NumContacts);
+
+	/**
+	 * Slerps each rotation by the matching alpha towards facing into its climbing normal, with no roll, as
+	 * FQuat::Slerp(Rotation, FRotationMatrix::MakeFromX(-Normal).ToQuat(), Alpha) does. Rotations with a zero normal
+	 * are kept.
+	 */
+	BOTW_API void InterpolateClimbingRotations(FQuatBatch& Rotations, const FVectorBatch& Normals, const FScalarBatch& Alphas);
+}
@@ -0,0 +1,46 @@
+#include "BotwClimbProxyComponent.h"
+#include "../Botw.h"
+#include "PhysicsEngine/BodySetup.h"
+
+UBotwClimbProxyComponent::UBotwClimbProxyComponent(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	PrimaryComponentTick.bCanEverTick = false;
+
+	SetHiddenInGame(true);
+	SetCastShadow(false);
+	SetCanEverAffectNavigation(false);
+	SetGenerateOverlapEvents(false);
+	CanCharacterStepUpOn = ECB_No;
+
+	SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	SetCollisionObjectType(ECC_WorldStatic);
+	SetCollisionResponseToAllChannels(ECR_Ignore);
+	SetCollisionResponseToChannel(ECC_Climbable, ECR_Block);
+}
+
+void UBotwClimbProxyComponent::SetClimbBodySetup(UBodySetup* InBodySetup)
+{
+	ClimbBodySetup = InBodySetup;
+
+	if (IsRegistered())
+	{
+		RecreatePhysicsState();
+		UpdateBounds();
+	}
+}
+
+UBodySetup* UBotwClimbProxyComponent::GetBodySetup()
+{
+	return ClimbBodySetup;
+}
+
+FBoxSphereBounds UBotwClimbProxyComponent::CalcBounds(const FTransform& LocalToWorld) const
+{
+	if (ClimbBodySetup)
+	{
+		return FBoxSphereBounds(ClimbBodySetup->AggGeom.CalcAABB(LocalToWorld));
+	}
+
+	return FBoxSphereBounds(LocalToWorld.GetLocation(), FVector::ZeroVector, 0.f);
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/PrimitiveComponent.h"
+#include "BotwClimbProxyComponent.generated.h"
+
+class UBodySetup;
+
+/**
+ * Invisible, query-only collision that only blocks the Climbable channel.
+ * Stands in for a detailed mesh so climbing sweeps cost about as much as sweeping a box.
+ */
+UCLASS(ClassGroup = Collision, meta = (BlueprintSpawnableComponent))
+class BOTW_API UBotwClimbProxyComponent : public UPrimitiveComponent
+{
+	GENERATED_BODY()
+
+public:
+	UBotwClimbProxyComponent(const FObjectInitializer& ObjectInitializer);
+
+	void SetClimbBodySetup(UBodySetup* InBodySetup);
+
+	virtual UBodySetup* GetBodySetup() override;
+
+	virtual FBoxSphereBounds CalcBounds(const FTransform& LocalToWorld) const override;
+
+private:
+	UPROPERTY(Transient)
+	TObjectPtr<UBodySetup> ClimbBodySetup;
+};
@@ -0,0 +1,104 @@
+#include "BotwClimbProxySubsystem.h"
+#include "BotwClimbProxyComponent.h"
+#include "BotwClimbProxyUserData.h"
+#include "../Botw.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/Level.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+
+void UBotwClimbProxySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UBotwClimbProxySubsystem::OnLevelAddedToWorld);
+}
+
+void UBotwClimbProxySubsystem::Deinitialize()
+{
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+
+	Super::Deinitialize();
+}
+
+bool UBotwClimbProxySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UBotwClimbProxySubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	for (ULevel* Level : InWorld.GetLevels())
+	{
+		if (Level && Level->bIsVisible)
+		{
+			AddProxiesForLevel(Level);
+		}
+	}
+
+	UE_LOG(LogBotw, Log, TEXT("Climb proxies: %d spawned at begin play in %s"), NumProxies, *InWorld.GetName());
+}
+
+void UBotwClimbProxySubsystem::OnLevelAddedToWorld(ULevel* Level, UWorld* World)
+{
+	// Levels streamed in before BeginPlay are handled by OnWorldBeginPlay.
+	if (World == GetWorld() && World->HasBegunPlay())
+	{
+		AddProxiesForLevel(Level);
+	}
+}
+
+void UBotwClimbProxySubsystem::AddProxiesForLevel(ULevel* Level)
+{
+	if (!Level)
+	{
+		return;
+	}
+
+	TInlineComponentArray<UStaticMeshComponent*> MeshComponents;
+
+	for (AActor* Actor : Level->Actors)
+	{
+		if (!Actor)
+		{
+			continue;
+		}
+
+		Actor->GetComponents(MeshComponents);
+
+		for (UStaticMeshComponent* MeshComponent : MeshComponents)
+		{
+			// One proxy per instance would defeat the purpose; instanced meshes keep their own collision.
+			if (MeshComponent->IsA<UInstancedStaticMeshComponent>())
+			{
+				continue;
+			}
+
+			UStaticMesh* Mesh = MeshComponent->GetStaticMesh();
+			if (!Mesh || MeshComponent->GetCollisionResponseToChannel(ECC_Climbable) != ECR_Block)
+			{
+				continue;
+			}
+
+			const UBotwClimbProxyUserData* ProxyData = Mesh->GetAssetUserData<UBotwClimbProxyUserData>();
+			if (!ProxyData || !ProxyData->ClimbBodySetup)
+			{
+				continue;
+			}
+
+			UBotwClimbProxyComponent* Proxy = NewObject<UBotwClimbProxyComponent>(Actor);
+			Proxy->SetClimbBodySetup(ProxyData->ClimbBodySetup);
+			Proxy->SetMobility(MeshComponent->Mobility);
+			Proxy->SetupAttachment(MeshComponent);
+			Proxy->RegisterComponent();
+
+			MeshComponent->SetCollisionResponseToChannel(ECC_Climbable, ECR_Ignore);
+
+			++NumProxies;
+		}
+	}
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "BotwClimbProxySubsystem.generated.h"
+
+class ULevel;
+
+/**
+ * Spawns climb-collision proxies for every static mesh carrying a UBotwClimbProxyUserData,
+ * and stops the source mesh from answering Climbable queries so only the proxy is swept.
+ */
+UCLASS()
+class BOTW_API UBotwClimbProxySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	void OnLevelAddedToWorld(ULevel* Level, UWorld* World);
+
+	void AddProxiesForLevel(ULevel* Level);
+
+	FDelegateHandle LevelAddedHandle;
+
+	int32 NumProxies = 0;
+};
@@ -0,0 +1,2 @@
+#include "BotwClimbProxyUserData.h"
+#include "PhysicsEngine/BodySetup.h"
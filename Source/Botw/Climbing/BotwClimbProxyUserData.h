@@ -0,0 +1,39 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/AssetUserData.h"
+#include "BotwClimbProxyUserData.generated.h"
+
+class UBodySetup;
+
+/**
+ * Simplified climb collision attached to a static mesh by UBotwClimbCollisionCommandlet.
+ * At runtime UBotwClimbProxySubsystem spawns a UBotwClimbProxyComponent from it, so climbing
+ * queries hit a handful of boxes or hulls instead of the full-detail collision of the mesh.
+ */
+UCLASS()
+class BOTW_API UBotwClimbProxyUserData : public UAssetUserData
+{
+	GENERATED_BODY()
+
+public:
+	/** Box or convex proxy geometry, in mesh local space. Shared by every proxy component of this mesh. */
+	UPROPERTY(VisibleAnywhere, Instanced, Category = "Climbing")
+	TObjectPtr<UBodySetup> ClimbBodySetup;
+
+	/** Triangles the climbing sweeps had to consider before the proxy was generated. */
+	UPROPERTY(VisibleAnywhere, Category = "Climbing")
+	int32 SourceTriangleCount = 0;
+
+	/** Triangles of the generated proxy. */
+	UPROPERTY(VisibleAnywhere, Category = "Climbing")
+	int32 ProxyTriangleCount = 0;
+
+	/** Average cost of one climbing wall sweep against the source collision, in microseconds. */
+	UPROPERTY(VisibleAnywhere, Category = "Climbing")
+	float SourceSweepMicroseconds = 0.f;
+
+	/** Average cost of one climbing wall sweep against the proxy, in microseconds. */
+	UPROPERTY(VisibleAnywhere, Category = "Climbing")
+	float ProxySweepMicroseconds = 0.f;
+};
@@ -0,0 +1,122 @@
+#include "BotwLandscapeSampler.h"
+#include "../Botw.h"
+#include "LandscapeProxy.h"
+
+DECLARE_CYCLE_STAT(TEXT("Landscape surface sampling"), STAT_BotwLandscapeSampling, STATGROUP_Botw);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Landscape height samples"), STAT_BotwLandscapeHeightSamples, STATGROUP_Botw);
+
+namespace BotwLandscapeSampler
+{
+	constexpr int32 MaxSecantIterations = 4;
+
+	/** Secant refinement stops once the point is this close to the surface, in world units. */
+	constexpr float HeightTolerance = 0.5f;
+
+	static TOptional<float> GetHeight(const ALandscapeProxy& Landscape, const FVector& Location)
+	{
+		INC_DWORD_STAT(STAT_BotwLandscapeHeightSamples);
+
+		return Landscape.GetHeightAtLocation(Location, EHeightfieldSource::Complex);
+	}
+
+	/** Distance between heightfield samples in world units. */
+	static float GetQuadSize(const ALandscapeProxy& Landscape)
+	{
+		return Landscape.GetActorScale3D().X;
+	}
+}
+
+bool BotwLandscapeSampler::SampleSurface(const ALandscapeProxy& Landscape, const FVector& Location, float& OutHeight,
+	FVector& OutNormal)
+{
+	SCOPE_CYCLE_COUNTER(STAT_BotwLandscapeSampling);
+
+	const TOptional<float> Height = GetHeight(Landscape, Location);
+	if (!Height.IsSet())
+	{
+		return false;
+	}
+
+	// Half a quad apart, so the difference spans the quad the location is in.
+	const float Step = GetQuadSize(Landscape) * 0.5f;
+
+	const TOptional<float> PosX = GetHeight(Landscape, Location + FVector(Step, 0, 0));
+	const TOptional<float> NegX = GetHeight(Landscape, Location - FVector(Step, 0, 0));
+	const TOptional<float> PosY = GetHeight(Landscape, Location + FVector(0, Step, 0));
+	const TOptional<float> NegY = GetHeight(Landscape, Location - FVector(0, Step, 0));
+
+	// At the border of the landscape fall back to one-sided differences.
+	const float SlopeX = (PosX.Get(*Height) - NegX.Get(*Height)) / (Step * ((PosX.IsSet() ? 1 : 0) + (NegX.IsSet() ? 1 : 0)) + UE_SMALL_NUMBER);
+	const float SlopeY = (PosY.Get(*Height) - NegY.Get(*Height)) / (Step * ((PosY.IsSet() ? 1 : 0) + (NegY.IsSet() ? 1 : 0)) + UE_SMALL_NUMBER);
+
+	OutHeight = *Height;
+	OutNormal = FVector(-SlopeX, -SlopeY, 1.f).GetSafeNormal();
+	return true;
+}
+
+bool BotwLandscapeSampler::RayMarch(const ALandscapeProxy& Landscape, const FVector& Start, const FVector& End,
+	FVector& OutPosition, FVector& OutNormal)
+{
+	SCOPE_CYCLE_COUNTER(STAT_BotwLandscapeSampling);
+
+	const FVector Ray = End - Start;
+	const int32 NumSteps = FMath::Max(1, FMath::CeilToInt(Ray.Size() / (GetQuadSize(Landscape) * 0.5f)));
+
+	// Height of the ray above the heightfield; the surface is where it changes sign.
+	auto Clearance = [&Landscape, &Start, &Ray](float Alpha) -> TOptional<float>
+	{
+		const FVector Point = Start + Ray * Alpha;
+		const TOptional<float> Height = GetHeight(Landscape, Point);
+		return Height.IsSet() ? TOptional<float>(Point.Z - *Height) : TOptional<float>();
+	};
+
+	float PrevAlpha = 0.f;
+	TOptional<float> PrevClearance = Clearance(0.f);
+
+	for (int32 Step = 1; Step <= NumSteps; ++Step)
+	{
+		const float Alpha = static_cast<float>(Step) / NumSteps;
+		const TOptional<float> CurrClearance = Clearance(Alpha);
+
+		if (PrevClearance.IsSet() && CurrClearance.IsSet() && *PrevClearance >= 0.f && *CurrClearance < 0.f)
+		{
+			float Low = PrevAlpha;
+			float High = Alpha;
+			float LowClearance = *PrevClearance;
+			float HighClearance = *CurrClearance;
+			float HitAlpha = High;
+
+			for (int32 Iteration = 0; Iteration < MaxSecantIterations; ++Iteration)
+			{
+				HitAlpha = Low + (High - Low) * LowClearance / (LowClearance - HighClearance);
+
+				const TOptional<float> HitClearance = Clearance(HitAlpha);
+				if (!HitClearance.IsSet() || FMath::Abs(*HitClearance) <= HeightTolerance)
+				{
+					break;
+				}
+
+				if (*HitClearance > 0.f)
+				{
+					Low = HitAlpha;
+					LowClearance = *HitClearance;
+				}
+				else
+				{
+					High = HitAlpha;
+					HighClearance = *HitClearance;
+				}
+			}
+
+			OutPosition = Start + Ray * HitAlpha;
+
+			float Height;
+			return SampleSurface(Landscape, OutPosition, Height, OutNormal);
+		}
+
+		PrevAlpha = Alpha;
+		PrevClearance = CurrClearance;
+	}
+
+	return false;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class ALandscapeProxy;
+
+/**
+ * Reads climbing surfaces straight from the landscape collision heightfield instead of sweeping against it.
+ * Heights come from ALandscapeProxy::GetHeightAtLocation, normals from central differences of the heightfield,
+ * so they are the exact surface gradient rather than an average of sweep normals.
+ */
+namespace BotwLandscapeSampler
+{
+	/** Surface height and normal under Location. False outside the landscape collision. */
+	BOTW_API bool SampleSurface(const ALandscapeProxy& Landscape, const FVector& Location, float& OutHeight, FVector& OutNormal);
+
+	/** First point where the segment Start-End enters the heightfield, found by stepping and refining with the secant method. */
+	BOTW_API bool RayMarch(const ALandscapeProxy& Landscape, const FVector& Start, const FVector& End, FVector& OutPosition,
+		FVector& OutNormal);
+}
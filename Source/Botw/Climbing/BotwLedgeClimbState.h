@@ -0,0 +1,45 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Targets of a ledge-up, computed once from the checks that started it. The ledge-up montage's root motion is warped
+ * onto them: its vertical part is scaled to reach the top of the wall, its part along the facing to reach the spot on
+ * the ledge, and anything sideways is dropped. No scene queries are issued until the montage ends.
+ */
+struct FBotwLedgeClimbState
+{
+	void Reset()
+	{
+		*this = FBotwLedgeClimbState();
+	}
+
+	/** Where the character is once the montage root motion covered RootMotion, TimeAlpha of the way through. */
+	FVector GetWarpedLocation(const FVector& RootMotion, float TimeAlpha) const
+	{
+		// A montage without motion along an axis is spread over its length instead.
+		constexpr float MinRootMotion = 1.f;
+
+		const float UpAlpha = FMath::Abs(RootMotionUp) > MinRootMotion ? RootMotion.Z / RootMotionUp : TimeAlpha;
+		const float ForwardAlpha = FMath::Abs(RootMotionForward) > MinRootMotion
+			? FVector::DotProduct(RootMotion, Forward) / RootMotionForward
+			: TimeAlpha;
+
+		return Start + (WallTop - Start) * UpAlpha + (LedgeTop - WallTop) * ForwardAlpha;
+	}
+
+	FVector Start = FVector::ZeroVector;
+
+	/** Above Start, level with LedgeTop. */
+	FVector WallTop = FVector::ZeroVector;
+
+	/** Where the capsule stands on the ledge at the end. */
+	FVector LedgeTop = FVector::ZeroVector;
+
+	FVector Forward = FVector::ForwardVector;
+
+	/** Root motion of the whole montage, up and along Forward. */
+	float RootMotionUp = 0.f;
+
+	float RootMotionForward = 0.f;
+};
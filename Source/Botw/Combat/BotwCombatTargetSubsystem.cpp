@@ -0,0 +1,492 @@
+#include "BotwCombatTargetSubsystem.h"
+#include "BotwRagdollReplicator.h"
+#include "../Botw.h"
+#include "../Events/BotwEventBusSubsystem.h"
+#include "../Profiling/BotwFlightRecorder.h"
+#include "Animation/SkeletalMeshActor.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/GameStateBase.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Combat targets update"), STAT_BotwCombatTargetsUpdate, STATGROUP_Botw);
+DECLARE_CYCLE_STAT(TEXT("Combat target query"), STAT_BotwCombatTargetQuery, STATGROUP_Botw);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Combat targets"), STAT_BotwCombatTargets, STATGROUP_Botw);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Combat target candidates"), STAT_BotwCombatTargetCandidates, STATGROUP_Botw);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Ragdoll replication bytes"), STAT_BotwRagdollBytes, STATGROUP_Botw);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Ragdoll corrections"), STAT_BotwRagdollCorrections, STATGROUP_Botw);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Ragdoll snapshots over budget"), STAT_BotwRagdollSnapshotsOverBudget, STATGROUP_Botw);
+
+static TAutoConsoleVariable<float> CVarRagdollSnapshotInterval(
+	TEXT("botw.Ragdoll.SnapshotInterval"),
+	1.f,
+	TEXT("Seconds between the unreliable snapshots the server sends of each moving ragdoll."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarRagdollCorrectionDistance(
+	TEXT("botw.Ragdoll.CorrectionDistance"),
+	75.f,
+	TEXT("Clients snap a moving ragdoll to the server's once they are further apart than this. Settled ones always snap."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarRagdollMaxBytes(
+	TEXT("botw.Ragdoll.MaxBytesPerRagdoll"),
+	256,
+	TEXT("Bytes the server may send to each client for one ragdoll, as measured by the net driver. Snapshots that do not fit are dropped; the hit and the ")
+	TEXT("settle snapshot are always sent."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarRagdollMaxSeconds(
+	TEXT("botw.Ragdoll.MaxSeconds"),
+	10.f,
+	TEXT("A ragdoll still awake after this long is sent as settled where it is."),
+	ECVF_Default);
+
+namespace BotwCombatTargets
+{
+	/** About two character capsules across, so a punch looks at a handful of cells. */
+	constexpr float CellSize = 200.f;
+
+	constexpr float PunchImpulse = 10000.f;
+
+	constexpr float RagdollLinearDamping = 2.f;
+
+	constexpr float RagdollAngularDamping = 5.f;
+
+	static FIntVector GetCell(const FVector& Location)
+	{
+		return FIntVector(
+			FMath::FloorToInt(Location.X / CellSize),
+			FMath::FloorToInt(Location.Y / CellSize),
+			FMath::FloorToInt(Location.Z / CellSize));
+	}
+}
+
+bool UBotwCombatTargetSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UBotwCombatTargetSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UBotwCombatTargetSubsystem, STATGROUP_Tickables);
+}
+
+void UBotwCombatTargetSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	UWorld* World = GetWorld();
+	ActorSpawnedHandle = World->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &UBotwCombatTargetSubsystem::RegisterActor));
+	ActorDestroyedHandle = World->AddOnActorDestroyedHandler(FOnActorDestroyed::FDelegate::CreateUObject(this, &UBotwCombatTargetSubsystem::UnregisterActor));
+
+	if (UBotwEventBusSubsystem* EventBus = Collection.InitializeDependency<UBotwEventBusSubsystem>())
+	{
+		EventBus->OnEvents.AddUObject(this, &UBotwCombatTargetSubsystem::OnGameplayEvents);
+	}
+}
+
+void UBotwCombatTargetSubsystem::Deinitialize()
+{
+	UWorld* World = GetWorld();
+	World->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+	World->RemoveOnActorDestroyedHandler(ActorDestroyedHandle);
+
+	Targets.Empty();
+	TargetIndices.Empty();
+	Cells.Empty();
+	Replicator = nullptr;
+
+	SET_DWORD_STAT(STAT_BotwCombatTargets, 0);
+
+	Super::Deinitialize();
+}
+
+void UBotwCombatTargetSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// Actors loaded with the map were never spawned.
+	for (TActorIterator<AActor> It(&InWorld); It; ++It)
+	{
+		RegisterActor(*It);
+	}
+
+	const ENetMode NetMode = InWorld.GetNetMode();
+	if (NetMode == NM_DedicatedServer || NetMode == NM_ListenServer)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.ObjectFlags |= RF_Transient;
+
+		Replicator = InWorld.SpawnActor<ABotwRagdollReplicator>(SpawnParams);
+	}
+}
+
+void UBotwCombatTargetSubsystem::OnGameplayEvents(TConstArrayView<FBotwGameplayEvent> Events)
+{
+	for (const FBotwGameplayEvent& Event : Events)
+	{
+		if (Event.Type == EBotwGameplayEventType::PunchHit)
+		{
+			ApplyPunchHit(Event);
+		}
+	}
+}
+
+void UBotwCombatTargetSubsystem::ApplyPunchHit(const FBotwGameplayEvent& Event)
+{
+	// Clients punch too, for the animation, but only the server's hits count; they arrive through the replicator.
+	if (GetWorld()->GetNetMode() == NM_Client)
+	{
+		return;
+	}
+
+	FBotwRagdollHit Hit;
+	Hit.Target = Event.Target.Get();
+	Hit.Impulse = Event.Direction * BotwCombatTargets::PunchImpulse;
+	Hit.BoneIndex = INDEX_NONE;
+	Hit.ServerTime = GetServerTime();
+
+	if (!StartRagdoll(Hit.Target, Hit.Impulse, Hit.BoneIndex) || !Replicator)
+	{
+		return;
+	}
+
+	// A ragdoll hit again by a later swing is still the same ragdoll: it keeps the bytes already sent for it and the
+	// time it started, so botw.Ragdoll.MaxBytesPerRagdoll and botw.Ragdoll.MaxSeconds bound it as a whole.
+	FBotwCombatTarget& Target = Targets[TargetIndices.FindChecked(Event.Target)];
+	if (!Target.bReplicatingRagdoll)
+	{
+		++RagdollsStarted;
+		Target.bReplicatingRagdoll = true;
+		Target.RagdollBytes = 0;
+		Target.RagdollStartTime = Hit.ServerTime;
+		Target.NextRagdollSnapshotTime = Hit.ServerTime + CVarRagdollSnapshotInterval.GetValueOnGameThread();
+	}
+
+	CountRagdollBytes(Target, Replicator->MeasureHitBytes(Hit));
+	Replicator->SendHit(Hit);
+}
+
+bool UBotwCombatTargetSubsystem::StartRagdoll(AActor* Target, const FVector& Impulse, int32 BoneIndex)
+{
+	const int32* Index = TargetIndices.Find(Target);
+	USkeletalMeshComponent* Mesh = Index ? Targets[*Index].RagdollMesh.Get() : nullptr;
+	if (!Mesh)
+	{
+		return false;
+	}
+
+	if (!Mesh->IsSimulatingPhysics())
+	{
+		BotwFlightRecorder::Record(EBotwFlightEventType::Ragdoll, BotwFlightRecorder::GetObjectId(Target));
+		UE_LOG(LogBotw, Verbose, TEXT("Triggered ragdoll on %s"), *Target->GetName());
+		UBotwEventBusSubsystem::Push(EBotwGameplayEventType::Ragdoll, Target, nullptr, Mesh->GetComponentLocation());
+
+		Mesh->SetSimulatePhysics(true);
+	}
+
+	Mesh->SetAngularDamping(BotwCombatTargets::RagdollAngularDamping);
+	Mesh->SetLinearDamping(BotwCombatTargets::RagdollLinearDamping);
+	Mesh->AddImpulse(Impulse, BoneIndex != INDEX_NONE ? Mesh->GetBoneName(BoneIndex) : NAME_None, true);
+
+	return true;
+}
+
+void UBotwCombatTargetSubsystem::ReceiveRagdollHit(const FBotwRagdollHit& Hit)
+{
+	const int32* Index = TargetIndices.Find(Hit.Target.Get());
+	if (!Index || Hit.ServerTime < Targets[*Index].RagdollServerTime)
+	{
+		return;
+	}
+
+	Targets[*Index].RagdollServerTime = Hit.ServerTime;
+	StartRagdoll(Hit.Target, Hit.Impulse, Hit.BoneIndex);
+}
+
+void UBotwCombatTargetSubsystem::ReceiveRagdollSnapshot(const FBotwRagdollSnapshot& Snapshot)
+{
+	const int32* Index = TargetIndices.Find(Snapshot.Target.Get());
+	if (!Index)
+	{
+		return;
+	}
+
+	// Unreliable snapshots can arrive after a newer hit or after the settle snapshot.
+	FBotwCombatTarget& Target = Targets[*Index];
+	USkeletalMeshComponent* Mesh = Target.RagdollMesh.Get();
+	if (!Mesh || !Mesh->IsSimulatingPhysics() || Snapshot.ServerTime < Target.RagdollServerTime)
+	{
+		return;
+	}
+
+	Target.RagdollServerTime = Snapshot.ServerTime;
+
+	// The local simulation is left alone while it is close enough; the whole ragdoll moves with its root body.
+	const FVector Offset = Snapshot.Location - Mesh->GetComponentLocation();
+	if (Snapshot.bSettled || Offset.SizeSquared() > FMath::Square(CVarRagdollCorrectionDistance.GetValueOnGameThread()))
+	{
+		INC_DWORD_STAT(STAT_BotwRagdollCorrections);
+		Mesh->SetWorldLocation(Snapshot.Location, false, nullptr, ETeleportType::TeleportPhysics);
+	}
+
+	if (Snapshot.bSettled)
+	{
+		Mesh->PutAllRigidBodiesToSleep();
+	}
+}
+
+void UBotwCombatTargetSubsystem::UpdateRagdollReplication(FBotwCombatTarget& Target, float ServerTime)
+{
+	// Pooled NPCs that were released are put back together by UBotwNpcPoolSubsystem::Deactivate.
+	USkeletalMeshComponent* Mesh = Target.RagdollMesh.Get();
+	if (!Replicator || !Mesh->IsSimulatingPhysics())
+	{
+		Target.bReplicatingRagdoll = false;
+		return;
+	}
+
+	FBotwRagdollSnapshot Snapshot;
+	Snapshot.Target = Target.Actor.Get();
+	Snapshot.Location = Mesh->GetComponentLocation();
+	Snapshot.ServerTime = ServerTime;
+	Snapshot.bSettled = !Mesh->IsAnyRigidBodyAwake() ||
+		ServerTime - Target.RagdollStartTime > CVarRagdollMaxSeconds.GetValueOnGameThread();
+
+	if (Snapshot.bSettled)
+	{
+		CountRagdollBytes(Target, Replicator->MeasureSnapshotBytes(Snapshot));
+		Replicator->SendSnapshot(Snapshot);
+		Target.bReplicatingRagdoll = false;
+		return;
+	}
+
+	if (ServerTime < Target.NextRagdollSnapshotTime)
+	{
+		return;
+	}
+
+	Target.NextRagdollSnapshotTime = ServerTime + CVarRagdollSnapshotInterval.GetValueOnGameThread();
+
+	// Room is kept for the settle snapshot, which is sent whatever the budget.
+	const int32 SnapshotBytes = Replicator->MeasureSnapshotBytes(Snapshot);
+	if (Target.RagdollBytes + 2 * SnapshotBytes > CVarRagdollMaxBytes.GetValueOnGameThread())
+	{
+		INC_DWORD_STAT(STAT_BotwRagdollSnapshotsOverBudget);
+		return;
+	}
+
+	CountRagdollBytes(Target, SnapshotBytes);
+	Replicator->SendSnapshot(Snapshot);
+}
+
+void UBotwCombatTargetSubsystem::CountRagdollBytes(FBotwCombatTarget& Target, int32 MessageBytes)
+{
+	Target.RagdollBytes += MessageBytes;
+	RagdollBytesSent += MessageBytes;
+	INC_DWORD_STAT_BY(STAT_BotwRagdollBytes, MessageBytes);
+}
+
+void UBotwCombatTargetSubsystem::ConsumeRagdollStats(int32& OutRagdolls, int32& OutBytes)
+{
+	OutRagdolls = RagdollsStarted;
+	OutBytes = RagdollBytesSent;
+
+	RagdollsStarted = 0;
+	RagdollBytesSent = 0;
+}
+
+float UBotwCombatTargetSubsystem::GetServerTime() const
+{
+	const UWorld* World = GetWorld();
+	const AGameStateBase* GameState = World->GetGameState();
+	return float(GameState ? GameState->GetServerWorldTimeSeconds() : World->GetTimeSeconds());
+}
+
+void UBotwCombatTargetSubsystem::RegisterActor(AActor* Actor)
+{
+	if (!Actor || TargetIndices.Contains(Actor))
+	{
+		return;
+	}
+
+	FBotwCombatTarget Target;
+	Target.Actor = Actor;
+
+	if (const ACharacter* Character = Cast<ACharacter>(Actor))
+	{
+		Target.Type = EBotwCombatTargetType::Character;
+		Target.Root = Character->GetCapsuleComponent();
+		Target.RagdollMesh = Character->GetMesh();
+	}
+	else if (const ASkeletalMeshActor* SkeletalMeshActor = Cast<ASkeletalMeshActor>(Actor))
+	{
+		Target.Type = EBotwCombatTargetType::SkeletalMeshActor;
+		Target.Root = SkeletalMeshActor->GetSkeletalMeshComponent();
+		Target.RagdollMesh = SkeletalMeshActor->GetSkeletalMeshComponent();
+	}
+
+	if (!Target.Root.IsValid() || !Target.RagdollMesh.IsValid())
+	{
+		return;
+	}
+
+	const int32 Index = Targets.Add(MoveTemp(Target));
+	TargetIndices.Add(Actor, Index);
+
+	UpdateTarget(Index);
+	AddToCell(Index);
+
+	SET_DWORD_STAT(STAT_BotwCombatTargets, Targets.Num());
+}
+
+void UBotwCombatTargetSubsystem::UnregisterActor(AActor* Actor)
+{
+	if (const int32* Index = TargetIndices.Find(Actor))
+	{
+		RemoveTarget(*Index);
+	}
+}
+
+void UBotwCombatTargetSubsystem::RemoveTarget(int32 Index)
+{
+	RemoveFromCell(Index);
+	TargetIndices.Remove(Targets[Index].Actor);
+	Targets.RemoveAt(Index);
+
+	SET_DWORD_STAT(STAT_BotwCombatTargets, Targets.Num());
+}
+
+void UBotwCombatTargetSubsystem::UpdateTarget(int32 Index)
+{
+	FBotwCombatTarget& Target = Targets[Index];
+
+	if (Target.Type == EBotwCombatTargetType::Character)
+	{
+		const UCapsuleComponent* Capsule = CastChecked<UCapsuleComponent>(Target.Root.Get());
+		Target.Location = Capsule->GetComponentLocation();
+		Target.Radius = Capsule->GetScaledCapsuleRadius();
+		Target.HalfHeight = Capsule->GetScaledCapsuleHalfHeight();
+	}
+	else
+	{
+		// Follows the mesh while it is a ragdoll.
+		const FBoxSphereBounds& Bounds = Target.RagdollMesh->Bounds;
+		Target.Location = Bounds.Origin;
+		Target.Radius = Bounds.SphereRadius;
+		Target.HalfHeight = Bounds.SphereRadius;
+	}
+
+	MaxTargetExtent = FMath::Max(MaxTargetExtent, Target.HalfHeight);
+}
+
+void UBotwCombatTargetSubsystem::AddToCell(int32 Index)
+{
+	FBotwCombatTarget& Target = Targets[Index];
+	Target.Cell = BotwCombatTargets::GetCell(Target.Location);
+	Cells.FindOrAdd(Target.Cell).Add(Index);
+}
+
+void UBotwCombatTargetSubsystem::RemoveFromCell(int32 Index)
+{
+	const FIntVector Cell = Targets[Index].Cell;
+	if (TArray<int32>* CellTargets = Cells.Find(Cell))
+	{
+		CellTargets->RemoveSingleSwap(Index, EAllowShrinking::No);
+		if (CellTargets->IsEmpty())
+		{
+			Cells.Remove(Cell);
+		}
+	}
+}
+
+void UBotwCombatTargetSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	SCOPE_CYCLE_COUNTER(STAT_BotwCombatTargetsUpdate);
+
+	TArray<int32, TInlineAllocator<8>> Stale;
+
+	const float ServerTime = Replicator ? GetServerTime() : 0.f;
+
+	for (auto It = Targets.CreateIterator(); It; ++It)
+	{
+		if (!It->Root.IsValid() || !It->RagdollMesh.IsValid())
+		{
+			Stale.Add(It.GetIndex());
+			continue;
+		}
+
+		const int32 Index = It.GetIndex();
+		UpdateTarget(Index);
+
+		// Only targets that crossed a cell boundary touch the hash.
+		if (BotwCombatTargets::GetCell(It->Location) != It->Cell)
+		{
+			RemoveFromCell(Index);
+			AddToCell(Index);
+		}
+
+		if (It->bReplicatingRagdoll)
+		{
+			UpdateRagdollReplication(*It, ServerTime);
+		}
+	}
+
+	for (const int32 Index : Stale)
+	{
+		RemoveTarget(Index);
+	}
+}
+
+void UBotwCombatTargetSubsystem::QuerySphere(const FVector& Center, float Radius, const AActor* IgnoreActor,
+	TArray<const FBotwCombatTarget*>& OutTargets) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_BotwCombatTargetQuery);
+
+	const FVector Reach(Radius + MaxTargetExtent);
+	const FIntVector MinCell = BotwCombatTargets::GetCell(Center - Reach);
+	const FIntVector MaxCell = BotwCombatTargets::GetCell(Center + Reach);
+
+	for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+			{
+				const TArray<int32>* CellTargets = Cells.Find(FIntVector(X, Y, Z));
+				if (!CellTargets)
+				{
+					continue;
+				}
+
+				INC_DWORD_STAT_BY(STAT_BotwCombatTargetCandidates, CellTargets->Num());
+
+				for (const int32 Index : *CellTargets)
+				{
+					const FBotwCombatTarget& Target = Targets[Index];
+					const AActor* Actor = Target.Actor.Get();
+					if (!Actor || Actor == IgnoreActor || !Actor->GetActorEnableCollision())
+					{
+						continue;
+					}
+
+					// Closest point on the capsule's core segment.
+					const float SegmentHalfLength = FMath::Max(0.f, Target.HalfHeight - Target.Radius);
+					const FVector Closest(Target.Location.X, Target.Location.Y,
+						FMath::Clamp(Center.Z, Target.Location.Z - SegmentHalfLength, Target.Location.Z + SegmentHalfLength));
+
+					if (FVector::DistSquared(Center, Closest) <= FMath::Square(Radius + Target.Radius))
+					{
+						OutTargets.Add(&Target);
+					}
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "BotwCombatTargetSubsystem.generated.h"
+
+class ABotwRagdollReplicator;
+class USkeletalMeshComponent;
+struct FBotwGameplayEvent;
+struct FBotwRagdollHit;
+struct FBotwRagdollSnapshot;
+
+enum class EBotwCombatTargetType : uint8
+{
+	Character,
+	SkeletalMeshActor
+};
+
+/** A registered combatant: its type, what to ragdoll when hit, and the shape attacks are tested against. */
+struct FBotwCombatTarget
+{
+	TWeakObjectPtr<AActor> Actor;
+
+	/** Component whose location is tracked: the capsule of characters, the mesh of skeletal mesh actors. */
+	TWeakObjectPtr<USceneComponent> Root;
+
+	/** Simulated when the target is hit. */
+	TWeakObjectPtr<USkeletalMeshComponent> RagdollMesh;
+
+	EBotwCombatTargetType Type = EBotwCombatTargetType::Character;
+
+	/** Attacks are tested against a vertical capsule; for skeletal mesh actors, a sphere around the mesh bounds. */
+	FVector Location = FVector::ZeroVector;
+
+	float Radius = 0.f;
+
+	float HalfHeight = 0.f;
+
+	FIntVector Cell = FIntVector::ZeroValue;
+
+	/** Server: whether the ragdoll is moving and its snapshots are being sent. */
+	bool bReplicatingRagdoll = false;
+
+	/**
+	 * Server: bytes sent to each client for the ragdoll since it started, including later hits, bounded by
+	 * botw.Ragdoll.MaxBytesPerRagdoll.
+	 */
+	int32 RagdollBytes = 0;
+
+	float RagdollStartTime = 0.f;
+
+	float NextRagdollSnapshotTime = 0.f;
+
+	/** Client: server time of the newest ragdoll message applied; older ones arriving late are dropped. */
+	float RagdollServerTime = 0.f;
+};
+
+/**
+ * Characters and skeletal mesh actors that can be hit, in a uniform spatial hash. Locations and cells are refreshed
+ * once per frame, so melee and area attacks only look at the targets in the cells they touch, with no scene queries
+ * and no casts. Targets with collision disabled, like pooled NPCs, are skipped.
+ * Also the hit response: targets named by PunchHit events on the event bus are turned into ragdolls and pushed. Only the
+ * server decides hits; in multiplayer it sends them through ABotwRagdollReplicator and every client simulates the
+ * ragdoll itself, corrected by the server only when it settles or drifts too far.
+ */
+UCLASS()
+class BOTW_API UBotwCombatTargetSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	/** Adds Actor if it is a character or a skeletal mesh actor. Done automatically for every actor in the world. */
+	void RegisterActor(AActor* Actor);
+
+	void UnregisterActor(AActor* Actor);
+
+	/** Targets whose shape overlaps the sphere, excluding IgnoreActor. */
+	void QuerySphere(const FVector& Center, float Radius, const AActor* IgnoreActor, TArray<const FBotwCombatTarget*>& OutTargets) const;
+
+	int32 GetNumTargets() const { return Targets.Num(); }
+
+	/** Makes the target a ragdoll and pushes it; BoneIndex INDEX_NONE pushes every body. False if it cannot ragdoll. */
+	bool StartRagdoll(AActor* Target, const FVector& Impulse, int32 BoneIndex);
+
+	/** Clients: messages from ABotwRagdollReplicator. */
+	void ReceiveRagdollHit(const FBotwRagdollHit& Hit);
+
+	void ReceiveRagdollSnapshot(const FBotwRagdollSnapshot& Snapshot);
+
+	/** Server: ragdolls started and bytes sent for them in this world since the last call. */
+	void ConsumeRagdollStats(int32& OutRagdolls, int32& OutBytes);
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	void OnGameplayEvents(TConstArrayView<FBotwGameplayEvent> Events);
+
+	void ApplyPunchHit(const FBotwGameplayEvent& Event);
+
+	void UpdateRagdollReplication(FBotwCombatTarget& Target, float ServerTime);
+
+	void CountRagdollBytes(FBotwCombatTarget& Target, int32 MessageBytes);
+
+	float GetServerTime() const;
+
+	void RemoveTarget(int32 Index);
+
+	void UpdateTarget(int32 Index);
+
+	void AddToCell(int32 Index);
+
+	void RemoveFromCell(int32 Index);
+
+	TSparseArray<FBotwCombatTarget> Targets;
+
+	TMap<TWeakObjectPtr<AActor>, int32> TargetIndices;
+
+	TMap<FIntVector, TArray<int32>> Cells;
+
+	/** Largest target extent, by which queries widen the cells they visit. */
+	float MaxTargetExtent = 0.f;
+
+	/** Only spawned on servers. */
+	UPROPERTY(Transient)
+	TObjectPtr<ABotwRagdollReplicator> Replicator;
+
+	int32 RagdollsStarted = 0;
+
+	int32 RagdollBytesSent = 0;
+
+	FDelegateHandle ActorSpawnedHandle;
+
+	FDelegateHandle ActorDestroyedHandle;
+};
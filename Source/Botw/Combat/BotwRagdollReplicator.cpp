@@ -0,0 +1,117 @@
+#include "BotwRagdollReplicator.h"
+#include "BotwCombatTargetSubsystem.h"
+#include "../Botw.h"
+#include "Engine/ActorChannel.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/PackageMapClient.h"
+#include "Engine/World.h"
+#include "Net/RepLayout.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Ragdoll hits sent"), STAT_BotwRagdollHitsSent, STATGROUP_Botw);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Ragdoll snapshots sent"), STAT_BotwRagdollSnapshotsSent, STATGROUP_Botw);
+
+ABotwRagdollReplicator::ABotwRagdollReplicator()
+{
+	bReplicates = true;
+	bAlwaysRelevant = true;
+
+	// Nothing is replicated as properties; the RPCs go out as soon as they are called.
+	SetNetUpdateFrequency(1.f);
+}
+
+void ABotwRagdollReplicator::SendHit(const FBotwRagdollHit& Hit)
+{
+	MulticastHit(Hit);
+	INC_DWORD_STAT(STAT_BotwRagdollHitsSent);
+}
+
+void ABotwRagdollReplicator::SendSnapshot(const FBotwRagdollSnapshot& Snapshot)
+{
+	if (Snapshot.bSettled)
+	{
+		MulticastSettled(Snapshot);
+	}
+	else
+	{
+		MulticastSnapshot(Snapshot);
+	}
+
+	INC_DWORD_STAT(STAT_BotwRagdollSnapshotsSent);
+}
+
+int32 ABotwRagdollReplicator::MeasureHitBytes(const FBotwRagdollHit& Hit) const
+{
+	UFunction* Function = FindFunctionChecked(GET_FUNCTION_NAME_CHECKED(ABotwRagdollReplicator, MulticastHit));
+	return MeasureMessageBytes(Function, const_cast<FBotwRagdollHit*>(&Hit));
+}
+
+int32 ABotwRagdollReplicator::MeasureSnapshotBytes(const FBotwRagdollSnapshot& Snapshot) const
+{
+	UFunction* Function = Snapshot.bSettled ?
+		FindFunctionChecked(GET_FUNCTION_NAME_CHECKED(ABotwRagdollReplicator, MulticastSettled)) :
+		FindFunctionChecked(GET_FUNCTION_NAME_CHECKED(ABotwRagdollReplicator, MulticastSnapshot));
+	return MeasureMessageBytes(Function, const_cast<FBotwRagdollSnapshot*>(&Snapshot));
+}
+
+int32 ABotwRagdollReplicator::MeasureMessageBytes(UFunction* Function, void* Params) const
+{
+	// The single parameter of each RPC is the whole parameter block.
+	check(Function->NumParms == 1);
+
+	UNetDriver* NetDriver = GetNetDriver();
+	if (!NetDriver)
+	{
+		return 0;
+	}
+
+	// Net GUIDs are assigned by the server, so a multicast has the same size on every connection.
+	for (UNetConnection* Connection : NetDriver->ClientConnections)
+	{
+		UActorChannel* Channel = Connection ? Connection->FindActorChannelRef(const_cast<ABotwRagdollReplicator*>(this)) : nullptr;
+		const FClassNetCache* ClassCache = NetDriver->NetCache->GetClassNetCache(GetClass());
+		const FFieldNetCache* FieldCache = ClassCache ? ClassCache->GetFromField(Function) : nullptr;
+		UPackageMapClient* PackageMap = Connection ? Cast<UPackageMapClient>(Connection->PackageMap) : nullptr;
+		if (!Channel || !FieldCache || !PackageMap)
+		{
+			continue;
+		}
+
+		PayloadWriter.Reset();
+		PayloadWriter.PackageMap = PackageMap;
+		NetDriver->GetFunctionRepLayout(Function)->SendPropertiesForRPC(Function, Channel, PayloadWriter, Params);
+
+		MessageWriter.Reset();
+		MessageWriter.PackageMap = PackageMap;
+		TSharedPtr<FNetFieldExportGroup> ExportGroup = PackageMap->GetOrCreateNetFieldExportGroupForClassNetCache(this);
+		Channel->WriteFieldHeaderAndPayload(MessageWriter, ClassCache, FieldCache, ExportGroup.Get(), PayloadWriter);
+
+		return int32(FMath::DivideAndRoundUp(MessageWriter.GetNumBits(), int64(8)));
+	}
+
+	return 0;
+}
+
+void ABotwRagdollReplicator::MulticastHit_Implementation(const FBotwRagdollHit& Hit)
+{
+	// Multicasts also run on the server, which applied the hit itself.
+	UBotwCombatTargetSubsystem* CombatTargets = GetWorld()->GetSubsystem<UBotwCombatTargetSubsystem>();
+	if (!HasAuthority() && CombatTargets)
+	{
+		CombatTargets->ReceiveRagdollHit(Hit);
+	}
+}
+
+void ABotwRagdollReplicator::MulticastSnapshot_Implementation(const FBotwRagdollSnapshot& Snapshot)
+{
+	UBotwCombatTargetSubsystem* CombatTargets = GetWorld()->GetSubsystem<UBotwCombatTargetSubsystem>();
+	if (!HasAuthority() && CombatTargets)
+	{
+		CombatTargets->ReceiveRagdollSnapshot(Snapshot);
+	}
+}
+
+void ABotwRagdollReplicator::MulticastSettled_Implementation(const FBotwRagdollSnapshot& Snapshot)
+{
+	MulticastSnapshot_Implementation(Snapshot);
+}
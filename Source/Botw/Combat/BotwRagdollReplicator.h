@@ -0,0 +1,91 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
+#include "GameFramework/Info.h"
+#include "UObject/CoreNet.h"
+#include "BotwRagdollReplicator.generated.h"
+
+/** What starts a ragdoll. Clients simulate it from here on their own. */
+USTRUCT()
+struct FBotwRagdollHit
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TObjectPtr<AActor> Target = nullptr;
+
+	/** Velocity change, in cm/s. */
+	UPROPERTY()
+	FVector_NetQuantize10 Impulse = FVector::ZeroVector;
+
+	/** Index of the body that is pushed, or INDEX_NONE for all of them. */
+	UPROPERTY()
+	int16 BoneIndex = INDEX_NONE;
+
+	UPROPERTY()
+	float ServerTime = 0.f;
+};
+
+/** Where the server's ragdoll is. Clients only correct theirs when it settled or drifted too far from this. */
+USTRUCT()
+struct FBotwRagdollSnapshot
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TObjectPtr<AActor> Target = nullptr;
+
+	UPROPERTY()
+	FVector_NetQuantize Location = FVector::ZeroVector;
+
+	UPROPERTY()
+	float ServerTime = 0.f;
+
+	UPROPERTY()
+	bool bSettled = false;
+};
+
+/**
+ * Sends the ragdolls of UBotwCombatTargetSubsystem to clients as events instead of replicated physics: the hit that
+ * started one, a few unreliable snapshots while it moves, and a reliable one when it settles. Spawned by the subsystem
+ * on servers; the subsystem decides what to send and hands what arrives on clients back to it.
+ */
+UCLASS(NotPlaceable, Transient)
+class BOTW_API ABotwRagdollReplicator : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	ABotwRagdollReplicator();
+
+	void SendHit(const FBotwRagdollHit& Hit);
+
+	void SendSnapshot(const FBotwRagdollSnapshot& Snapshot);
+
+	/**
+	 * Size of the message in bytes as the net driver writes it for a client: the field header and the parameters,
+	 * serialized by the RPC's rep layout through the client's package map. Bunch and packet headers are shared with
+	 * other messages and not counted. 0 while no client has a channel open for the replicator.
+	 */
+	int32 MeasureHitBytes(const FBotwRagdollHit& Hit) const;
+
+	int32 MeasureSnapshotBytes(const FBotwRagdollSnapshot& Snapshot) const;
+
+private:
+	int32 MeasureMessageBytes(UFunction* Function, void* Params) const;
+
+	/** Reused by every measurement, so measuring stops allocating once they are large enough. */
+	mutable FNetBitWriter PayloadWriter{nullptr, 0};
+
+	mutable FNetBitWriter MessageWriter{nullptr, 0};
+
+	UFUNCTION(NetMulticast, Reliable)
+	void MulticastHit(const FBotwRagdollHit& Hit);
+
+	UFUNCTION(NetMulticast, Unreliable)
+	void MulticastSnapshot(const FBotwRagdollSnapshot& Snapshot);
+
+	UFUNCTION(NetMulticast, Reliable)
+	void MulticastSettled(const FBotwRagdollSnapshot& Snapshot);
+};
@@ -0,0 +1,324 @@
+#include "BotwClimbCollisionCommandlet.h"
+#include "../Botw.h"
+#include "../MyCharacterMovementComponent.h"
+#include "../Climbing/BotwClimbProxyComponent.h"
+#include "../Climbing/BotwClimbProxyUserData.h"
+
+#if WITH_EDITOR
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Components/StaticMeshComponent.h"
+#include "ConvexDecompTool.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "StaticMeshResources.h"
+#include "UObject/SavePackage.h"
+#endif
+
+UBotwClimbCollisionCommandlet::UBotwClimbCollisionCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+#if WITH_EDITOR
+
+namespace BotwClimbCollision
+{
+	struct FReportRow
+	{
+		FString MeshPath;
+		FString ProxyType;
+		int32 SourceTriangles = 0;
+		int32 ProxyTriangles = 0;
+		float SourceMicroseconds = 0.f;
+		float ProxyMicroseconds = 0.f;
+	};
+
+	/** Triangles a simple-collision query has to consider, with convex hulls counted as triangulated polytopes. */
+	int32 CountSimpleTriangles(const FKAggregateGeom& Geometry)
+	{
+		int32 Triangles = Geometry.BoxElems.Num() * 12;
+
+		for (const FKConvexElem& Convex : Geometry.ConvexElems)
+		{
+			Triangles += FMath::Max(Convex.IndexData.Num() / 3, 2 * Convex.VertexData.Num() - 4);
+		}
+
+		return Triangles;
+	}
+
+	int32 CountSourceTriangles(const UBodySetup* BodySetup, int32 RenderTriangles)
+	{
+		if (BodySetup->CollisionTraceFlag == CTF_UseComplexAsSimple)
+		{
+			return RenderTriangles;
+		}
+
+		return CountSimpleTriangles(BodySetup->AggGeom);
+	}
+
+	/** Sweeps the climbing capsule at the component from a ring of positions around it, like a climber probing every side. */
+	float MeasureSweepMicroseconds(UPrimitiveComponent* Component, const FCollisionShape& Shape, int32 NumSweeps)
+	{
+		const FBoxSphereBounds Bounds = Component->Bounds;
+
+		FHitResult Hit;
+		const double StartTime = FPlatformTime::Seconds();
+
+		for (int32 Index = 0; Index < NumSweeps; ++Index)
+		{
+			const float Angle = 2.f * PI * Index / NumSweeps;
+			const float HeightAlpha = (Index % 5) / 4.f * 1.6f - 0.8f;
+
+			const FVector Target = Bounds.Origin + FVector(0.f, 0.f, Bounds.BoxExtent.Z * HeightAlpha);
+			const FVector Start = Target + FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.f) * (Bounds.SphereRadius + Shape.GetCapsuleRadius());
+
+			Component->SweepComponent(Hit, Start, Target, FQuat::Identity, Shape);
+		}
+
+		return (FPlatformTime::Seconds() - StartTime) * 1.0e6 / NumSweeps;
+	}
+
+	bool SavePackage(UPackage* Package)
+	{
+		const FString Filename = FPackageName::LongPackageNameToFilename(Package->GetName(), FPackageName::GetAssetPackageExtension());
+
+		FSavePackageArgs SaveArgs;
+		SaveArgs.TopLevelFlags = RF_Standalone;
+
+		return UPackage::SavePackage(Package, nullptr, *Filename, SaveArgs);
+	}
+}
+
+int32 UBotwClimbCollisionCommandlet::Main(const FString& Params)
+{
+	using namespace BotwClimbCollision;
+
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamVals;
+	ParseCommandLine(*Params, Tokens, Switches, ParamVals);
+
+	const bool bDryRun = Switches.Contains(TEXT("DryRun"));
+	const bool bForce = Switches.Contains(TEXT("Force"));
+
+	const FString PathsParam = ParamVals.Contains(TEXT("Paths")) ? ParamVals[TEXT("Paths")] : TEXT("/Game/Megascans");
+	const FString MapsParam = ParamVals.Contains(TEXT("Maps")) ? ParamVals[TEXT("Maps")] : TEXT("/Game/Maps/CastleEnvironment");
+
+	int32 MinTriangles = 200;
+	int32 MaxHulls = 4;
+	int32 MaxHullVerts = 16;
+	FParse::Value(*Params, TEXT("MinTriangles="), MinTriangles);
+	FParse::Value(*Params, TEXT("MaxHulls="), MaxHulls);
+	FParse::Value(*Params, TEXT("MaxHullVerts="), MaxHullVerts);
+
+	// A single box is preferred unless it is this much bigger than the hulls it replaces.
+	constexpr float BoxVolumeTolerance = 1.25f;
+	constexpr float MinClimbableHeight = 100.f;
+	constexpr uint32 HullPrecision = 100000;
+	constexpr int32 NumMeasureSweeps = 200;
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	const FTopLevelAssetPath StaticMeshClassPath = UStaticMesh::StaticClass()->GetClassPathName();
+
+	TArray<FAssetData> MeshAssets;
+
+	TArray<FString> Paths;
+	PathsParam.ParseIntoArray(Paths, TEXT("+"));
+	if (!Paths.IsEmpty())
+	{
+		FARFilter Filter;
+		Filter.ClassPaths.Add(StaticMeshClassPath);
+		Filter.bRecursivePaths = true;
+		for (const FString& Path : Paths)
+		{
+			Filter.PackagePaths.Add(FName(*Path));
+		}
+		AssetRegistry.GetAssets(Filter, MeshAssets);
+	}
+
+	// Castle pieces live all over the content tree, so pick up every mesh the maps reference directly.
+	TArray<FString> Maps;
+	MapsParam.ParseIntoArray(Maps, TEXT("+"));
+	for (const FString& Map : Maps)
+	{
+		TArray<FName> Dependencies;
+		AssetRegistry.GetDependencies(FName(*Map), Dependencies, UE::AssetRegistry::EDependencyCategory::Package);
+
+		for (const FName& Dependency : Dependencies)
+		{
+			TArray<FAssetData> DependencyAssets;
+			AssetRegistry.GetAssetsByPackageName(Dependency, DependencyAssets);
+
+			for (const FAssetData& Asset : DependencyAssets)
+			{
+				if (Asset.AssetClassPath == StaticMeshClassPath)
+				{
+					MeshAssets.AddUnique(Asset);
+				}
+			}
+		}
+	}
+
+	UE_LOG(LogBotw, Display, TEXT("BotwClimbCollision: %d candidate meshes"), MeshAssets.Num());
+
+	const FCollisionShape SweepShape = GetDefault<UMyCharacterMovementComponent>()->GetClimbSweepShape();
+
+	UWorld* MeasureWorld = UWorld::CreateWorld(EWorldType::EditorPreview, false);
+
+	TArray<FReportRow> Report;
+	int32 NumSaved = 0;
+
+	for (const FAssetData& Asset : MeshAssets)
+	{
+		UStaticMesh* Mesh = Cast<UStaticMesh>(Asset.GetAsset());
+		if (!Mesh || !Mesh->GetBodySetup() || !Mesh->GetRenderData() || Mesh->GetRenderData()->LODResources.IsEmpty())
+		{
+			continue;
+		}
+
+		if (Mesh->GetAssetUserData<UBotwClimbProxyUserData>() && !bForce)
+		{
+			continue;
+		}
+
+		if (Mesh->GetBounds().BoxExtent.Z * 2.f < MinClimbableHeight)
+		{
+			continue;
+		}
+
+		const FStaticMeshRenderData* RenderData = Mesh->GetRenderData();
+		const int32 LODIndex = FMath::Clamp(Mesh->LODForCollision, 0, RenderData->LODResources.Num() - 1);
+		const FStaticMeshLODResources& LOD = RenderData->LODResources[LODIndex];
+
+		TArray<FVector3f> Vertices;
+		Vertices.Reserve(LOD.VertexBuffers.PositionVertexBuffer.GetNumVertices());
+		for (uint32 Index = 0; Index < LOD.VertexBuffers.PositionVertexBuffer.GetNumVertices(); ++Index)
+		{
+			Vertices.Add(LOD.VertexBuffers.PositionVertexBuffer.VertexPosition(Index));
+		}
+
+		TArray<uint32> Indices;
+		LOD.IndexBuffer.GetCopy(Indices);
+
+		FReportRow Row;
+		Row.MeshPath = Mesh->GetPathName();
+		Row.SourceTriangles = CountSourceTriangles(Mesh->GetBodySetup(), Indices.Num() / 3);
+
+		if (Row.SourceTriangles < MinTriangles || Vertices.IsEmpty())
+		{
+			continue;
+		}
+
+		UBotwClimbProxyUserData* ProxyData = NewObject<UBotwClimbProxyUserData>(Mesh, NAME_None, RF_Transactional);
+		UBodySetup* ProxyBodySetup = NewObject<UBodySetup>(ProxyData, NAME_None, RF_Transactional);
+		ProxyBodySetup->CollisionTraceFlag = CTF_UseSimpleAsComplex;
+		ProxyBodySetup->bGenerateMirroredCollision = false;
+		ProxyBodySetup->bDoubleSidedGeometry = false;
+
+		DecomposeMeshToHulls(ProxyBodySetup, Vertices, Indices, MaxHulls, MaxHullVerts, HullPrecision);
+
+		float HullVolume = 0.f;
+		for (const FKConvexElem& Convex : ProxyBodySetup->AggGeom.ConvexElems)
+		{
+			HullVolume += Convex.GetVolume(FVector::OneVector);
+		}
+
+		const FBox3f LocalBox(Vertices);
+		if (ProxyBodySetup->AggGeom.ConvexElems.IsEmpty() || LocalBox.GetVolume() <= HullVolume * BoxVolumeTolerance)
+		{
+			const FVector3f Size = LocalBox.GetSize();
+
+			FKBoxElem BoxElem(Size.X, Size.Y, Size.Z);
+			BoxElem.Center = FVector(LocalBox.GetCenter());
+
+			ProxyBodySetup->AggGeom.EmptyElements();
+			ProxyBodySetup->AggGeom.BoxElems.Add(BoxElem);
+			Row.ProxyType = TEXT("Box");
+		}
+		else
+		{
+			Row.ProxyType = FString::Printf(TEXT("Convex x%d"), ProxyBodySetup->AggGeom.ConvexElems.Num());
+		}
+
+		ProxyBodySetup->InvalidatePhysicsData();
+		ProxyBodySetup->CreatePhysicsMeshes();
+
+		ProxyData->ClimbBodySetup = ProxyBodySetup;
+		ProxyData->SourceTriangleCount = Row.SourceTriangles;
+		ProxyData->ProxyTriangleCount = Row.ProxyTriangles = CountSimpleTriangles(ProxyBodySetup->AggGeom);
+
+		UStaticMeshComponent* SourceComponent = NewObject<UStaticMeshComponent>(GetTransientPackage());
+		SourceComponent->SetStaticMesh(Mesh);
+		SourceComponent->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+		SourceComponent->RegisterComponentWithWorld(MeasureWorld);
+
+		UBotwClimbProxyComponent* ProxyComponent = NewObject<UBotwClimbProxyComponent>(GetTransientPackage());
+		ProxyComponent->SetClimbBodySetup(ProxyBodySetup);
+		ProxyComponent->RegisterComponentWithWorld(MeasureWorld);
+
+		ProxyData->SourceSweepMicroseconds = Row.SourceMicroseconds = MeasureSweepMicroseconds(SourceComponent, SweepShape, NumMeasureSweeps);
+		ProxyData->ProxySweepMicroseconds = Row.ProxyMicroseconds = MeasureSweepMicroseconds(ProxyComponent, SweepShape, NumMeasureSweeps);
+
+		SourceComponent->UnregisterComponent();
+		ProxyComponent->UnregisterComponent();
+
+		UE_LOG(LogBotw, Display, TEXT("%s: %s, triangles %d -> %d, sweep %.2fus -> %.2fus"), *Row.MeshPath, *Row.ProxyType,
+			Row.SourceTriangles, Row.ProxyTriangles, Row.SourceMicroseconds, Row.ProxyMicroseconds);
+
+		Report.Add(Row);
+
+		if (bDryRun)
+		{
+			continue;
+		}
+
+		Mesh->Modify();
+		Mesh->RemoveUserDataOfClass(UBotwClimbProxyUserData::StaticClass());
+		Mesh->AddAssetUserData(ProxyData);
+
+		if (SavePackage(Mesh->GetPackage()))
+		{
+			++NumSaved;
+		}
+		else
+		{
+			UE_LOG(LogBotw, Error, TEXT("Failed to save %s"), *Mesh->GetPackage()->GetName());
+		}
+	}
+
+	MeasureWorld->DestroyWorld(false);
+
+	FString Csv = TEXT("Mesh,Proxy,SourceTriangles,ProxyTriangles,SourceSweepUs,ProxySweepUs\n");
+	for (const FReportRow& Row : Report)
+	{
+		Csv += FString::Printf(TEXT("%s,%s,%d,%d,%.3f,%.3f\n"), *Row.MeshPath, *Row.ProxyType,
+			Row.SourceTriangles, Row.ProxyTriangles, Row.SourceMicroseconds, Row.ProxyMicroseconds);
+	}
+
+	const FString ReportPath = FPaths::ProjectSavedDir() / TEXT("ClimbProxies") / TEXT("ClimbProxyReport.csv");
+	FFileHelper::SaveStringToFile(Csv, *ReportPath);
+
+	UE_LOG(LogBotw, Display, TEXT("BotwClimbCollision: %d proxies generated, %d meshes saved, report at %s"),
+		Report.Num(), NumSaved, *ReportPath);
+
+	return 0;
+}
+
+#else
+
+int32 UBotwClimbCollisionCommandlet::Main(const FString& Params)
+{
+	UE_LOG(LogBotw, Error, TEXT("BotwClimbCollision requires an editor build."));
+	return 1;
+}
+
+#endif
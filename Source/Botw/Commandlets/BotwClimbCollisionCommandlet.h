@@ -0,0 +1,26 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "BotwClimbCollisionCommandlet.generated.h"
+
+/**
+ * Generates low-poly climb-collision proxies (one box, or a few convex hulls) for heavy static meshes
+ * and stores them on the mesh as UBotwClimbProxyUserData. Proxies only answer the Climbable channel.
+ *
+ * UnrealEditor-Cmd Botw.uproject -run=BotwClimbCollision [-Paths=/Game/Megascans+/Game/Foo]
+ *     [-Maps=/Game/Maps/CastleEnvironment] [-MinTriangles=200] [-MaxHulls=4] [-MaxHullVerts=16] [-Force] [-DryRun]
+ *
+ * Writes a per-mesh report of triangle counts and measured wall-sweep cost, before and after,
+ * to Saved/ClimbProxies/ClimbProxyReport.csv.
+ */
+UCLASS()
+class UBotwClimbCollisionCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UBotwClimbCollisionCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,133 @@
+#include "BotwFlightRecorderCommandlet.h"
+#include "../Botw.h"
+#include "../Profiling/BotwFlightRecorder.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+UBotwFlightRecorderCommandlet::UBotwFlightRecorderCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+namespace BotwFlightRecorderConvert
+{
+	static FString Escape(const FString& Text)
+	{
+		return Text.ReplaceCharWithEscapedChar();
+	}
+
+	static bool Convert(const FString& InputPath, const FString& OutputPath)
+	{
+		BotwFlightRecorder::FDump Dump;
+		if (!BotwFlightRecorder::LoadDump(InputPath, Dump))
+		{
+			UE_LOG(LogBotw, Error, TEXT("%s is not a flight recorder dump"), *InputPath);
+			return false;
+		}
+
+		auto GetName = [&Dump](uint32 Id)
+		{
+			return Dump.Names.IsValidIndex(Id) ? Escape(Dump.Names[Id]) : FString::Printf(TEXT("#%u"), Id);
+		};
+
+		const uint64 FirstCycles = Dump.Events.IsEmpty() ? 0 : Dump.Events[0].Cycles;
+		auto ToMicroseconds = [&Dump, FirstCycles](uint64 Cycles)
+		{
+			return double(int64(Cycles - FirstCycles)) * Dump.SecondsPerCycle * 1e6;
+		};
+
+		TArray<FString> TraceEvents;
+		TSet<uint32> Tracks;
+
+		for (const FBotwFlightEvent& Event : Dump.Events)
+		{
+			const double Timestamp = ToMicroseconds(Event.Cycles);
+			const double Duration = Event.Duration * Dump.SecondsPerCycle * 1e6;
+
+			switch (Event.Type)
+			{
+			case EBotwFlightEventType::Frame:
+				TraceEvents.Add(FString::Printf(
+					TEXT("{\"name\":\"Frame\",\"cat\":\"frame\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":0,\"tid\":0,\"args\":{\"ms\":%.3f}}"),
+					Timestamp, Duration, Duration / 1000.0));
+				break;
+
+			case EBotwFlightEventType::Phase:
+				TraceEvents.Add(FString::Printf(
+					TEXT("{\"name\":\"%s\",\"cat\":\"phase\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":0,\"tid\":%u}"),
+					*GetName(Event.Name), Timestamp, Duration, Event.Object));
+				break;
+
+			default:
+				TraceEvents.Add(FString::Printf(
+					TEXT("{\"name\":\"%s\",\"cat\":\"event\",\"ph\":\"i\",\"s\":\"%s\",\"ts\":%.3f,\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"%s\"}}"),
+					BotwFlightRecorder::GetEventTypeName(Event.Type), Event.Type == EBotwFlightEventType::Hitch ? TEXT("p") : TEXT("t"),
+					Timestamp, Event.Object, *GetName(Event.Name)));
+				break;
+			}
+
+			Tracks.Add(Event.Object);
+		}
+
+		for (const uint32 Track : Tracks)
+		{
+			TraceEvents.Add(FString::Printf(TEXT("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"%s\"}}"),
+				Track, Track == 0 ? TEXT("Game") : *GetName(Track)));
+		}
+
+		const FString Json = FString::Printf(TEXT("{\"otherData\":{\"hitchMs\":%.3f},\"traceEvents\":[\n%s\n]}\n"),
+			Dump.HitchMs, *FString::Join(TraceEvents, TEXT(",\n")));
+
+		if (!FFileHelper::SaveStringToFile(Json, *OutputPath))
+		{
+			UE_LOG(LogBotw, Error, TEXT("Could not write %s"), *OutputPath);
+			return false;
+		}
+
+		UE_LOG(LogBotw, Display, TEXT("%s: %d events, %.1f ms hitch -> %s"), *InputPath, Dump.Events.Num(), Dump.HitchMs, *OutputPath);
+		return true;
+	}
+}
+
+int32 UBotwFlightRecorderCommandlet::Main(const FString& Params)
+{
+	FString Input;
+	TArray<FString> Inputs;
+
+	if (FParse::Value(*Params, TEXT("Input="), Input))
+	{
+		Inputs.Add(Input);
+	}
+	else
+	{
+		const FString Directory = FPaths::ProfilingDir() / TEXT("FlightRecorder");
+
+		TArray<FString> Files;
+		IFileManager::Get().FindFiles(Files, *(Directory / TEXT("*.bfr")), true, false);
+
+		for (const FString& File : Files)
+		{
+			if (!FPaths::FileExists(FPaths::ChangeExtension(Directory / File, TEXT("json"))))
+			{
+				Inputs.Add(Directory / File);
+			}
+		}
+	}
+
+	int32 NumFailed = 0;
+	for (const FString& InputPath : Inputs)
+	{
+		if (!BotwFlightRecorderConvert::Convert(InputPath, FPaths::ChangeExtension(InputPath, TEXT("json"))))
+		{
+			++NumFailed;
+		}
+	}
+
+	UE_LOG(LogBotw, Display, TEXT("BotwFlightRecorder: converted %d of %d dumps"), Inputs.Num() - NumFailed, Inputs.Num());
+
+	return NumFailed > 0 ? 1 : 0;
+}
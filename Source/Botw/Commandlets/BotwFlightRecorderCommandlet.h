@@ -0,0 +1,24 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "BotwFlightRecorderCommandlet.generated.h"
+
+/**
+ * Converts flight recorder dumps (see BotwFlightRecorder.h) to Chrome trace JSON, to be opened in Perfetto or
+ * chrome://tracing. Frames and sync loads go on the first track, and every character gets a track of its own.
+ *
+ * UnrealEditor-Cmd Botw.uproject -run=BotwFlightRecorder [-Input=Saved/Profiling/FlightRecorder/Hitch_....bfr]
+ *
+ * Without -Input, converts every dump in Saved/Profiling/FlightRecorder that has no .json next to it yet.
+ */
+UCLASS()
+class UBotwFlightRecorderCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UBotwFlightRecorderCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
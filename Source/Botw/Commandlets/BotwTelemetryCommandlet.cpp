@@ -0,0 +1,267 @@
+#include "BotwTelemetryCommandlet.h"
+#include "../Botw.h"
+#include "../Profiling/BotwTelemetry.h"
+#include "Algo/Accumulate.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+UBotwTelemetryCommandlet::UBotwTelemetryCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+namespace BotwTelemetryAnalysis
+{
+	struct FHistogram
+	{
+		FHistogram(const TCHAR* InName, float InBucketSize, int32 NumBuckets)
+			: Name(InName)
+			, BucketSize(InBucketSize)
+		{
+			Counts.SetNumZeroed(NumBuckets);
+		}
+
+		/** The last bucket takes everything above the others. */
+		void Add(float Value)
+		{
+			++Counts[FMath::Clamp(FMath::FloorToInt(Value / BucketSize), 0, Counts.Num() - 1)];
+		}
+
+		const TCHAR* Name;
+
+		float BucketSize;
+
+		TArray<int32> Counts;
+	};
+
+	struct FHistograms
+	{
+		FHistogram ClimbSeconds{TEXT("ClimbSeconds"), 1.f, 31};
+
+		FHistogram QueriesPerClimb{TEXT("QueriesPerClimb"), 25.f, 41};
+
+		FHistogram DashesPerClimb{TEXT("DashesPerClimb"), 1.f, 11};
+	};
+
+	struct FStats
+	{
+		FString Name;
+
+		FString MapName;
+
+		double Seconds = 0.0;
+
+		int32 Climbs = 0;
+
+		double ClimbSeconds = 0.0;
+
+		int32 Dashes = 0;
+
+		int32 LedgeUps = 0;
+
+		int32 LedgeUpsBlocked = 0;
+
+		int32 Attacks = 0;
+
+		int32 PunchHits = 0;
+
+		int32 Ragdolls = 0;
+
+		TArray<int32> QueriesPerClimb;
+
+		void Merge(const FStats& Other)
+		{
+			Seconds += Other.Seconds;
+			Climbs += Other.Climbs;
+			ClimbSeconds += Other.ClimbSeconds;
+			Dashes += Other.Dashes;
+			LedgeUps += Other.LedgeUps;
+			LedgeUpsBlocked += Other.LedgeUpsBlocked;
+			Attacks += Other.Attacks;
+			PunchHits += Other.PunchHits;
+			Ragdolls += Other.Ragdolls;
+			QueriesPerClimb.Append(Other.QueriesPerClimb);
+		}
+	};
+
+	static FStats Analyze(const FString& Name, const BotwTelemetry::FSession& Session, FHistograms& Histograms)
+	{
+		FStats Stats;
+		Stats.Name = Name;
+		Stats.MapName = Session.MapName;
+
+		struct FOpenClimb
+		{
+			float StartTime = 0.f;
+
+			int32 Dashes = 0;
+		};
+
+		TMap<uint32, FOpenClimb> OpenClimbs;
+
+		for (const FBotwTelemetryRecord& Record : Session.Records)
+		{
+			Stats.Seconds = FMath::Max(Stats.Seconds, double(Record.Time));
+
+			switch (Record.Type)
+			{
+			case EBotwGameplayEventType::ClimbStart:
+				OpenClimbs.Add(Record.Actor, FOpenClimb{Record.Time, 0});
+				break;
+
+			case EBotwGameplayEventType::ClimbDash:
+				++Stats.Dashes;
+				if (FOpenClimb* Climb = OpenClimbs.Find(Record.Actor))
+				{
+					++Climb->Dashes;
+				}
+				break;
+
+			case EBotwGameplayEventType::ClimbStop:
+				if (const FOpenClimb* Climb = OpenClimbs.Find(Record.Actor))
+				{
+					const float Duration = Record.Time - Climb->StartTime;
+
+					++Stats.Climbs;
+					Stats.ClimbSeconds += Duration;
+					Stats.QueriesPerClimb.Add(Record.Value);
+
+					Histograms.ClimbSeconds.Add(Duration);
+					Histograms.QueriesPerClimb.Add(Record.Value);
+					Histograms.DashesPerClimb.Add(Climb->Dashes);
+
+					OpenClimbs.Remove(Record.Actor);
+				}
+				break;
+
+			case EBotwGameplayEventType::LedgeUp: ++Stats.LedgeUps; break;
+			case EBotwGameplayEventType::LedgeUpBlocked: ++Stats.LedgeUpsBlocked; break;
+			case EBotwGameplayEventType::AttackStarted: ++Stats.Attacks; break;
+			// Pushed once per target and swing, however many frames the fist overlaps it.
+			case EBotwGameplayEventType::PunchHit: ++Stats.PunchHits; break;
+			case EBotwGameplayEventType::Ragdoll: ++Stats.Ragdolls; break;
+			default: break;
+			}
+		}
+
+		return Stats;
+	}
+
+	static double GetPercentile(TArray<int32> Values, double Percentile)
+	{
+		if (Values.IsEmpty())
+		{
+			return 0.0;
+		}
+
+		Values.Sort();
+		return Values[FMath::Clamp(FMath::FloorToInt(Percentile * (Values.Num() - 1)), 0, Values.Num() - 1)];
+	}
+
+	static double Ratio(double Numerator, double Denominator)
+	{
+		return Denominator > 0.0 ? Numerator / Denominator : 0.0;
+	}
+
+	static FString ToCsvRow(const FStats& Stats)
+	{
+		const int32 TotalQueries = Algo::Accumulate(Stats.QueriesPerClimb, 0);
+
+		return FString::Printf(TEXT("%s,%s,%.1f,%d,%.1f,%.1f,%d,%.1f,%d,%d,%.1f,%.1f,%.0f,%.0f,%d,%d,%.2f,%d\n"),
+			*Stats.Name, *Stats.MapName, Stats.Seconds / 60.0, Stats.Climbs, Stats.ClimbSeconds / 60.0,
+			Ratio(Stats.ClimbSeconds, Stats.Climbs), Stats.Dashes, Ratio(Stats.Dashes, Stats.ClimbSeconds / 60.0),
+			Stats.LedgeUps, Stats.LedgeUpsBlocked, 100.0 * Ratio(Stats.LedgeUps, Stats.LedgeUps + Stats.LedgeUpsBlocked),
+			Ratio(TotalQueries, Stats.Climbs), GetPercentile(Stats.QueriesPerClimb, 0.5), GetPercentile(Stats.QueriesPerClimb, 0.95),
+			Stats.Attacks, Stats.PunchHits, Ratio(Stats.PunchHits, Stats.Attacks), Stats.Ragdolls);
+	}
+
+	static FString ToCsv(const FHistogram& Histogram)
+	{
+		FString Csv;
+		for (int32 Bucket = 0; Bucket < Histogram.Counts.Num(); ++Bucket)
+		{
+			const bool bLast = Bucket == Histogram.Counts.Num() - 1;
+			Csv += FString::Printf(TEXT("%s,%g,%s,%d\n"), Histogram.Name, Bucket * Histogram.BucketSize,
+				bLast ? TEXT("") : *FString::Printf(TEXT("%g"), (Bucket + 1) * Histogram.BucketSize), Histogram.Counts[Bucket]);
+		}
+
+		return Csv;
+	}
+}
+
+int32 UBotwTelemetryCommandlet::Main(const FString& Params)
+{
+	using namespace BotwTelemetryAnalysis;
+
+	FString Input = FPaths::ProfilingDir() / TEXT("Telemetry");
+	FParse::Value(*Params, TEXT("Input="), Input);
+
+	FString OutputDirectory = FPaths::DirectoryExists(Input) ? Input : FPaths::GetPath(Input);
+	FParse::Value(*Params, TEXT("Output="), OutputDirectory);
+
+	TArray<FString> Inputs;
+	if (FPaths::DirectoryExists(Input))
+	{
+		TArray<FString> Files;
+		IFileManager::Get().FindFiles(Files, *(Input / TEXT("*.btl")), true, false);
+
+		for (const FString& File : Files)
+		{
+			Inputs.Add(Input / File);
+		}
+	}
+	else
+	{
+		Inputs.Add(Input);
+	}
+
+	FHistograms Histograms;
+	FStats Total;
+	Total.Name = TEXT("Total");
+
+	FString Summary = TEXT("Session,Map,Minutes,Climbs,ClimbMinutes,SecondsPerClimb,Dashes,DashesPerClimbMinute,LedgeUps,")
+		TEXT("LedgeUpsBlocked,LedgeUpSuccessPercent,QueriesPerClimb,QueriesPerClimbP50,QueriesPerClimbP95,Attacks,PunchHits,")
+		TEXT("HitsPerAttack,Ragdolls\n");
+
+	int32 NumFailed = 0;
+	for (const FString& InputPath : Inputs)
+	{
+		BotwTelemetry::FSession Session;
+		if (!BotwTelemetry::LoadSession(InputPath, Session))
+		{
+			UE_LOG(LogBotw, Error, TEXT("%s is not a telemetry session"), *InputPath);
+			++NumFailed;
+			continue;
+		}
+
+		const FStats Stats = Analyze(FPaths::GetBaseFilename(InputPath), Session, Histograms);
+		Summary += ToCsvRow(Stats);
+		Total.Merge(Stats);
+
+		UE_LOG(LogBotw, Display, TEXT("%s: %d records, %.1f minutes, %d climbs"), *InputPath, Session.Records.Num(), Stats.Seconds / 60.0,
+			Stats.Climbs);
+	}
+
+	Summary += ToCsvRow(Total);
+
+	const FString HistogramCsv = TEXT("Histogram,From,To,Count\n") + ToCsv(Histograms.ClimbSeconds) +
+		ToCsv(Histograms.QueriesPerClimb) + ToCsv(Histograms.DashesPerClimb);
+
+	const FString SummaryPath = OutputDirectory / TEXT("TelemetrySummary.csv");
+	const FString HistogramPath = OutputDirectory / TEXT("TelemetryHistograms.csv");
+
+	if (!FFileHelper::SaveStringToFile(Summary, *SummaryPath) || !FFileHelper::SaveStringToFile(HistogramCsv, *HistogramPath))
+	{
+		UE_LOG(LogBotw, Error, TEXT("Could not write %s"), *OutputDirectory);
+		return 1;
+	}
+
+	UE_LOG(LogBotw, Display, TEXT("BotwTelemetry: aggregated %d of %d sessions into %s and %s"), Inputs.Num() - NumFailed, Inputs.Num(),
+		*SummaryPath, *HistogramPath);
+
+	return NumFailed > 0 ? 1 : 0;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "BotwTelemetryCommandlet.generated.h"
+
+/**
+ * Aggregates telemetry sessions (see BotwTelemetry.h) into a CSV summary with one row per session plus a total, and a
+ * CSV of histograms: climb durations, scene queries per climb and dashes per climb.
+ *
+ * UnrealEditor-Cmd Botw.uproject -run=BotwTelemetry [-Input=Saved/Profiling/Telemetry] [-Output=Saved/Profiling/Telemetry]
+ *
+ * -Input is a session file or a directory of them; the output directory gets TelemetrySummary.csv and
+ * TelemetryHistograms.csv.
+ */
+UCLASS()
+class UBotwTelemetryCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UBotwTelemetryCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,189 @@
+#include "GameplayDebuggerCategory_BotwClimbing.h"
+
+#if WITH_GAMEPLAY_DEBUGGER
+
+#include "../Botw.h"
+#include "../MyCharacterMovementComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/PlayerController.h"
+
+namespace BotwClimbingDebugger
+{
+	/** Rows of the cost table; the debug actor is always listed. */
+	constexpr int32 MaxListedClimbers = 8;
+
+	const FColor SweepColor(80, 160, 255);
+
+	const FColor HitColor = FColor::Green;
+
+	const FColor MissColor = FColor::Red;
+}
+
+void FGameplayDebuggerCategory_BotwClimbing::FRepData::Serialize(FArchive& Ar)
+{
+	Ar << Climbers << NumClimbing;
+}
+
+FGameplayDebuggerCategory_BotwClimbing::FGameplayDebuggerCategory_BotwClimbing()
+{
+	bShowOnlyWithDebugActor = false;
+	SetDataPackReplication<FRepData>(&DataPack);
+}
+
+TSharedRef<FGameplayDebuggerCategory> FGameplayDebuggerCategory_BotwClimbing::MakeInstance()
+{
+	return MakeShareable(new FGameplayDebuggerCategory_BotwClimbing());
+}
+
+void FGameplayDebuggerCategory_BotwClimbing::CollectData(APlayerController* OwnerPC, AActor* DebugActor)
+{
+	DataPack.Climbers.Reset();
+	DataPack.NumClimbing = 0;
+
+	const AActor* Selected = DebugActor ? DebugActor : OwnerPC ? OwnerPC->GetPawn() : nullptr;
+	UWorld* World = OwnerPC ? OwnerPC->GetWorld() : nullptr;
+	if (!World)
+	{
+		return;
+	}
+
+	for (TActorIterator<ACharacter> It(World); It; ++It)
+	{
+		const UMyCharacterMovementComponent* Movement = Cast<UMyCharacterMovementComponent>(It->GetCharacterMovement());
+		if (!Movement)
+		{
+			continue;
+		}
+
+		const FBotwQueryCounter& Counter = Movement->GetQueryCounter();
+
+		FClimberCost& Cost = DataPack.Climbers.AddDefaulted_GetRef();
+		Cost.Name = It->GetName();
+		Cost.State = Movement->IsClimbDashing() ? TEXT("dash") : Movement->IsClimbing() ? TEXT("climb")
+			: Movement->IsLedgeClimbing() ? TEXT("ledge") : Movement->IsGliding() ? TEXT("glide") : TEXT("walk");
+		Cost.Queries = Counter.GetQueriesLastFrame();
+		Cost.Microseconds = float(Counter.GetSecondsLastFrame() * 1e6);
+		Cost.Probes = Movement->WallContacts.GetNumProbes();
+		Cost.ProbesSkipped = Movement->WallContacts.GetNumProbesSkipped();
+		Cost.bSelected = *It == Selected;
+
+		DataPack.NumClimbing += Movement->IsClimbing() ? 1 : 0;
+
+		if (Cost.bSelected)
+		{
+			AddClimbingShapes(*Movement);
+		}
+	}
+
+	DataPack.Climbers.Sort([](const FClimberCost& A, const FClimberCost& B)
+	{
+		return A.bSelected != B.bSelected ? A.bSelected : A.Microseconds > B.Microseconds;
+	});
+
+	if (DataPack.Climbers.Num() > BotwClimbingDebugger::MaxListedClimbers)
+	{
+		DataPack.Climbers.SetNum(BotwClimbingDebugger::MaxListedClimbers);
+	}
+}
+
+void FGameplayDebuggerCategory_BotwClimbing::AddClimbingShapes(const UMyCharacterMovementComponent& Movement)
+{
+	using namespace BotwClimbingDebugger;
+
+	const UWorld* World = Movement.GetWorld();
+	const USceneComponent* Updated = Movement.UpdatedComponent;
+	if (!Updated)
+	{
+		return;
+	}
+
+	const FVector Location = Updated->GetComponentLocation();
+	const FVector Forward = Updated->GetForwardVector();
+
+	// The wall sweep of SweepAndStoreWallHits, which starts 20 units ahead of the character.
+	const FCollisionShape SweepShape = Movement.GetClimbSweepShape();
+	AddShape(FGameplayDebuggerShape::MakeCapsule(Location + Forward * 20.f, SweepShape.GetCapsuleRadius(),
+		SweepShape.GetCapsuleHalfHeight(), SweepColor, TEXT("wall sweep")));
+
+	for (const FBotwClimbContact& Contact : Movement.WallContacts)
+	{
+		const FVector Position(Contact.Position);
+		const FColor Color = !Contact.Landscape.IsExplicitlyNull() ? FColor::Orange : FColor::Yellow;
+
+		AddShape(FGameplayDebuggerShape::MakePoint(Position, 4.f, Color));
+		AddShape(FGameplayDebuggerShape::MakeSegment(Position, Position + FVector(Contact.Normal) * 30.f, 1.f, Color));
+	}
+
+	if (Movement.IsClimbing())
+	{
+		const FVector Position = Movement.CurrentClimbingPosition;
+		AddShape(FGameplayDebuggerShape::MakePoint(Position, 8.f, FColor::Magenta, TEXT("surface")));
+		AddShape(FGameplayDebuggerShape::MakeSegment(Position, Position + Movement.CurrentClimbingNormal * 80.f, 3.f, FColor::Magenta));
+	}
+
+	if (Movement.IsLedgeClimbing())
+	{
+		const FBotwLedgeClimbState& LedgeClimb = Movement.LedgeClimb;
+		AddShape(FGameplayDebuggerShape::MakeSegment(LedgeClimb.Start, LedgeClimb.WallTop, 2.f, FColor::Magenta));
+		AddShape(FGameplayDebuggerShape::MakeSegment(LedgeClimb.WallTop, LedgeClimb.LedgeTop, 2.f, FColor::Magenta));
+		AddShape(FGameplayDebuggerShape::MakePoint(LedgeClimb.WallTop, 8.f, FColor::Magenta, TEXT("wall top")));
+		AddShape(FGameplayDebuggerShape::MakePoint(LedgeClimb.LedgeTop, 8.f, FColor::Magenta, TEXT("ledge top")));
+	}
+
+	// The traces are issued again here, uncounted, to show whether they hit right now.
+	auto AddTrace = [this, World, &Movement](const FVector& Start, const FVector& End, const TCHAR* Description)
+	{
+		FHitResult Hit;
+		const bool bHit = World->LineTraceSingleByChannel(Hit, Start, End, ECC_Climbable, Movement.ClimbQueryParams);
+		AddShape(FGameplayDebuggerShape::MakeSegment(Start, bHit ? Hit.ImpactPoint : End, 2.f, bHit ? HitColor : MissColor, Description));
+	};
+
+	FVector Start;
+	FVector End;
+
+	Movement.GetEyeHeightTraceSegment(Movement.GetEdgeTraceDistance(), Start, End);
+	AddTrace(Start, End, TEXT("eye"));
+
+	if (Movement.IsClimbing())
+	{
+		Movement.GetFloorTraceSegment(Start, End);
+		AddTrace(Start, End, TEXT("floor"));
+
+		// IsLocationWalkable traces 250 units down from the ledge-up location.
+		FVector CheckLocation;
+		FVector HorizontalOffset;
+		Movement.GetLedgeClimbCheck(CheckLocation, HorizontalOffset);
+		AddTrace(CheckLocation, CheckLocation + FVector::DownVector * 250.f, TEXT("ledge"));
+
+		const FCollisionShape StandShape = Movement.GetCharacterOwner()->GetCapsuleComponent()->GetCollisionShape();
+		AddShape(FGameplayDebuggerShape::MakeCapsule(CheckLocation, StandShape.GetCapsuleRadius(), StandShape.GetCapsuleHalfHeight(),
+			SweepColor, TEXT("ledge-up")));
+	}
+
+	if (Movement.IsClimbDashing())
+	{
+		AddShape(FGameplayDebuggerShape::MakeSegment(Location, Location + Movement.GetClimbDashDirection() * 150.f, 4.f,
+			FColor::Cyan, TEXT("dash")));
+	}
+}
+
+void FGameplayDebuggerCategory_BotwClimbing::DrawData(APlayerController* OwnerPC, FGameplayDebuggerCanvasContext& CanvasContext)
+{
+	CanvasContext.Printf(TEXT("{white}Botw characters climbing: {yellow}%d"), DataPack.NumClimbing);
+	CanvasContext.Printf(TEXT("{grey}%-24s %-6s %8s %8s %8s %8s"), TEXT("character"), TEXT("state"), TEXT("queries"), TEXT("us"),
+		TEXT("probes"), TEXT("skipped"));
+
+	for (const FClimberCost& Cost : DataPack.Climbers)
+	{
+		const uint32 Total = Cost.Probes + Cost.ProbesSkipped;
+		const int32 SkippedPercent = Total > 0 ? int32(100 * uint64(Cost.ProbesSkipped) / Total) : 0;
+
+		CanvasContext.Printf(TEXT("%s%-24s %-6s %8d %8.1f %8u %7d%%"), Cost.bSelected ? TEXT("{green}") : TEXT("{white}"),
+			*Cost.Name.Left(24), *Cost.State, Cost.Queries, Cost.Microseconds, Cost.Probes, SkippedPercent);
+	}
+}
+
+#endif // WITH_GAMEPLAY_DEBUGGER
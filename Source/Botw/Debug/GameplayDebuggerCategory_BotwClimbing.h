@@ -0,0 +1,65 @@
+#pragma once
+
+#if WITH_GAMEPLAY_DEBUGGER
+
+#include "CoreMinimal.h"
+#include "GameplayDebuggerCategory.h"
+
+class APlayerController;
+class UMyCharacterMovementComponent;
+
+/**
+ * Gameplay Debugger category "Climbing". Draws the climbing queries of the debug actor, or of the viewing player's
+ * character when nothing is picked, and lists the most expensive climbers of the world by last frame's query time.
+ * Everything is gathered on the server and replicated, so clients of a listen server or PIE session see the
+ * server's cost.
+ */
+class FGameplayDebuggerCategory_BotwClimbing : public FGameplayDebuggerCategory
+{
+public:
+	FGameplayDebuggerCategory_BotwClimbing();
+
+	virtual void CollectData(APlayerController* OwnerPC, AActor* DebugActor) override;
+
+	virtual void DrawData(APlayerController* OwnerPC, FGameplayDebuggerCanvasContext& CanvasContext) override;
+
+	static TSharedRef<FGameplayDebuggerCategory> MakeInstance();
+
+protected:
+	struct FClimberCost
+	{
+		FString Name;
+
+		FString State;
+
+		int32 Queries = 0;
+
+		float Microseconds = 0.f;
+
+		uint32 Probes = 0;
+
+		uint32 ProbesSkipped = 0;
+
+		bool bSelected = false;
+
+		friend FArchive& operator<<(FArchive& Ar, FClimberCost& Cost)
+		{
+			return Ar << Cost.Name << Cost.State << Cost.Queries << Cost.Microseconds << Cost.Probes << Cost.ProbesSkipped << Cost.bSelected;
+		}
+	};
+
+	struct FRepData
+	{
+		TArray<FClimberCost> Climbers;
+
+		int32 NumClimbing = 0;
+
+		void Serialize(FArchive& Ar);
+	};
+
+	void AddClimbingShapes(const UMyCharacterMovementComponent& Movement);
+
+	FRepData DataPack;
+};
+
+#endif // WITH_GAMEPLAY_DEBUGGER
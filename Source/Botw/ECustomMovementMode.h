@@ -6,5 +6,7 @@ UENUM(BlueprintType)
 enum ECustomMovementMode
 {
 	CMOVE_Climbing      UMETA(DisplayName = "Climbing"),
+	CMOVE_Gliding       UMETA(DisplayName = "Gliding"),
+	CMOVE_LedgeClimbing UMETA(DisplayName = "Ledge Climbing"),
 	CMOVE_MAX			UMETA(Hidden),
 };
\ No newline at end of file
@@ -0,0 +1,204 @@
+#include "BotwEventBusSubsystem.h"
+#include "../Botw.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Gameplay event dispatch"), STAT_BotwEventDispatch, STATGROUP_Botw);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Gameplay events"), STAT_BotwEvents, STATGROUP_Botw);
+
+static TAutoConsoleVariable<bool> CVarEventsPrint(
+	TEXT("botw.Events.Print"),
+	false,
+	TEXT("Shows gameplay events on screen as they are dispatched."),
+	ECVF_Cheat);
+
+bool UBotwEventBusSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UBotwEventBusSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UBotwEventBusSubsystem, STATGROUP_Tickables);
+}
+
+void UBotwEventBusSubsystem::Deinitialize()
+{
+	// Consumers like telemetry get every batch of the world before it goes away.
+	AsyncConsumerTask.Wait();
+
+	for (FEventNode* Node = PendingHead.exchange(nullptr); Node;)
+	{
+		FEventNode* Next = Node->Next;
+		delete Node;
+		Node = Next;
+	}
+
+	while (FEventNode* Node = FreeNodes.Pop())
+	{
+		delete Node;
+	}
+
+	while (FEventArray* AsyncBatch = FreeAsyncBatches.Pop())
+	{
+		delete AsyncBatch;
+	}
+
+	OnEvents.Clear();
+	AsyncConsumers = MakeShared<const TArray<FAsyncConsumer>>();
+
+	Super::Deinitialize();
+}
+
+void UBotwEventBusSubsystem::AddAsyncConsumer(FAsyncConsumer Consumer)
+{
+	TArray<FAsyncConsumer> Consumers = *AsyncConsumers;
+	Consumers.Add(MoveTemp(Consumer));
+	AsyncConsumers = MakeShared<const TArray<FAsyncConsumer>>(MoveTemp(Consumers));
+}
+
+void UBotwEventBusSubsystem::Push(const FBotwGameplayEvent& Event)
+{
+	FEventNode* Node = FreeNodes.Pop();
+	if (!Node)
+	{
+		Node = new FEventNode();
+	}
+
+	Node->Event = Event;
+
+	// On failure the compare-exchange loads the new head into Next, ready for the next try.
+	Node->Next = PendingHead.load(std::memory_order_relaxed);
+	while (!PendingHead.compare_exchange_weak(Node->Next, Node, std::memory_order_release, std::memory_order_relaxed))
+	{
+	}
+}
+
+void UBotwEventBusSubsystem::Push(EBotwGameplayEventType Type, AActor* Instigator, AActor* Target, const FVector& Location,
+	const FVector& Direction, int32 Value)
+{
+	check(IsInGameThread());
+
+	const UWorld* World = Instigator ? Instigator->GetWorld() : nullptr;
+	UBotwEventBusSubsystem* Bus = World ? World->GetSubsystem<UBotwEventBusSubsystem>() : nullptr;
+	if (!Bus)
+	{
+		return;
+	}
+
+	FBotwGameplayEvent Event;
+	Event.Type = Type;
+	Event.Instigator = Instigator;
+	Event.Target = Target;
+	Event.Location = Location;
+	Event.Direction = Direction;
+	Event.Value = Value;
+	Event.Seconds = FPlatformTime::Seconds();
+
+	Bus->Push(Event);
+}
+
+void UBotwEventBusSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	SCOPE_CYCLE_COUNTER(STAT_BotwEventDispatch);
+
+	Batch.Reset();
+
+	// Reversed first, so the batch is in the order the events were pushed.
+	FEventNode* Oldest = nullptr;
+	for (FEventNode* Node = PendingHead.exchange(nullptr, std::memory_order_acquire); Node;)
+	{
+		FEventNode* Next = Node->Next;
+		Node->Next = Oldest;
+		Oldest = Node;
+		Node = Next;
+	}
+
+	for (FEventNode* Node = Oldest; Node;)
+	{
+		FEventNode* Next = Node->Next;
+		Batch.Add(MoveTemp(Node->Event));
+		FreeNodes.Push(Node);
+		Node = Next;
+	}
+
+	if (Batch.IsEmpty())
+	{
+		return;
+	}
+
+	INC_DWORD_STAT_BY(STAT_BotwEvents, Batch.Num());
+
+	OnEvents.Broadcast(Batch);
+
+	if (CVarEventsPrint.GetValueOnGameThread())
+	{
+		PrintEvents(Batch);
+	}
+
+	if (!AsyncConsumers->IsEmpty())
+	{
+		AsyncConsumerTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [this, Events = AcquireAsyncBatch(), Consumers = AsyncConsumers]()
+		{
+			for (const FAsyncConsumer& Consumer : *Consumers)
+			{
+				Consumer(*Events);
+			}
+
+			FreeAsyncBatches.Push(Events);
+		}, UE::Tasks::Prerequisites(AsyncConsumerTask));
+	}
+}
+
+UBotwEventBusSubsystem::FEventArray* UBotwEventBusSubsystem::AcquireAsyncBatch()
+{
+	FEventArray* AsyncBatch = FreeAsyncBatches.Pop();
+	if (!AsyncBatch)
+	{
+		AsyncBatch = new FEventArray();
+	}
+
+	AsyncBatch->Reset();
+	AsyncBatch->Append(Batch);
+
+	return AsyncBatch;
+}
+
+void UBotwEventBusSubsystem::PrintEvents(TConstArrayView<FBotwGameplayEvent> Events) const
+{
+	if (!GEngine)
+	{
+		return;
+	}
+
+	for (const FBotwGameplayEvent& Event : Events)
+	{
+		const FString Message = Event.Target.IsValid()
+			? FString::Printf(TEXT("+++ %s %s -> %s +++"), GetEventTypeName(Event.Type), *GetNameSafe(Event.Instigator.Get()), *Event.Target->GetName())
+			: FString::Printf(TEXT("+++ %s %s +++"), GetEventTypeName(Event.Type), *GetNameSafe(Event.Instigator.Get()));
+
+		GEngine->AddOnScreenDebugMessage(-1, 15.0f, FColor::Yellow, Message);
+	}
+}
+
+const TCHAR* UBotwEventBusSubsystem::GetEventTypeName(EBotwGameplayEventType Type)
+{
+	switch (Type)
+	{
+	case EBotwGameplayEventType::ClimbRequested: return TEXT("CLIMB");
+	case EBotwGameplayEventType::ClimbCancelled: return TEXT("CANCEL CLIMB");
+	case EBotwGameplayEventType::ClimbStart: return TEXT("CLIMB START");
+	case EBotwGameplayEventType::ClimbStop: return TEXT("CLIMB STOP");
+	case EBotwGameplayEventType::ClimbDash: return TEXT("CLIMB DASH");
+	case EBotwGameplayEventType::LedgeUp: return TEXT("LEDGE UP");
+	case EBotwGameplayEventType::AttackStarted: return TEXT("ATTACK");
+	case EBotwGameplayEventType::PunchHit: return TEXT("PUNCH HIT");
+	case EBotwGameplayEventType::LedgeUpBlocked: return TEXT("LEDGE UP BLOCKED");
+	case EBotwGameplayEventType::Ragdoll: return TEXT("RAGDOLL");
+	default: return TEXT("UNKNOWN");
+	}
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/LockFreeList.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tasks/Task.h"
+#include <atomic>
+#include "BotwEventBusSubsystem.generated.h"
+
+/** Written to telemetry files as numbers; add new types at the end. */
+enum class EBotwGameplayEventType : uint8
+{
+	ClimbRequested,
+	ClimbCancelled,
+	ClimbStart,
+	ClimbStop,
+	ClimbDash,
+	LedgeUp,
+	AttackStarted,
+	/** Target was reached by a punch; once per target and swing. Direction is the push direction. */
+	PunchHit,
+	/** The character reached a ledge moving up but did not fit on it. Once per ledge. */
+	LedgeUpBlocked,
+	/** Instigator became a ragdoll. */
+	Ragdoll,
+	Num
+};
+
+struct FBotwGameplayEvent
+{
+	EBotwGameplayEventType Type = EBotwGameplayEventType::Num;
+
+	TWeakObjectPtr<AActor> Instigator;
+
+	TWeakObjectPtr<AActor> Target;
+
+	FVector Location = FVector::ZeroVector;
+
+	FVector Direction = FVector::ZeroVector;
+
+	/** Scene queries issued during the climb, for ClimbStop. */
+	int32 Value = 0;
+
+	/** FPlatformTime::Seconds when it was pushed. */
+	double Seconds = 0.0;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FBotwGameplayEventBatch, TConstArrayView<FBotwGameplayEvent>);
+
+/**
+ * Typed gameplay events from movement and combat code. Producers push into a lock-free MPSC queue and return; the queue
+ * is drained once per frame, after all actors have ticked, and handed to consumers in one batch. Producers off the game
+ * thread look the bus up on the game thread and push into it directly.
+ * Game-thread consumers bind OnEvents; consumers that only need copies of the data, like telemetry, are added with
+ * AddAsyncConsumer and get the batch on a worker thread, where they must not resolve the weak pointers. Async batches
+ * run one after the other in frame order, so a consumer never runs concurrently with itself.
+ * Queue nodes and async batches are pooled, so once the pools cover the busiest frame, events do not allocate.
+ */
+UCLASS()
+class BOTW_API UBotwEventBusSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	virtual void Deinitialize() override;
+
+	/** Safe on any thread. */
+	void Push(const FBotwGameplayEvent& Event);
+
+	/** Pushes into the bus of the world Instigator is in, if it has one. Game thread only, as it looks up the world. */
+	static void Push(EBotwGameplayEventType Type, AActor* Instigator, AActor* Target = nullptr,
+		const FVector& Location = FVector::ZeroVector, const FVector& Direction = FVector::ZeroVector, int32 Value = 0);
+
+	using FAsyncConsumer = TFunction<void(TConstArrayView<FBotwGameplayEvent>)>;
+
+	void AddAsyncConsumer(FAsyncConsumer Consumer);
+
+	FBotwGameplayEventBatch OnEvents;
+
+	static const TCHAR* GetEventTypeName(EBotwGameplayEventType Type);
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	void PrintEvents(TConstArrayView<FBotwGameplayEvent> Events) const;
+
+	struct FEventNode
+	{
+		FBotwGameplayEvent Event;
+
+		FEventNode* Next = nullptr;
+	};
+
+	using FEventArray = TArray<FBotwGameplayEvent>;
+
+	/** Copies Batch into an array the async consumers own until they are done with it. */
+	FEventArray* AcquireAsyncBatch();
+
+	/**
+	 * Events pushed since the last tick, newest first. Producers link their node in with a compare-exchange and Tick
+	 * takes the whole list with one exchange; nodes are never popped one by one, so the list cannot suffer from ABA.
+	 */
+	std::atomic<FEventNode*> PendingHead{nullptr};
+
+	/** Nodes Tick has copied out, for producers to reuse. */
+	TLockFreePointerListUnordered<FEventNode, PLATFORM_CACHE_LINE_SIZE> FreeNodes;
+
+	/** Replaced as a whole when a consumer is added, so each async batch holds the consumers it started with. */
+	TSharedRef<const TArray<FAsyncConsumer>> AsyncConsumers = MakeShared<const TArray<FAsyncConsumer>>();
+
+	/** The async consumers of the last batch; the next batch waits for it. */
+	UE::Tasks::FTask AsyncConsumerTask;
+
+	/** Arrays the async consumers gave back, for the next batches. */
+	TLockFreePointerListUnordered<FEventArray, PLATFORM_CACHE_LINE_SIZE> FreeAsyncBatches;
+
+	/** Reused between frames. */
+	FEventArray Batch;
+};
@@ -0,0 +1,50 @@
+#include "BotwGroundHeightCache.h"
+
+bool FBotwGroundHeightCache::GetGroundZ(const FVector& Location, float& OutGroundZ) const
+{
+	const float* GroundZ = Cells.Find(GetCell(Location));
+	if (!GroundZ)
+	{
+		return false;
+	}
+
+	OutGroundZ = *GroundZ;
+	return true;
+}
+
+void FBotwGroundHeightCache::AddSample(const FVector& Location, float GroundZ)
+{
+	const FIntPoint Cell = GetCell(Location);
+	if (float* CellGroundZ = Cells.Find(Cell))
+	{
+		*CellGroundZ = GroundZ;
+		return;
+	}
+
+	if (SampleOrder.Num() < MaxCells)
+	{
+		SampleOrder.Add(Cell);
+	}
+	else
+	{
+		// Samples are added along the glide path, so the oldest cells are the ones furthest behind.
+		Cells.Remove(SampleOrder[OldestCell]);
+		SampleOrder[OldestCell] = Cell;
+		OldestCell = (OldestCell + 1) % MaxCells;
+	}
+
+	Cells.Add(Cell, GroundZ);
+}
+
+void FBotwGroundHeightCache::Reset()
+{
+	Cells.Reset();
+	SampleOrder.Reset();
+	OldestCell = 0;
+}
+
+FVector FBotwGroundHeightCache::GetCellCenter(const FVector& Location) const
+{
+	const FIntPoint Cell = GetCell(Location);
+	return FVector((Cell.X + 0.5f) * CellSize, (Cell.Y + 0.5f) * CellSize, Location.Z);
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Coarse ground heights on a horizontal grid, one downward trace per cell. Gliding characters sample the cells
+ * ahead of their path once and read heights from here instead of tracing for the floor every frame; only when a
+ * cell says the ground is close do they trace for the exact height.
+ * A cell stores where its trace hit, or the end of the trace if it hit nothing, so the ground at the cell's center
+ * is at most this high. Structures between samples are still caught by the movement sweep.
+ */
+class BOTW_API FBotwGroundHeightCache
+{
+public:
+	explicit FBotwGroundHeightCache(float InCellSize = 400.f)
+		: CellSize(InCellSize)
+	{
+	}
+
+	bool HasSample(const FVector& Location) const
+	{
+		return Cells.Contains(GetCell(Location));
+	}
+
+	/** Height of the ground in the cell of Location, if it was sampled. */
+	bool GetGroundZ(const FVector& Location, float& OutGroundZ) const;
+
+	void AddSample(const FVector& Location, float GroundZ);
+
+	void Reset();
+
+	int32 Num() const { return Cells.Num(); }
+
+	float GetCellSize() const { return CellSize; }
+
+	/** Center of the cell of Location, at Location's height. */
+	FVector GetCellCenter(const FVector& Location) const;
+
+private:
+	/** A long glide crosses a few hundred cells; beyond that the oldest are dropped. */
+	static constexpr int32 MaxCells = 512;
+
+	FIntPoint GetCell(const FVector& Location) const
+	{
+		return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+	}
+
+	/** Ground height per cell. */
+	TMap<FIntPoint, float> Cells;
+
+	/** The cells in the order they were sampled, a ring once full; OldestCell is the next to be dropped. */
+	TArray<FIntPoint> SampleOrder;
+
+	int32 OldestCell = 0;
+
+	float CellSize;
+};
@@ -1,8 +1,54 @@
 #include "MyCharacterMovementComponent.h"
+#include "Botw.h"
 #include "BotwCharacter.h"
+#include "BotwFrameScratch.h"
+#include "BotwGameMode.h"
+#include "Climbing/BotwLandscapeSampler.h"
+#include "Events/BotwEventBusSubsystem.h"
+#include "Profiling/BotwFlightRecorder.h"
 #include "ECustomMovementMode.h"
+#include "Animation/AnimInstance.h"
+#include "Animation/AnimMontage.h"
 #include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
 #include "GameFramework/Character.h"
+#include "LandscapeProxy.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Climb floor traces"), STAT_BotwClimbFloorTraces, STATGROUP_Botw);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Climb floor traces skipped"), STAT_BotwClimbFloorTracesSkipped, STATGROUP_Botw);
+
+namespace BotwClimbing
+{
+	constexpr float AssistSphereRadius = 6.f;
+
+	/** Fraction of the remaining distance covered in DeltaTime when closing in at Speed per second, independent of frame rate. */
+	static float ExpDecayAlpha(float Speed, float DeltaTime)
+	{
+		return 1.f - FMath::Exp(-Speed * DeltaTime);
+	}
+
+	/**
+	 * Advances a velocity that approaches Target exponentially at Rate per second, exactly for any DeltaTime.
+	 * Returns the distance covered; the glide is the same whatever the frame rate, without substeps.
+	 */
+	static FVector IntegrateGlide(FVector& InOutVelocity, const FVector& Target, float Rate, float DeltaTime)
+	{
+		const float Decay = FMath::Exp(-Rate * DeltaTime);
+		const FVector Delta = Target * DeltaTime + (InOutVelocity - Target) * ((1.f - Decay) / Rate);
+
+		InOutVelocity = Target + (InOutVelocity - Target) * Decay;
+		return Delta;
+	}
+
+	/** Points along the predicted glide path where the ground-height cache is filled. */
+	constexpr int32 GlideLookaheadSamples = 4;
+
+	/** Ground samples start this far above the glider, to see ground rising ahead of it. */
+	constexpr float GlideSampleHeadroom = 500.f;
+
+	/** The ledge-up ends with the capsule this far above the ledge, so walking finds the floor without penetrating it. */
+	constexpr float LedgeTopClearance = 2.f;
+}
 
 UMyCharacterMovementComponent::UMyCharacterMovementComponent(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
@@ -16,6 +62,10 @@ void UMyCharacterMovementComponent::BeginPlay()
 	AnimInstance = GetCharacterOwner()->GetMesh()->GetAnimInstance();
 	
 	ClimbQueryParams.AddIgnoredActor(GetOwner());
+
+	QueryCounter.SetOwner(GetOwner());
+
+	FlightRecorderId = BotwFlightRecorder::GetObjectId(GetOwner());
 }
 
 void UMyCharacterMovementComponent::TickComponent(float DeltaTime, ELevelTick TickType,
@@ -23,55 +73,90 @@ void UMyCharacterMovementComponent::TickComponent(float DeltaTime, ELevelTick Ti
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
-	SweepAndStoreWallHits();
+	// Gliders only look for walls when asked to climb, see TryClimbing; ledge-ups do not need them at all.
+	if (!IsGliding() && !IsLedgeClimbing())
+	{
+		SweepAndStoreWallHits();
+	}
+
+	QueryCounter.AddState(GetQueryBudgetState());
+}
+
+EBotwQueryBudgetState UMyCharacterMovementComponent::GetQueryBudgetState() const
+{
+	if (IsGliding())
+	{
+		return EBotwQueryBudgetState::Gliding;
+	}
+
+	if (IsLedgeClimbing())
+	{
+		return EBotwQueryBudgetState::LedgeUp;
+	}
+
+	if (!IsClimbing())
+	{
+		return EBotwQueryBudgetState::Walking;
+	}
+
+	if (bIsClimbDashing)
+	{
+		return EBotwQueryBudgetState::ClimbDashing;
+	}
+
+	return Velocity.IsNearlyZero() ? EBotwQueryBudgetState::ClimbingIdle : EBotwQueryBudgetState::ClimbingMoving;
 }
 
 void UMyCharacterMovementComponent::SweepAndStoreWallHits()
 {
-	//GEngine->AddOnScreenDebugMessage(-1, 15.0f, FColor::Yellow, TEXT("SWEEP"));
-	bool printed = false;
-	
-	const FCollisionShape CollisionShape = FCollisionShape::MakeCapsule(CollisionCapsuleRadius, CollisionCapsuleHalfHeight);
+	const FVector Location = UpdatedComponent->GetComponentLocation();
+	const FQuat Rotation = UpdatedComponent->GetComponentQuat();
+
+	if (!WallContacts.NeedsProbe(Location, Rotation, ContactProbeDistanceTolerance, ContactProbeAngleTolerance, MaxContactAge))
+	{
+		WallContacts.Keep();
+		return;
+	}
+
+	ProbeWallContacts();
+}
+
+void UMyCharacterMovementComponent::ProbeWallContacts()
+{
+	BOTW_FLIGHT_PHASE(ClimbProbe, FlightRecorderId);
+
+	const FVector Location = UpdatedComponent->GetComponentLocation();
+	const FQuat Rotation = UpdatedComponent->GetComponentQuat();
+
+	const FCollisionShape CollisionShape = GetClimbSweepShape();
 
 	const FVector StartOffset = UpdatedComponent->GetForwardVector() * 20;
 
 	// Avoid using the same Start/End location for a Sweep, as it doesn't trigger hits on Landscapes.
-	const FVector Start = UpdatedComponent->GetComponentLocation() + StartOffset;
+	const FVector Start = Location + StartOffset;
 	const FVector End = Start + UpdatedComponent->GetForwardVector();
 
-	TArray<FHitResult> Hits;
-	const bool HitWall = GetWorld()->SweepMultiByChannel(Hits, Start, End, FQuat::Identity,
-		  ECC_WorldStatic, CollisionShape, ClimbQueryParams);
+	TBotwScratchArray<FHitResult> Hits;
+	BotwSceneQuery::SweepMulti(QueryCounter, GetWorld(), *Hits, Start, End, FQuat::Identity,
+		  ECC_Climbable, CollisionShape, ClimbQueryParams);
 
-	if (HitWall) {
-		CurrentWallHits = Hits;
-
-		if (!printed) {
-			printed = true;
-			//GEngine->AddOnScreenDebugMessage(-1, 15.0f, FColor::Yellow, TEXT("HIT"));
-		}
-	}
+	WallContacts.Update(*Hits, Location, Rotation);
+	bSurfaceInfoDirty = true;
+}
 
-	if (!HitWall) {
-		CurrentWallHits.Reset();
-	}
+FCollisionShape UMyCharacterMovementComponent::GetClimbSweepShape() const
+{
+	return FCollisionShape::MakeCapsule(CollisionCapsuleRadius, CollisionCapsuleHalfHeight);
 }
 
 bool UMyCharacterMovementComponent::CanStartClimbing()
 {
-	for (FHitResult& Hit : CurrentWallHits)
+	for (const FBotwClimbContact& Contact : WallContacts)
 	{
-		const FVector HorizontalNormal = Hit.Normal.GetSafeNormal2D();
+		const FVector Normal(Contact.Normal);
 
-		const float HorizontalDot = FVector::DotProduct(UpdatedComponent->GetForwardVector(), -HorizontalNormal);
-		const float VerticalDot = FVector::DotProduct(Hit.Normal, HorizontalNormal);
-
-		const float HorizontalDegrees = FMath::RadiansToDegrees(FMath::Acos(HorizontalDot));
-
-		const bool bIsCeiling = FMath::IsNearlyZero(VerticalDot);
-		
-		if (HorizontalDegrees <= MinHorizontalDegreesToStartClimbing &&
-			!bIsCeiling && IsFacingSurface(VerticalDot))
+		if (CanStartClimbingSurface(UpdatedComponent->GetForwardVector(), Normal) &&
+			IsFacingSurface(FVector::DotProduct(Normal, Normal.GetSafeNormal2D())))
 		{
 			return true;
 		}
@@ -80,6 +165,20 @@ bool UMyCharacterMovementComponent::CanStartClimbing()
 	return false;
 }
 
+bool UMyCharacterMovementComponent::CanStartClimbingSurface(const FVector& Facing, const FVector& SurfaceNormal) const
+{
+	const FVector HorizontalNormal = SurfaceNormal.GetSafeNormal2D();
+
+	const float HorizontalDot = FVector::DotProduct(Facing, -HorizontalNormal);
+	const float VerticalDot = FVector::DotProduct(SurfaceNormal, HorizontalNormal);
+
+	const float HorizontalDegrees = FMath::RadiansToDegrees(FMath::Acos(HorizontalDot));
+
+	const bool bIsCeiling = FMath::IsNearlyZero(VerticalDot);
+
+	return HorizontalDegrees <= MinHorizontalDegreesToStartClimbing && !bIsCeiling;
+}
+
 bool UMyCharacterMovementComponent::IsFacingSurface(const float Steepness) const
 {
 	constexpr float BaseLength = 80;
@@ -92,13 +191,20 @@ bool UMyCharacterMovementComponent::EyeHeightTrace(const float TraceDistance) co
 {
 	FHitResult UpperEdgeHit;
 
+	FVector Start;
+	FVector End;
+	GetEyeHeightTraceSegment(TraceDistance, Start, End);
+
+	return BotwSceneQuery::LineTraceSingle(QueryCounter, GetWorld(), UpperEdgeHit, Start, End, ECC_Climbable, ClimbQueryParams);
+}
+
+void UMyCharacterMovementComponent::GetEyeHeightTraceSegment(float TraceDistance, FVector& OutStart, FVector& OutEnd) const
+{
 	const float BaseEyeHeight = GetCharacterOwner()->BaseEyeHeight;
 	const float EyeHeightOffset = IsClimbing() ? BaseEyeHeight + ClimbingCollisionShrinkAmount : BaseEyeHeight;
 	
-	const FVector Start = UpdatedComponent->GetComponentLocation() + UpdatedComponent->GetUpVector() * EyeHeightOffset;
-	const FVector End = Start + (UpdatedComponent->GetForwardVector() * TraceDistance);
-
-	return GetWorld()->LineTraceSingleByChannel(UpperEdgeHit, Start, End, ECC_WorldStatic, ClimbQueryParams);
+	OutStart = UpdatedComponent->GetComponentLocation() + UpdatedComponent->GetUpVector() * EyeHeightOffset;
+	OutEnd = OutStart + (UpdatedComponent->GetForwardVector() * TraceDistance);
 }
 
 void UMyCharacterMovementComponent::OnMovementUpdated(float DeltaSeconds, const FVector& OldLocation, const FVector& OldVelocity)
@@ -113,8 +219,23 @@ void UMyCharacterMovementComponent::OnMovementUpdated(float DeltaSeconds, const
 
 void UMyCharacterMovementComponent::OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode)
 {
+	// The capsule changes size, and the surface info of an earlier climb must not be reused.
+	WallContacts.Invalidate();
+	bSurfaceInfoDirty = true;
+	ClimbExit.Reset();
+
+	if (IsGliding())
+	{
+		GlideGroundHeights.Reset();
+	}
+
 	if (IsClimbing())
 	{
+		BotwFlightRecorder::Record(EBotwFlightEventType::ClimbStart, FlightRecorderId);
+		UBotwEventBusSubsystem::Push(EBotwGameplayEventType::ClimbStart, GetOwner(), nullptr, UpdatedComponent->GetComponentLocation());
+
+		ClimbStartQueries = QueryCounter.GetTotalQueries();
+		bLedgeUpBlocked = false;
 		bOrientRotationToMovement = false;
 	
 		UCapsuleComponent* Capsule = CharacterOwner->GetCapsuleComponent();
@@ -124,6 +245,10 @@ void UMyCharacterMovementComponent::OnMovementModeChanged(EMovementMode Previous
 	const bool bWasClimbing = PreviousMovementMode == MOVE_Custom && PreviousCustomMode == CMOVE_Climbing;
 	if (bWasClimbing)
 	{
+		BotwFlightRecorder::Record(EBotwFlightEventType::ClimbStop, FlightRecorderId);
+		UBotwEventBusSubsystem::Push(EBotwGameplayEventType::ClimbStop, GetOwner(), nullptr, UpdatedComponent->GetComponentLocation(),
+			FVector::ZeroVector, int32(QueryCounter.GetTotalQueries() - ClimbStartQueries));
+
 		bOrientRotationToMovement = true;
 
 		SetRotationToStand();
@@ -134,6 +259,18 @@ void UMyCharacterMovementComponent::OnMovementModeChanged(EMovementMode Previous
 		StopMovementImmediately();
 	}
 
+	// Something else, like falling off a moving platform, ended the ledge-up before the montage did.
+	const bool bWasLedgeClimbing = PreviousMovementMode == MOVE_Custom && PreviousCustomMode == CMOVE_LedgeClimbing;
+	if (bWasLedgeClimbing)
+	{
+		LedgeClimb.Reset();
+
+		if (AnimInstance && AnimInstance->Montage_IsPlaying(LedgeClimbMontage))
+		{
+			AnimInstance->Montage_Stop(0.2f, LedgeClimbMontage);
+		}
+	}
+
 	Super::OnMovementModeChanged(PreviousMovementMode, PreviousCustomMode);
 }
 
@@ -149,10 +286,35 @@ void UMyCharacterMovementComponent::PhysCustom(float deltaTime, int32 Iterations
 	{
 		PhysClimbing(deltaTime, Iterations);
 	}
+	else if (CustomMovementMode == ECustomMovementMode::CMOVE_Gliding)
+	{
+		PhysGliding(deltaTime, Iterations);
+	}
+	else if (CustomMovementMode == ECustomMovementMode::CMOVE_LedgeClimbing)
+	{
+		PhysLedgeClimbing(deltaTime, Iterations);
+	}
 	
 	Super::PhysCustom(deltaTime, Iterations);
 }
 
+void UMyCharacterMovementComponent::ServerMoveHandleClientError(float ClientTimeStamp, float DeltaTime, const FVector& Accel,
+	const FVector& RelativeClientLocation, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode)
+{
+	Super::ServerMoveHandleClientError(ClientTimeStamp, DeltaTime, Accel, RelativeClientLocation, ClientMovementBase,
+		ClientBaseBoneName, ClientMovementMode);
+
+	// The move is acked as good unless the server disagreed with the client's position.
+	const FNetworkPredictionData_Server_Character* ServerData = GetPredictionData_Server_Character();
+	if (ServerData && ServerData->PendingAdjustment.TimeStamp == ClientTimeStamp && !ServerData->PendingAdjustment.bAckGoodMove)
+	{
+		if (ABotwGameMode* GameMode = GetWorld()->GetAuthGameMode<ABotwGameMode>())
+		{
+			GameMode->AddMovementCorrection();
+		}
+	}
+}
+
 void UMyCharacterMovementComponent::UpdateClimbDashState(float deltaTime)
 {
 	if (!bIsClimbDashing)
@@ -179,66 +341,163 @@ void UMyCharacterMovementComponent::PhysClimbing(float deltaTime, int32 Iteratio
 		return;
 	}
 
+	BOTW_FLIGHT_PHASE(PhysClimbing, FlightRecorderId);
+
+	// Equal substeps keep the trajectory the same whether the movement ticks at 20 Hz on a server or 144 Hz locally.
+	const int32 NumSteps = FMath::Clamp(FMath::CeilToInt(deltaTime / MaxClimbingSimulationTimeStep), 1, MaxClimbingSimulationIterations);
+	const float TimeStep = deltaTime / NumSteps;
+
+	QueryCounter.SetSimulationSteps(NumSteps);
+
+	for (int32 Step = 0; Step < NumSteps; ++Step)
+	{
+		// The contacts were probed where the frame started; later substeps probe again once they moved past the tolerances.
+		if (Step > 0 && WallContacts.NeedsProbe(UpdatedComponent->GetComponentLocation(), UpdatedComponent->GetComponentQuat(),
+			ContactProbeDistanceTolerance, ContactProbeAngleTolerance, MaxContactAge))
+		{
+			ProbeWallContacts();
+		}
+
+		if (!StepClimbing(TimeStep, deltaTime - TimeStep * Step, Iterations + 1))
+		{
+			return;
+		}
+	}
+}
+
+bool UMyCharacterMovementComponent::StepClimbing(float TimeStep, float RemainingTime, int32 Iterations)
+{
 	ComputeSurfaceInfo();
 	
-	if (ShouldStopClimbing() || ClimbDownToFloor())
+	if (EvaluateClimbExit() != EBotwClimbExit::None)
 	{
-		StopClimbing(deltaTime, Iterations);
-		return;
+		StopClimbing(RemainingTime, Iterations);
+		return false;
 	}
 
-	UpdateClimbDashState(deltaTime);
+	UpdateClimbDashState(TimeStep);
 
-	ComputeClimbingVelocity(deltaTime);
+	ComputeClimbingVelocity(TimeStep);
 
 	const FVector OldLocation = UpdatedComponent->GetComponentLocation();
 	
-	MoveAlongClimbingSurface(deltaTime);
+	MoveAlongClimbingSurface(TimeStep);
 
-	TryClimbUpLedge();
+	if (TryClimbUpLedge())
+	{
+		StartNewPhysics(RemainingTime - TimeStep, Iterations);
+		return false;
+	}
 
 	if (!HasAnimRootMotion() && !CurrentRootMotion.HasOverrideVelocity())
 	{
-		Velocity = (UpdatedComponent->GetComponentLocation() - OldLocation) / deltaTime;
+		Velocity = (UpdatedComponent->GetComponentLocation() - OldLocation) / TimeStep;
 	}
 	
-	SnapToClimbingSurface(deltaTime);
+	SnapToClimbingSurface(TimeStep);
+
+	return IsClimbing();
 }
 
 void UMyCharacterMovementComponent::ComputeSurfaceInfo()
 {
+	BOTW_FLIGHT_PHASE(ClimbSurfaceInfo, FlightRecorderId);
+
+	const FVector Start = UpdatedComponent->GetComponentLocation();
+
+	// Same contacts as last time: carry the surface point along the wall instead of sweeping for it again.
+	if (!bSurfaceInfoDirty && !CurrentClimbingNormal.IsZero())
+	{
+		CurrentClimbingPosition += FVector::VectorPlaneProject(Start - SurfaceInfoLocation, CurrentClimbingNormal);
+		SurfaceInfoLocation = Start;
+		return;
+	}
+
+	bSurfaceInfoDirty = false;
+	SurfaceInfoLocation = Start;
+
 	CurrentClimbingNormal = FVector::ZeroVector;
 	CurrentClimbingPosition = FVector::ZeroVector;
 
-	if (CurrentWallHits.IsEmpty())
+	if (WallContacts.IsEmpty())
 	{
 		return;
 	}
 	
-	const FVector Start = UpdatedComponent->GetComponentLocation();
-	const FCollisionShape CollisionSphere = FCollisionShape::MakeSphere(6);
+	const FCollisionShape CollisionSphere = FCollisionShape::MakeSphere(BotwClimbing::AssistSphereRadius);
 	
-	for (const FHitResult& WallHit : CurrentWallHits)
+	// Each contact is probed on its own: walls it still reaches are refreshed, the others are dropped from the manifold.
+	int32 NumSurfaceContacts = 0;
+	uint32 LostContacts = 0;
+
+	int32 Index = 0;
+	for (const FBotwClimbContact& Contact : WallContacts)
 	{
-		const FVector End = Start + (WallHit.ImpactPoint - Start).GetSafeNormal() * 120;
+		const int32 ContactIndex = Index++;
+		const FVector End = Start + (FVector(Contact.Position) - Start).GetSafeNormal() * 120;
+
+		// Landscape cliffs are read from the heightfield, which also gives the exact normal instead of a sweep normal.
+		FVector LandscapePosition;
+		FVector LandscapeNormal;
+		const ALandscapeProxy* Landscape = Contact.Landscape.Get();
+		if (Landscape && BotwLandscapeSampler::RayMarch(*Landscape, Start, End, LandscapePosition, LandscapeNormal))
+		{
+			WallContacts.Confirm(ContactIndex, LandscapePosition, LandscapeNormal);
+			CurrentClimbingPosition += LandscapePosition + LandscapeNormal * BotwClimbing::AssistSphereRadius;
+			CurrentClimbingNormal += LandscapeNormal;
+			++NumSurfaceContacts;
+			continue;
+		}
 		
 		FHitResult AssistHit;
-		GetWorld()->SweepSingleByChannel(AssistHit, Start, End, FQuat::Identity,
-		                                 ECC_WorldStatic, CollisionSphere, ClimbQueryParams);
-		
+		BotwSceneQuery::SweepSingle(QueryCounter, GetWorld(), AssistHit, Start, End, FQuat::Identity,
+		                            ECC_Climbable, CollisionSphere, ClimbQueryParams);
+
+		if (!AssistHit.bBlockingHit)
+		{
+			LostContacts |= 1u << ContactIndex;
+			continue;
+		}
+
+		WallContacts.Confirm(ContactIndex, AssistHit.ImpactPoint, AssistHit.Normal);
 		CurrentClimbingPosition += AssistHit.Location;
 		CurrentClimbingNormal += AssistHit.Normal;
+		++NumSurfaceContacts;
+	}
+
+	WallContacts.Remove(LostContacts);
+
+	if (NumSurfaceContacts > 0)
+	{
+		CurrentClimbingPosition /= NumSurfaceContacts;
+		CurrentClimbingNormal = CurrentClimbingNormal.GetSafeNormal();
 	}
-	
-	CurrentClimbingPosition /= CurrentWallHits.Num();
-	CurrentClimbingNormal = CurrentClimbingNormal.GetSafeNormal();
 }
 
-bool UMyCharacterMovementComponent::ShouldStopClimbing() const
+EBotwClimbExit UMyCharacterMovementComponent::EvaluateClimbExit()
 {
-	const bool bIsOnCeiling = FVector::Parallel(CurrentClimbingNormal, FVector::UpVector);
-	
-	return !bWantsToClimb || CurrentClimbingNormal.IsZero() || bIsOnCeiling;
+	const EBotwClimbExit SurfaceExit = GetSurfaceExit();
+	if (SurfaceExit != EBotwClimbExit::None)
+	{
+		return SurfaceExit;
+	}
+
+	return ClimbDownToFloor() ? EBotwClimbExit::Floor : EBotwClimbExit::None;
+}
+
+EBotwClimbExit UMyCharacterMovementComponent::GetSurfaceExit() const
+{
+	if (!bWantsToClimb)
+	{
+		return EBotwClimbExit::Released;
+	}
+
+	if (CurrentClimbingNormal.IsZero())
+	{
+		return EBotwClimbExit::LostSurface;
+	}
+
+	return FVector::Parallel(CurrentClimbingNormal, FVector::UpVector) ? EBotwClimbExit::Ceiling : EBotwClimbExit::None;
 }
 
 void UMyCharacterMovementComponent::StopClimbing(float deltaTime, int32 Iterations)
@@ -250,14 +509,74 @@ void UMyCharacterMovementComponent::StopClimbing(float deltaTime, int32 Iteratio
 	StartNewPhysics(deltaTime, Iterations);
 }
 
-bool UMyCharacterMovementComponent::ClimbDownToFloor() const
+bool UMyCharacterMovementComponent::ClimbDownToFloor()
 {
+	if (!ShouldCheckFloor())
+	{
+		INC_DWORD_STAT(STAT_BotwClimbFloorTracesSkipped);
+		return false;
+	}
+
+	BOTW_FLIGHT_PHASE(ClimbFloorCheck, FlightRecorderId);
+	INC_DWORD_STAT(STAT_BotwClimbFloorTraces);
+
+	FVector Start;
+	FVector End;
+	GetFloorTraceSegment(Start, End);
+
 	FHitResult FloorHit;
-	if (!CheckFloor(FloorHit))
+	const bool bHitFloor = CheckFloor(FloorHit);
+
+	ClimbExit.FloorCheckLocation = Start;
+	ClimbExit.GroundZ = bHitFloor ? FloorHit.ImpactPoint.Z : 0.f;
+	ClimbExit.bGroundInRange = bHitFloor;
+	ClimbExit.bGroundKnown = true;
+
+	return bHitFloor && IsFloorExit(FloorHit);
+}
+
+bool UMyCharacterMovementComponent::ShouldCheckFloor() const
+{
+	if (!bSkipUnreachableFloorChecks)
+	{
+		return true;
+	}
+
+	// The fastest the character could be moving into any walkable floor; leaving the wall takes a third of the climbing speed.
+	const float MaxFloorSlope = FMath::Sqrt(FMath::Max(0.f, 1.f - FMath::Square(GetWalkableFloorZ())));
+	const float MaxDownSpeed = Velocity.Size2D() * MaxFloorSlope + FMath::Max(0.f, -Velocity.Z);
+
+	const bool bIsClimbingFloor = CurrentClimbingNormal.Z > GetWalkableFloorZ();
+	if (!bIsClimbingFloor && MaxDownSpeed < MaxClimbingSpeed / 3)
 	{
 		return false;
 	}
 
+	if (!ClimbExit.bGroundKnown)
+	{
+		return true;
+	}
+
+	FVector Start;
+	FVector End;
+	GetFloorTraceSegment(Start, End);
+
+	const float Drift = FVector::Dist2D(Start, ClimbExit.FloorCheckLocation);
+	if (Drift > FloorCheckDriftTolerance)
+	{
+		return true;
+	}
+
+	// Straight below the last trace the ground is where it hit, or out of its reach. Moving sideways, the ground can rise
+	// by a walkable slope or a step up; anything higher under the character is traced for once it drifts past the tolerance.
+	const float LastGroundZ = ClimbExit.bGroundInRange ? ClimbExit.GroundZ : ClimbExit.FloorCheckLocation.Z - FloorCheckDistance;
+	const float MaxGroundZ = LastGroundZ + Drift * MaxFloorSlope / FMath::Max(GetWalkableFloorZ(), UE_KINDA_SMALL_NUMBER) + MaxStepHeight;
+
+	return Start.Z - MaxGroundZ <= FloorCheckDistance + FloorCheckHeightMargin;
+}
+
+bool UMyCharacterMovementComponent::IsFloorExit(const FHitResult& FloorHit) const
+{
 	const bool bOnWalkableFloor = FloorHit.Normal.Z > GetWalkableFloorZ();
 	
 	const float DownSpeed = FVector::DotProduct(Velocity, -FloorHit.Normal);
@@ -270,31 +589,38 @@ bool UMyCharacterMovementComponent::ClimbDownToFloor() const
 
 bool UMyCharacterMovementComponent::CheckFloor(FHitResult& FloorHit) const
 {
-	const FVector Start = UpdatedComponent->GetComponentLocation() + (UpdatedComponent->GetUpVector() * - 20);
-	const FVector End = Start + FVector::DownVector * FloorCheckDistance;
+	FVector Start;
+	FVector End;
+	GetFloorTraceSegment(Start, End);
 
-	return GetWorld()->LineTraceSingleByChannel(FloorHit, Start, End, ECC_WorldStatic, ClimbQueryParams);
+	return BotwSceneQuery::LineTraceSingle(QueryCounter, GetWorld(), FloorHit, Start, End, ECC_WorldStatic, ClimbQueryParams);
+}
+
+void UMyCharacterMovementComponent::GetFloorTraceSegment(FVector& OutStart, FVector& OutEnd) const
+{
+	OutStart = UpdatedComponent->GetComponentLocation() + (UpdatedComponent->GetUpVector() * - 20);
+	OutEnd = OutStart + FVector::DownVector * FloorCheckDistance;
 }
 
 bool UMyCharacterMovementComponent::HasReachedEdge() const
 {
-	const UCapsuleComponent* Capsule = CharacterOwner->GetCapsuleComponent();
-	const float TraceDistance = Capsule->GetUnscaledCapsuleRadius() * 2.5f;
+	return !EyeHeightTrace(GetEdgeTraceDistance());
+}
 
-	return !EyeHeightTrace(TraceDistance);
+float UMyCharacterMovementComponent::GetEdgeTraceDistance() const
+{
+	return CharacterOwner->GetCapsuleComponent()->GetUnscaledCapsuleRadius() * 2.5f;
 }
 
-bool UMyCharacterMovementComponent::CanMoveToLedgeClimbLocation() const
+bool UMyCharacterMovementComponent::CanMoveToLedgeClimbLocation(FVector& OutLedgeGround) const
 {
 	const UCapsuleComponent* Capsule = CharacterOwner->GetCapsuleComponent();
 
-	// Could use a property instead for fine-tuning.
-	const FVector VerticalOffset = FVector::UpVector * 160.f;
-	const FVector HorizontalOffset = UpdatedComponent->GetForwardVector() * 100.f;
-
-	const FVector CheckLocation = UpdatedComponent->GetComponentLocation() + HorizontalOffset + VerticalOffset;
+	FVector CheckLocation;
+	FVector HorizontalOffset;
+	GetLedgeClimbCheck(CheckLocation, HorizontalOffset);
 	
-	if (!IsLocationWalkable(CheckLocation))
+	if (!IsLocationWalkable(CheckLocation, OutLedgeGround))
 	{
 		return false;
 	}
@@ -302,20 +628,30 @@ bool UMyCharacterMovementComponent::CanMoveToLedgeClimbLocation() const
 	FHitResult CapsuleHit;
 	const FVector CapsuleStartCheck = CheckLocation - HorizontalOffset;
 
-	const bool bBlocked = GetWorld()->SweepSingleByChannel(CapsuleHit, CapsuleStartCheck,CheckLocation,
+	const bool bBlocked = BotwSceneQuery::SweepSingle(QueryCounter, GetWorld(), CapsuleHit, CapsuleStartCheck,CheckLocation,
 		FQuat::Identity, ECC_WorldStatic, Capsule->GetCollisionShape(), ClimbQueryParams);
 	
 	return !bBlocked;
 }
 
-bool UMyCharacterMovementComponent::IsLocationWalkable(const FVector& CheckLocation) const
+void UMyCharacterMovementComponent::GetLedgeClimbCheck(FVector& OutCheckLocation, FVector& OutHorizontalOffset) const
+{
+	// Could use a property instead for fine-tuning.
+	const FVector VerticalOffset = FVector::UpVector * 160.f;
+	OutHorizontalOffset = UpdatedComponent->GetForwardVector() * 100.f;
+
+	OutCheckLocation = UpdatedComponent->GetComponentLocation() + OutHorizontalOffset + VerticalOffset;
+}
+
+bool UMyCharacterMovementComponent::IsLocationWalkable(const FVector& CheckLocation, FVector& OutGround) const
 {
 	const FVector CheckEnd = CheckLocation + (FVector::DownVector * 250);
 
 	FHitResult LedgeHit;
-	const bool bHitLedgeGround = GetWorld()->LineTraceSingleByChannel(LedgeHit, CheckLocation, CheckEnd,
-	                                                                  ECC_WorldStatic, ClimbQueryParams);
+	const bool bHitLedgeGround = BotwSceneQuery::LineTraceSingle(QueryCounter, GetWorld(), LedgeHit, CheckLocation, CheckEnd,
+	                                                             ECC_WorldStatic, ClimbQueryParams);
 
+	OutGround = LedgeHit.ImpactPoint;
 	return bHitLedgeGround && LedgeHit.Normal.Z >= GetWalkableFloorZ();
 }
 
@@ -360,7 +696,7 @@ void UMyCharacterMovementComponent::StopClimbDashing()
 
 float UMyCharacterMovementComponent::GetMaxSpeed() const
 {
-	return IsClimbing() ? MaxClimbingSpeed : Super::GetMaxSpeed();
+	return IsClimbing() ? MaxClimbingSpeed : IsGliding() ? GlideSpeed : Super::GetMaxSpeed();
 }
 
 float UMyCharacterMovementComponent::GetMaxAcceleration() const
@@ -370,17 +706,71 @@ float UMyCharacterMovementComponent::GetMaxAcceleration() const
 
 void UMyCharacterMovementComponent::MoveAlongClimbingSurface(float deltaTime)
 {
+	BOTW_FLIGHT_PHASE(ClimbMove, FlightRecorderId);
+
 	const FVector Adjusted = Velocity * deltaTime;
-	
+
+	const float MaxSubstepDistance = CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleRadius() * MaxClimbMoveRadiusFraction;
+	const int32 NumSubsteps = FMath::Clamp(FMath::CeilToInt(Adjusted.Size() / MaxSubstepDistance), 1, MaxClimbMoveSubsteps);
+
+	// Normal climbing speeds stay a single move; only dashes pay for the extra sweeps.
+	if (NumSubsteps == 1)
+	{
+		MoveClimbingSubstep(Adjusted, deltaTime);
+		return;
+	}
+
+	const float SubstepTime = deltaTime / NumSubsteps;
+
+	for (int32 Substep = 0; Substep < NumSubsteps; ++Substep)
+	{
+		if (Substep > 0 && !ReprojectOntoClimbingSurface())
+		{
+			// Past the edge of the wall: stop here and let the ledge and stop checks decide what comes next.
+			return;
+		}
+
+		MoveClimbingSubstep(Velocity * SubstepTime, SubstepTime);
+	}
+}
+
+void UMyCharacterMovementComponent::MoveClimbingSubstep(const FVector& Delta, float deltaTime)
+{
 	FHitResult Hit(1.f);
 	
-	SafeMoveUpdatedComponent(Adjusted, GetClimbingRotation(deltaTime), true, Hit);
+	{
+		FBotwQueryCounter::FScopedQuery Scope(QueryCounter);
+		SafeMoveUpdatedComponent(Delta, GetClimbingRotation(deltaTime), true, Hit);
+	}
 	
 	if (Hit.Time < 1.f)
 	{
-		HandleImpact(Hit, deltaTime, Adjusted);
-		SlideAlongSurface(Adjusted, (1.f - Hit.Time), Hit.Normal, Hit, true);
+		HandleImpact(Hit, deltaTime, Delta);
+
+		FBotwQueryCounter::FScopedQuery Scope(QueryCounter);
+		SlideAlongSurface(Delta, (1.f - Hit.Time), Hit.Normal, Hit, true);
+	}
+}
+
+bool UMyCharacterMovementComponent::ReprojectOntoClimbingSurface()
+{
+	const FVector Start = UpdatedComponent->GetComponentLocation();
+	const FVector End = Start - CurrentClimbingNormal * (DistanceFromSurface + CollisionCapsuleRadius);
+
+	FHitResult WallHit;
+	if (!BotwSceneQuery::LineTraceSingle(QueryCounter, GetWorld(), WallHit, Start, End, ECC_Climbable, ClimbQueryParams))
+	{
+		return false;
 	}
+
+	CurrentClimbingNormal = WallHit.Normal;
+	// Where the assist sweeps of ComputeSurfaceInfo would have stopped.
+	CurrentClimbingPosition = WallHit.ImpactPoint + WallHit.Normal * BotwClimbing::AssistSphereRadius;
+	SurfaceInfoLocation = Start;
+
+	Velocity = FVector::VectorPlaneProject(Velocity, CurrentClimbingNormal).GetSafeNormal() * Velocity.Size();
+
+	return true;
 }
 
 FQuat UMyCharacterMovementComponent::GetClimbingRotation(float deltaTime) const
@@ -395,12 +785,14 @@ FQuat UMyCharacterMovementComponent::GetClimbingRotation(float deltaTime) const
 	const FQuat Target = FRotationMatrix::MakeFromX(-CurrentClimbingNormal).ToQuat();
 	const float RotationSpeed = ClimbingRotationSpeed * FMath::Max(1, Velocity.Length() / MaxClimbingSpeed);
 
-	return FMath::QInterpTo(Current, Target, deltaTime, RotationSpeed);
+	return FQuat::Slerp(Current, Target, BotwClimbing::ExpDecayAlpha(RotationSpeed, deltaTime));
 }
 
-bool UMyCharacterMovementComponent::TryClimbUpLedge() const
+bool UMyCharacterMovementComponent::TryClimbUpLedge()
 {
-	if (AnimInstance && AnimInstance->Montage_IsPlaying(LedgeClimbMontage))
+	BOTW_FLIGHT_PHASE(ClimbLedgeCheck, FlightRecorderId);
+
+	if (!AnimInstance || !LedgeClimbMontage)
 	{
 		return false;
 	}
@@ -408,20 +800,101 @@ bool UMyCharacterMovementComponent::TryClimbUpLedge() const
 	const float UpSpeed = FVector::DotProduct(Velocity, UpdatedComponent->GetUpVector());
 	const bool bIsMovingUp = UpSpeed >= MaxClimbingSpeed / 3;
 	
-	if (bIsMovingUp && HasReachedEdge() && CanMoveToLedgeClimbLocation())
+	if (!bIsMovingUp)
 	{
-		SetRotationToStand();
-		
-		AnimInstance->Montage_Play(LedgeClimbMontage);
-		
-		return true;
+		return false;
+	}
+
+	if (!HasReachedEdge())
+	{
+		bLedgeUpBlocked = false;
+		return false;
 	}
+
+	FVector LedgeGround;
+	if (!CanMoveToLedgeClimbLocation(LedgeGround))
+	{
+		if (!bLedgeUpBlocked)
+		{
+			bLedgeUpBlocked = true;
+			UBotwEventBusSubsystem::Push(EBotwGameplayEventType::LedgeUpBlocked, GetOwner(), nullptr, UpdatedComponent->GetComponentLocation());
+		}
+
+		return false;
+	}
+
+	BotwFlightRecorder::Record(EBotwFlightEventType::LedgeUp, FlightRecorderId);
+	UBotwEventBusSubsystem::Push(EBotwGameplayEventType::LedgeUp, GetOwner(), nullptr, UpdatedComponent->GetComponentLocation());
+
+	bLedgeUpBlocked = false;
+	StartLedgeClimb(LedgeGround);
 	
-	return false;
+	return true;
+}
+
+void UMyCharacterMovementComponent::StartLedgeClimb(const FVector& LedgeGround)
+{
+	StopClimbDashing();
+	bWantsToClimb = false;
+
+	// Leaving the climb stands the character up and gives the capsule back its full height, which the targets use.
+	SetMovementMode(EMovementMode::MOVE_Custom, ECustomMovementMode::CMOVE_LedgeClimbing);
+
+	const float HalfHeight = CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+
+	LedgeClimb.Start = UpdatedComponent->GetComponentLocation();
+	LedgeClimb.LedgeTop = LedgeGround + FVector::UpVector * (HalfHeight + BotwClimbing::LedgeTopClearance);
+	LedgeClimb.WallTop = FVector(LedgeClimb.Start.X, LedgeClimb.Start.Y, LedgeClimb.LedgeTop.Z);
+	LedgeClimb.Forward = UpdatedComponent->GetForwardVector();
+
+	const FVector RootMotion = GetLedgeClimbRootMotion(LedgeClimbMontage->GetPlayLength());
+	LedgeClimb.RootMotionUp = RootMotion.Z;
+	LedgeClimb.RootMotionForward = FVector::DotProduct(RootMotion, LedgeClimb.Forward);
+
+	AnimInstance->Montage_Play(LedgeClimbMontage);
+}
+
+void UMyCharacterMovementComponent::PhysLedgeClimbing(float deltaTime, int32 Iterations)
+{
+	if (deltaTime < MIN_TICK_TIME)
+	{
+		return;
+	}
+
+	BOTW_FLIGHT_PHASE(PhysLedgeClimbing, FlightRecorderId);
+
+	const FAnimMontageInstance* Montage = AnimInstance ? AnimInstance->GetActiveInstanceForMontage(LedgeClimbMontage) : nullptr;
+	const bool bFinished = !Montage || Montage->IsStopped();
+
+	const FVector OldLocation = UpdatedComponent->GetComponentLocation();
+	const FVector NewLocation = bFinished
+		? LedgeClimb.LedgeTop
+		: LedgeClimb.GetWarpedLocation(GetLedgeClimbRootMotion(Montage->GetPosition()),
+			Montage->GetPosition() / FMath::Max(LedgeClimbMontage->GetPlayLength(), UE_KINDA_SMALL_NUMBER));
+
+	// Both targets were checked when the ledge-up started, so nothing is swept on the way there.
+	MoveUpdatedComponent(NewLocation - OldLocation, UpdatedComponent->GetComponentQuat(), false);
+
+	if (bFinished)
+	{
+		Velocity = FVector::ZeroVector;
+		SetMovementMode(EMovementMode::MOVE_Walking);
+		return;
+	}
+
+	Velocity = (UpdatedComponent->GetComponentLocation() - OldLocation) / deltaTime;
+}
+
+FVector UMyCharacterMovementComponent::GetLedgeClimbRootMotion(float Position) const
+{
+	const FTransform LocalRootMotion = LedgeClimbMontage->ExtractRootMotionFromTrackRange(0.f, Position);
+	return CharacterOwner->GetMesh()->ConvertLocalRootMotionToWorld(LocalRootMotion).GetTranslation();
 }
 
 void UMyCharacterMovementComponent::SnapToClimbingSurface(float deltaTime) const
 {
+	BOTW_FLIGHT_PHASE(ClimbSnap, FlightRecorderId);
+
 	const FVector Forward = UpdatedComponent->GetForwardVector();
 	const FVector Location = UpdatedComponent->GetComponentLocation();
 	const FQuat Rotation = UpdatedComponent->GetComponentQuat();
@@ -433,11 +906,23 @@ void UMyCharacterMovementComponent::SnapToClimbingSurface(float deltaTime) const
 	constexpr bool bSweep = true;
 
 	const float SnapSpeed = ClimbingSnapSpeed * ((Velocity.Length() / MaxClimbingSpeed) + 1);
-	UpdatedComponent->MoveComponent(Offset * SnapSpeed * deltaTime, Rotation, bSweep);
+
+	FBotwQueryCounter::FScopedQuery Scope(QueryCounter);
+	UpdatedComponent->MoveComponent(Offset * BotwClimbing::ExpDecayAlpha(SnapSpeed, deltaTime), Rotation, bSweep);
 }
 
 void UMyCharacterMovementComponent::TryClimbing()
 {
+	if (IsLedgeClimbing())
+	{
+		return;
+	}
+
+	if (IsGliding())
+	{
+		SweepAndStoreWallHits();
+	}
+
 	if (CanStartClimbing())
 	{
 		bWantsToClimb = true;
@@ -452,6 +937,9 @@ void UMyCharacterMovementComponent::TryClimbDashing()
 		CurrentClimbDashTime = 0.f;
 		
 		StoreClimbDashDirection();
+
+		UBotwEventBusSubsystem::Push(EBotwGameplayEventType::ClimbDash, GetOwner(), nullptr,
+			UpdatedComponent->GetComponentLocation(), ClimbDashDirection);
 	}
 }
 
@@ -486,6 +974,147 @@ bool UMyCharacterMovementComponent::IsClimbing() const
 	return MovementMode == EMovementMode::MOVE_Custom && CustomMovementMode == ECustomMovementMode::CMOVE_Climbing;
 }
 
+bool UMyCharacterMovementComponent::IsGliding() const
+{
+	return MovementMode == EMovementMode::MOVE_Custom && CustomMovementMode == ECustomMovementMode::CMOVE_Gliding;
+}
+
+bool UMyCharacterMovementComponent::IsLedgeClimbing() const
+{
+	return MovementMode == EMovementMode::MOVE_Custom && CustomMovementMode == ECustomMovementMode::CMOVE_LedgeClimbing;
+}
+
+void UMyCharacterMovementComponent::TryGliding()
+{
+	if (IsFalling() && TraceHeightAboveGround(MinGlideStartHeight) >= MinGlideStartHeight)
+	{
+		SetMovementMode(EMovementMode::MOVE_Custom, ECustomMovementMode::CMOVE_Gliding);
+	}
+}
+
+void UMyCharacterMovementComponent::CancelGliding()
+{
+	if (IsGliding())
+	{
+		SetMovementMode(EMovementMode::MOVE_Falling);
+	}
+}
+
+void UMyCharacterMovementComponent::PhysGliding(float deltaTime, int32 Iterations)
+{
+	if (deltaTime < MIN_TICK_TIME)
+	{
+		return;
+	}
+
+	RestorePreAdditiveRootMotionVelocity();
+
+	const FVector TargetVelocity = GetGlideTargetVelocity();
+	const FVector Delta = BotwClimbing::IntegrateGlide(Velocity, TargetVelocity, GlideResponse, deltaTime);
+
+	FHitResult Hit;
+	{
+		FBotwQueryCounter::FScopedQuery Scope(QueryCounter);
+		SafeMoveUpdatedComponent(Delta, UpdatedComponent->GetComponentQuat(), true, Hit);
+	}
+
+	if (Hit.bBlockingHit)
+	{
+		if (IsValidLandingSpot(UpdatedComponent->GetComponentLocation(), Hit))
+		{
+			ProcessLanded(Hit, deltaTime * (1.f - Hit.Time), Iterations);
+			return;
+		}
+
+		FBotwQueryCounter::FScopedQuery Scope(QueryCounter);
+		SlideAlongSurface(Delta, 1.f - Hit.Time, Hit.Normal, Hit, true);
+
+		Velocity = FVector::VectorPlaneProject(Velocity, Hit.Normal);
+	}
+
+	GlideHeightAboveGround = UpdateGlideHeight(TargetVelocity);
+
+	if (GlideHeightAboveGround <= GlideExitHeight)
+	{
+		SetMovementMode(EMovementMode::MOVE_Falling);
+	}
+}
+
+FVector UMyCharacterMovementComponent::GetGlideTargetVelocity() const
+{
+	// Steer with the input; without it, keep the current heading.
+	FVector Heading = Acceleration.GetSafeNormal2D();
+	if (Heading.IsNearlyZero())
+	{
+		Heading = Velocity.GetSafeNormal2D();
+	}
+	if (Heading.IsNearlyZero())
+	{
+		Heading = UpdatedComponent->GetForwardVector().GetSafeNormal2D();
+	}
+
+	return Heading * GlideSpeed + FVector::DownVector * GlideSinkSpeed;
+}
+
+float UMyCharacterMovementComponent::UpdateGlideHeight(const FVector& TargetVelocity)
+{
+	const FVector Location = UpdatedComponent->GetComponentLocation();
+
+	// At most one new sample per frame: the first cell along the predicted path that has none.
+	FVector PathVelocity = Velocity;
+	FVector PathLocation = Location;
+	const float StepTime = GlideLookaheadSeconds / BotwClimbing::GlideLookaheadSamples;
+
+	for (int32 Step = 0; Step <= BotwClimbing::GlideLookaheadSamples; ++Step)
+	{
+		if (!GlideGroundHeights.HasSample(PathLocation))
+		{
+			SampleGroundHeight(PathLocation);
+			break;
+		}
+
+		PathLocation += BotwClimbing::IntegrateGlide(PathVelocity, TargetVelocity, GlideResponse, StepTime);
+	}
+
+	float GroundZ = 0.f;
+	if (!GlideGroundHeights.GetGroundZ(Location, GroundZ))
+	{
+		return TraceHeightAboveGround(GlideRefineHeight);
+	}
+
+	const float FeetZ = Location.Z - CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+	const float EstimatedHeight = FeetZ - GroundZ;
+
+	return EstimatedHeight > GlideRefineHeight ? EstimatedHeight : TraceHeightAboveGround(GlideRefineHeight);
+}
+
+void UMyCharacterMovementComponent::SampleGroundHeight(const FVector& Location)
+{
+	const FVector Center = GlideGroundHeights.GetCellCenter(Location);
+	const FVector Start = Center + FVector::UpVector * BotwClimbing::GlideSampleHeadroom;
+	const FVector End = Center + FVector::DownVector * GlideMaxSampleDepth;
+
+	FHitResult Hit;
+	const bool bHit = BotwSceneQuery::LineTraceSingle(QueryCounter, GetWorld(), Hit, Start, End, ECC_Visibility, ClimbQueryParams);
+
+	GlideGroundHeights.AddSample(Location, bHit ? Hit.ImpactPoint.Z : End.Z);
+}
+
+float UMyCharacterMovementComponent::TraceHeightAboveGround(float MaxDistance) const
+{
+	const float HalfHeight = CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+	const FVector Start = UpdatedComponent->GetComponentLocation();
+	const FVector End = Start + FVector::DownVector * (HalfHeight + MaxDistance);
+
+	FHitResult Hit;
+	if (!BotwSceneQuery::LineTraceSingle(QueryCounter, GetWorld(), Hit, Start, End, ECC_Visibility, ClimbQueryParams))
+	{
+		return MaxDistance;
+	}
+
+	return FMath::Max(0.f, Hit.Distance - HalfHeight);
+}
+
 bool UMyCharacterMovementComponent::IsClimbDashing() const
 {
 	return IsClimbing() && bIsClimbDashing;
@@ -4,6 +4,11 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "BotwSceneQuery.h"
+#include "Climbing/BotwClimbContactManifold.h"
+#include "Climbing/BotwClimbExitState.h"
+#include "Climbing/BotwLedgeClimbState.h"
+#include "Gliding/BotwGroundHeightCache.h"
 #include "MyCharacterMovementComponent.generated.h"
 
 // Forward declaration
@@ -16,6 +21,8 @@ UCLASS()
 class BOTW_API UMyCharacterMovementComponent : public UCharacterMovementComponent
 {
 	GENERATED_BODY()
+
+	friend class FGameplayDebuggerCategory_BotwClimbing;
 	
 public:
 	UMyCharacterMovementComponent(const FObjectInitializer& ObjectInitializer);
@@ -41,6 +48,43 @@ public:
 	UFUNCTION(BlueprintCallable)
 	void CancelClimbing();
 
+	/** Pulling up over a ledge at the end of a climb, driven by the ledge-up montage. */
+	UFUNCTION(BlueprintPure)
+	bool IsLedgeClimbing() const;
+
+	UFUNCTION(BlueprintPure)
+	bool IsGliding() const;
+
+	/** Opens the glider when falling high enough above the ground. */
+	UFUNCTION(BlueprintCallable)
+	void TryGliding();
+
+	UFUNCTION(BlueprintCallable)
+	void CancelGliding();
+
+	/** Distance from the feet to the ground while gliding; coarse when far up, exact close to the ground. */
+	UFUNCTION(BlueprintPure)
+	float GetGlideHeightAboveGround() const { return GlideHeightAboveGround; }
+
+	/** Whether a wall with this normal can be climbed when approached facing Facing. Ignores the eye-height check. */
+	bool CanStartClimbingSurface(const FVector& Facing, const FVector& SurfaceNormal) const;
+
+	float GetMinHorizontalDegreesToStartClimbing() const { return MinHorizontalDegreesToStartClimbing; }
+
+	void SetSkipUnreachableFloorChecks(bool bSkip) { bSkipUnreachableFloorChecks = bSkip; }
+
+	/** Capsule swept every tick to find climbable walls. */
+	FCollisionShape GetClimbSweepShape() const;
+
+	/** Scene queries issued by this character this frame, shared with the owning character. */
+	FBotwQueryCounter& GetQueryCounter() const { return QueryCounter; }
+
+	/** State the queries of the current frame are budgeted for. */
+	EBotwQueryBudgetState GetQueryBudgetState() const;
+
+	/** Id of the owning character in flight recorder events. */
+	uint32 GetFlightRecorderId() const { return FlightRecorderId; }
+
 	UPROPERTY(BlueprintReadWrite, Category = "Character Movement: Punching")
 	bool bIsPunching;
 
@@ -63,6 +107,21 @@ private:
 	UPROPERTY(Category="Character Movement: Climbing", EditAnywhere, meta=(ClampMin="0.0", ClampMax="60.0"))
 	float ClimbingSnapSpeed = 4.f;
 
+	/** Longest step the climbing simulation takes; longer frames are split into equal substeps. */
+	UPROPERTY(Category="Character Movement: Climbing", EditAnywhere, meta=(ClampMin="0.0166", ClampMax="0.50", UIMin="0.0166", UIMax="0.05"))
+	float MaxClimbingSimulationTimeStep = 1.f / 60.f;
+
+	/** Upper bound on climbing substeps per frame, so a hitch cannot stall the game thread. */
+	UPROPERTY(Category="Character Movement: Climbing", EditAnywhere, meta=(ClampMin="1", ClampMax="25"))
+	int32 MaxClimbingSimulationIterations = 8;
+
+	/** Moves longer than this fraction of the capsule radius, like fast dashes, are split and follow the wall in between. */
+	UPROPERTY(Category="Character Movement: Climbing", EditAnywhere, meta=(ClampMin="0.1", ClampMax="2.0"))
+	float MaxClimbMoveRadiusFraction = 0.5f;
+
+	UPROPERTY(Category="Character Movement: Climbing", EditAnywhere, meta=(ClampMin="1", ClampMax="16"))
+	int32 MaxClimbMoveSubsteps = 6;
+
 	UPROPERTY(Category="Character Movement: Climbing", EditAnywhere, meta=(ClampMin="0.0", ClampMax="80.0"))
 	float DistanceFromSurface = 45.f;
 
@@ -78,6 +137,65 @@ private:
 	UPROPERTY(Category="Character Movement: Climbing", EditAnywhere, meta=(ClampMin="1.0", ClampMax="75.0"))
 	float MinHorizontalDegreesToStartClimbing = 25;
 
+	/** Distance the character may move before the wall contacts are swept again. */
+	UPROPERTY(Category="Character Movement: Climbing", EditAnywhere, meta=(ClampMin="0.0", ClampMax="50.0"))
+	float ContactProbeDistanceTolerance = 2.f;
+
+	/** Degrees the character may turn before the wall contacts are swept again. */
+	UPROPERTY(Category="Character Movement: Climbing", EditAnywhere, meta=(ClampMin="0.0", ClampMax="45.0"))
+	float ContactProbeAngleTolerance = 2.f;
+
+	/**
+	 * Skips floor traces that could not end the climb, judged from the velocity and what the last floor trace found.
+	 * Approximate: ground that moves or appears under a climbing character without it drifting is only found once the
+	 * character drifts past FloorCheckDriftTolerance, so it is off by default.
+	 */
+	UPROPERTY(Category="Character Movement: Climbing", EditAnywhere)
+	bool bSkipUnreachableFloorChecks = false;
+
+	/** Horizontal distance the character may move before the ground height from the last floor trace is checked again. */
+	UPROPERTY(Category="Character Movement: Climbing", EditAnywhere, meta=(ClampMin="0.0", ClampMax="200.0"))
+	float FloorCheckDriftTolerance = 30.f;
+
+	/** How far beyond the reach of the floor trace the estimated ground has to be before the trace is skipped. */
+	UPROPERTY(Category="Character Movement: Climbing", EditAnywhere, meta=(ClampMin="0.0", ClampMax="500.0"))
+	float FloorCheckHeightMargin = 50.f;
+
+	/** Frames the result of a wall sweep, hits or none, is trusted without sweeping again, so moving walls are still picked up. */
+	UPROPERTY(Category="Character Movement: Climbing", EditAnywhere, meta=(ClampMin="1", ClampMax="60"))
+	uint8 MaxContactAge = 8;
+
+	/** Horizontal speed the glider settles at. */
+	UPROPERTY(Category="Character Movement: Gliding", EditAnywhere, meta=(ClampMin="0.0", ClampMax="3000.0"))
+	float GlideSpeed = 900.f;
+
+	/** Vertical speed the glider settles at while sinking. */
+	UPROPERTY(Category="Character Movement: Gliding", EditAnywhere, meta=(ClampMin="0.0", ClampMax="2000.0"))
+	float GlideSinkSpeed = 250.f;
+
+	/** How quickly the velocity approaches the glide velocity, per second. */
+	UPROPERTY(Category="Character Movement: Gliding", EditAnywhere, meta=(ClampMin="0.1", ClampMax="20.0"))
+	float GlideResponse = 1.5f;
+
+	/** The glider only opens with at least this much air below the feet. */
+	UPROPERTY(Category="Character Movement: Gliding", EditAnywhere, meta=(ClampMin="0.0", ClampMax="2000.0"))
+	float MinGlideStartHeight = 250.f;
+
+	/** The glider closes this close to the ground, and the character lands by falling. */
+	UPROPERTY(Category="Character Movement: Gliding", EditAnywhere, meta=(ClampMin="0.0", ClampMax="500.0"))
+	float GlideExitHeight = 40.f;
+
+	/** Below this estimated height the ground is traced every frame instead of read from the ground-height cache. */
+	UPROPERTY(Category="Character Movement: Gliding", EditAnywhere, meta=(ClampMin="0.0", ClampMax="2000.0"))
+	float GlideRefineHeight = 400.f;
+
+	/** How far ahead along the glide path the ground-height cache is filled. */
+	UPROPERTY(Category="Character Movement: Gliding", EditAnywhere, meta=(ClampMin="0.0", ClampMax="5.0"))
+	float GlideLookaheadSeconds = 1.5f;
+
+	UPROPERTY(Category="Character Movement: Gliding", EditAnywhere, meta=(ClampMin="100.0", ClampMax="50000.0"))
+	float GlideMaxSampleDepth = 10000.f;
+
 	UPROPERTY(Category="Character Movement: Climbing", EditDefaultsOnly)
 	UAnimMontage* LedgeClimbMontage;
 
@@ -87,10 +205,20 @@ private:
 	UPROPERTY()
 	UAnimInstance* AnimInstance;
 	
-	TArray<FHitResult> CurrentWallHits;
+	FBotwClimbContactManifold WallContacts;
 
 	FCollisionQueryParams ClimbQueryParams;
 
+	mutable FBotwQueryCounter QueryCounter;
+
+	uint32 FlightRecorderId = 0;
+
+	/** QueryCounter total when the current climb started, for the queries per climb in telemetry. */
+	uint32 ClimbStartQueries = 0;
+
+	/** Set while the character is at a ledge it does not fit on, so LedgeUpBlocked is pushed once per ledge. */
+	bool bLedgeUpBlocked = false;
+
 	bool bWantsToClimb = false;
 
 	bool bIsClimbDashing = false;
@@ -103,6 +231,20 @@ private:
 	
 	FVector CurrentClimbingPosition;
 
+	/** Character location the surface info was last computed or carried over at. */
+	FVector SurfaceInfoLocation;
+
+	/** Set when the wall contacts were swept again since the surface info was computed. */
+	bool bSurfaceInfoDirty = true;
+
+	FBotwClimbExitState ClimbExit;
+
+	FBotwLedgeClimbState LedgeClimb;
+
+	FBotwGroundHeightCache GlideGroundHeights;
+
+	float GlideHeightAboveGround = 0.f;
+
 private:
 	virtual void BeginPlay() override;
 
@@ -117,28 +259,61 @@ private:
 	virtual float GetMaxAcceleration() const override;
 	
 	virtual void PhysCustom(float deltaTime, int32 Iterations) override;
-	
+
+	virtual void ServerMoveHandleClientError(float ClientTimeStamp, float DeltaTime, const FVector& Accel,
+		const FVector& RelativeClientLocation, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName,
+		uint8 ClientMovementMode) override;
+
 	void UpdateClimbDashState(float deltaTime);
 
 	void PhysClimbing(float deltaTime, int32 Iterations);
+
+	/** One climbing substep. Returns false once the character stopped climbing. */
+	bool StepClimbing(float TimeStep, float RemainingTime, int32 Iterations);
 	
 	bool EyeHeightTrace(const float TraceDistance) const;
+
+	void GetEyeHeightTraceSegment(float TraceDistance, FVector& OutStart, FVector& OutEnd) const;
+
+	void GetFloorTraceSegment(FVector& OutStart, FVector& OutEnd) const;
+
+	/** Where the capsule would stand after a ledge-up, and the offset it is swept in from. */
+	void GetLedgeClimbCheck(FVector& OutCheckLocation, FVector& OutHorizontalOffset) const;
+
+	float GetEdgeTraceDistance() const;
 	
-	bool ShouldStopClimbing() const;
+	/** Why the climb has to end before this substep, if it does. */
+	EBotwClimbExit EvaluateClimbExit();
+
+	EBotwClimbExit GetSurfaceExit() const;
 	
-	bool ClimbDownToFloor() const;
+	bool ClimbDownToFloor();
+
+	/** Whether a floor trace could end the climb, from the velocity and the ground height carried over from the last trace. */
+	bool ShouldCheckFloor() const;
+
+	bool IsFloorExit(const FHitResult& FloorHit) const;
 	
 	bool CheckFloor(FHitResult& FloorHit) const;
 	
 	void SetRotationToStand() const;
 	
-	bool TryClimbUpLedge() const;
+	bool TryClimbUpLedge();
+
+	/** Computes the ledge-up targets, leaves the climb and plays the montage. */
+	void StartLedgeClimb(const FVector& LedgeGround);
+
+	void PhysLedgeClimbing(float deltaTime, int32 Iterations);
+
+	/** World-space root motion of the ledge-up montage from its start up to Position. */
+	FVector GetLedgeClimbRootMotion(float Position) const;
 	
 	bool HasReachedEdge() const;
 	
-	bool IsLocationWalkable(const FVector& CheckLocation) const;
+	bool IsLocationWalkable(const FVector& CheckLocation, FVector& OutGround) const;
 	
-	bool CanMoveToLedgeClimbLocation() const;
+	/** Whether the capsule fits on the ledge ahead; OutLedgeGround is the walkable ground it would stand on. */
+	bool CanMoveToLedgeClimbLocation(FVector& OutLedgeGround) const;
 
 	bool CanStartClimbing();
 	
@@ -158,9 +333,30 @@ private:
 	
 	void MoveAlongClimbingSurface(float deltaTime);
 
+	void MoveClimbingSubstep(const FVector& Delta, float deltaTime);
+
+	/** Finds the wall behind the character again and turns the velocity along it. Returns false if the wall ended. */
+	bool ReprojectOntoClimbingSurface();
+
 	void SnapToClimbingSurface(float deltaTime) const;
+
+	void PhysGliding(float deltaTime, int32 Iterations);
+
+	FVector GetGlideTargetVelocity() const;
+
+	/** Fills the ground-height cache ahead of the glide path and returns the height above the ground. */
+	float UpdateGlideHeight(const FVector& TargetVelocity);
+
+	/** Traces down at the center of Location's cell and stores the result in the ground-height cache. */
+	void SampleGroundHeight(const FVector& Location);
+
+	/** Height of the feet above the first blocking surface below, or MaxDistance if there is none that close. */
+	float TraceHeightAboveGround(float MaxDistance) const;
 	
 	void ComputeSurfaceInfo();
 	
+	/** Probes the wall contacts if the character moved or turned past the tolerances, or keeps them another frame. */
 	void SweepAndStoreWallHits();
+
+	void ProbeWallContacts();
 };
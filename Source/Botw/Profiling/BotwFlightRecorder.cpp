@@ -0,0 +1,321 @@
+#include "BotwFlightRecorder.h"
+#include "../Botw.h"
+#include "Async/Async.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CommandLine.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "UObject/UObjectGlobals.h"
+#include <atomic>
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Flight recorder dumps"), STAT_BotwFlightRecorderDumps, STATGROUP_Botw);
+
+int32 BotwFlightRecorder::GEnabled = 1;
+
+static FAutoConsoleVariableRef CVarFlightRecorderEnable(
+	TEXT("botw.FlightRecorder.Enable"),
+	BotwFlightRecorder::GEnabled,
+	TEXT("Records gameplay events into the hitch flight recorder."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarFlightRecorderHitchMs(
+	TEXT("botw.FlightRecorder.HitchMs"),
+	100.f,
+	TEXT("Frames longer than this dump the flight recorder. 0 disables automatic dumps."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarFlightRecorderDumpSeconds(
+	TEXT("botw.FlightRecorder.DumpSeconds"),
+	5.f,
+	TEXT("How much history a flight recorder dump contains."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarFlightRecorderCooldownSeconds(
+	TEXT("botw.FlightRecorder.CooldownSeconds"),
+	30.f,
+	TEXT("Minimum time between automatic flight recorder dumps."),
+	ECVF_Default);
+
+static FAutoConsoleCommand CmdFlightRecorderDump(
+	TEXT("botw.FlightRecorder.Dump"),
+	TEXT("Writes the flight recorder history to Saved/Profiling/FlightRecorder now."),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		BotwFlightRecorder::Dump(0.f);
+	}));
+
+namespace BotwFlightRecorder
+{
+	constexpr uint32 FileMagic = 0x31524642; // "BFR1"
+
+	constexpr uint32 FileVersion = 1;
+
+	/** ~1.5MB of events; at a few hundred events per frame this covers well over DumpSeconds. */
+	constexpr uint32 CapacityLog2 = 16;
+
+	constexpr uint32 Capacity = 1u << CapacityLog2;
+
+	static FBotwFlightEvent Events[Capacity];
+
+	/**
+	 * Which lap of the ring the event in each slot was written in, plus one; 0 while the slot is being written.
+	 * Readers copy a slot only if its sequence is the one they expect before and after the copy.
+	 */
+	static std::atomic<uint32> Sequences[Capacity];
+
+	static std::atomic<uint64> WriteIndex{0};
+
+	static FCriticalSection NamesLock;
+
+	static TMap<FName, uint32> NameIds;
+
+	static TArray<FString> Names = { FString() };
+
+	static void Write(const FBotwFlightEvent& Event)
+	{
+		const uint64 Index = WriteIndex.fetch_add(1, std::memory_order_relaxed);
+		const uint32 Slot = Index & (Capacity - 1);
+
+		Sequences[Slot].store(0, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		Events[Slot] = Event;
+
+		Sequences[Slot].store(uint32(Index >> CapacityLog2) + 1, std::memory_order_release);
+	}
+
+	/** Copies the events that started at most Seconds ago, oldest first, skipping any that are being overwritten. */
+	static void Snapshot(double Seconds, TArray<FBotwFlightEvent>& OutEvents)
+	{
+		const uint64 End = WriteIndex.load(std::memory_order_acquire);
+		const uint64 Begin = End > Capacity ? End - Capacity : 0;
+		const uint64 MinCycles = FPlatformTime::Cycles64() - uint64(Seconds / FPlatformTime::GetSecondsPerCycle64());
+
+		OutEvents.Reserve(int32(End - Begin));
+
+		for (uint64 Index = Begin; Index < End; ++Index)
+		{
+			const uint32 Slot = Index & (Capacity - 1);
+			const uint32 Expected = uint32(Index >> CapacityLog2) + 1;
+
+			if (Sequences[Slot].load(std::memory_order_acquire) != Expected)
+			{
+				continue;
+			}
+
+			const FBotwFlightEvent Event = Events[Slot];
+
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (Sequences[Slot].load(std::memory_order_relaxed) == Expected && Event.Cycles >= MinCycles)
+			{
+				OutEvents.Add(Event);
+			}
+		}
+	}
+
+	static void Serialize(FArchive& Ar, FDump& Dump)
+	{
+		uint32 Magic = FileMagic;
+		uint32 Version = FileVersion;
+		Ar << Magic << Version;
+
+		if (Ar.IsLoading() && (Magic != FileMagic || Version != FileVersion))
+		{
+			Ar.SetError();
+			return;
+		}
+
+		Ar << Dump.SecondsPerCycle << Dump.HitchMs << Dump.Names;
+
+		int32 NumEvents = Dump.Events.Num();
+		Ar << NumEvents;
+
+		if (Ar.IsLoading())
+		{
+			if (NumEvents < 0 || int64(NumEvents) * sizeof(FBotwFlightEvent) > Ar.TotalSize() - Ar.Tell())
+			{
+				Ar.SetError();
+				return;
+			}
+
+			Dump.Events.SetNumUninitialized(NumEvents);
+		}
+
+		Ar.Serialize(Dump.Events.GetData(), NumEvents * sizeof(FBotwFlightEvent));
+	}
+}
+
+uint32 BotwFlightRecorder::RegisterName(FName Name)
+{
+	if (Name.IsNone())
+	{
+		return 0;
+	}
+
+	FScopeLock Lock(&NamesLock);
+
+	if (const uint32* Id = NameIds.Find(Name))
+	{
+		return *Id;
+	}
+
+	const uint32 Id = Names.Add(Name.ToString());
+	NameIds.Add(Name, Id);
+	return Id;
+}
+
+uint32 BotwFlightRecorder::GetObjectId(const UObject* Object)
+{
+	return Object ? RegisterName(Object->GetFName()) : 0;
+}
+
+void BotwFlightRecorder::Record(EBotwFlightEventType Type, uint32 Object, uint32 Name)
+{
+	if (!GEnabled)
+	{
+		return;
+	}
+
+	FBotwFlightEvent Event;
+	Event.Cycles = FPlatformTime::Cycles64();
+	Event.Name = Name;
+	Event.Object = Object;
+	Event.Type = Type;
+
+	Write(Event);
+}
+
+void BotwFlightRecorder::RecordPhase(uint32 Name, uint32 Object, uint64 StartCycles, uint64 EndCycles)
+{
+	FBotwFlightEvent Event;
+	Event.Cycles = StartCycles;
+	Event.Duration = uint32(FMath::Min<uint64>(EndCycles - StartCycles, MAX_uint32));
+	Event.Name = Name;
+	Event.Object = Object;
+	Event.Type = EBotwFlightEventType::Phase;
+
+	Write(Event);
+}
+
+FString BotwFlightRecorder::Dump(float HitchMs)
+{
+	FDump Dump;
+	Dump.SecondsPerCycle = FPlatformTime::GetSecondsPerCycle64();
+	Dump.HitchMs = HitchMs;
+
+	Snapshot(CVarFlightRecorderDumpSeconds.GetValueOnAnyThread(), Dump.Events);
+
+	{
+		FScopeLock Lock(&NamesLock);
+		Dump.Names = Names;
+	}
+
+	const FString Filename = FPaths::ProfilingDir() / TEXT("FlightRecorder") /
+		FString::Printf(TEXT("Hitch_%s_%.0fms.bfr"), *FDateTime::Now().ToString(), HitchMs);
+
+	UE_LOG(LogBotw, Log, TEXT("Writing %d flight recorder events to %s"), Dump.Events.Num(), *Filename);
+	INC_DWORD_STAT(STAT_BotwFlightRecorderDumps);
+
+	// The frame is already slow; serializing and writing happen off the game thread.
+	Async(EAsyncExecution::ThreadPool, [Dump = MoveTemp(Dump), Filename]() mutable
+	{
+		TArray<uint8> Bytes;
+		FMemoryWriter Writer(Bytes);
+		Serialize(Writer, Dump);
+
+		FFileHelper::SaveArrayToFile(Bytes, *Filename);
+	});
+
+	return Filename;
+}
+
+bool BotwFlightRecorder::LoadDump(const FString& Filename, FDump& OutDump)
+{
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *Filename))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Bytes);
+	Serialize(Reader, OutDump);
+
+	return !Reader.IsError();
+}
+
+const TCHAR* BotwFlightRecorder::GetEventTypeName(EBotwFlightEventType Type)
+{
+	switch (Type)
+	{
+	case EBotwFlightEventType::Frame: return TEXT("Frame");
+	case EBotwFlightEventType::Phase: return TEXT("Phase");
+	case EBotwFlightEventType::ClimbStart: return TEXT("ClimbStart");
+	case EBotwFlightEventType::ClimbStop: return TEXT("ClimbStop");
+	case EBotwFlightEventType::LedgeUp: return TEXT("LedgeUp");
+	case EBotwFlightEventType::PunchBegin: return TEXT("PunchBegin");
+	case EBotwFlightEventType::PunchEnd: return TEXT("PunchEnd");
+	case EBotwFlightEventType::Ragdoll: return TEXT("Ragdoll");
+	case EBotwFlightEventType::SyncLoad: return TEXT("SyncLoad");
+	case EBotwFlightEventType::Hitch: return TEXT("Hitch");
+	default: return TEXT("Unknown");
+	}
+}
+
+bool UBotwFlightRecorderSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// Editor frames hitch all the time; PIE sessions can opt in with -BotwFlightRecorder.
+	return !IsRunningCommandlet() && (!GIsEditor || FParse::Param(FCommandLine::Get(), TEXT("BotwFlightRecorder")));
+}
+
+void UBotwFlightRecorderSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	EndFrameHandle = FCoreDelegates::OnEndFrame.AddUObject(this, &UBotwFlightRecorderSubsystem::OnEndFrame);
+	SyncLoadHandle = FCoreUObjectDelegates::OnSyncLoadPackage.AddUObject(this, &UBotwFlightRecorderSubsystem::OnSyncLoadPackage);
+}
+
+void UBotwFlightRecorderSubsystem::Deinitialize()
+{
+	FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+	FCoreUObjectDelegates::OnSyncLoadPackage.Remove(SyncLoadHandle);
+
+	Super::Deinitialize();
+}
+
+void UBotwFlightRecorderSubsystem::OnEndFrame()
+{
+	const uint64 Now = FPlatformTime::Cycles64();
+	const uint64 FrameStart = LastFrameCycles;
+	LastFrameCycles = Now;
+
+	if (!BotwFlightRecorder::GEnabled || FrameStart == 0)
+	{
+		return;
+	}
+
+	FBotwFlightEvent Frame;
+	Frame.Cycles = FrameStart;
+	Frame.Duration = uint32(FMath::Min<uint64>(Now - FrameStart, MAX_uint32));
+	Frame.Type = EBotwFlightEventType::Frame;
+	BotwFlightRecorder::Write(Frame);
+
+	const float HitchMs = CVarFlightRecorderHitchMs.GetValueOnGameThread();
+	const float FrameMs = FPlatformTime::ToMilliseconds64(Now - FrameStart);
+
+	if (HitchMs > 0.f && FrameMs > HitchMs && Now >= NextDumpCycles)
+	{
+		BotwFlightRecorder::Record(EBotwFlightEventType::Hitch);
+		BotwFlightRecorder::Dump(FrameMs);
+
+		NextDumpCycles = Now + uint64(CVarFlightRecorderCooldownSeconds.GetValueOnGameThread() / FPlatformTime::GetSecondsPerCycle64());
+	}
+}
+
+void UBotwFlightRecorderSubsystem::OnSyncLoadPackage(const FString& PackageName)
+{
+	BotwFlightRecorder::Record(EBotwFlightEventType::SyncLoad, 0, BotwFlightRecorder::RegisterName(FName(*PackageName)));
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "BotwFlightRecorder.generated.h"
+
+enum class EBotwFlightEventType : uint8
+{
+	/** One game frame, from the end of the previous one. */
+	Frame,
+	/** A timed section of a hot path; Name is the phase. */
+	Phase,
+	ClimbStart,
+	ClimbStop,
+	LedgeUp,
+	PunchBegin,
+	PunchEnd,
+	Ragdoll,
+	/** Name is the package. */
+	SyncLoad,
+	/** The frame that triggered a dump. */
+	Hitch,
+	Num
+};
+
+/** One entry of the recorder ring. Names and objects are ids into the recorder's name table, 0 meaning none. */
+struct FBotwFlightEvent
+{
+	uint64 Cycles = 0;
+
+	/** Length of phases and frames in cycles. */
+	uint32 Duration = 0;
+
+	uint32 Name = 0;
+
+	uint32 Object = 0;
+
+	EBotwFlightEventType Type = EBotwFlightEventType::Phase;
+
+	uint8 Padding[3] = {};
+};
+
+static_assert(sizeof(FBotwFlightEvent) == 24, "Flight recorder events are written to dumps as raw bytes");
+
+/**
+ * Always-on recorder of cheap timestamped gameplay events. Events go into a fixed lock-free ring that any thread can
+ * write to; when a frame takes longer than botw.FlightRecorder.HitchMs, the last botw.FlightRecorder.DumpSeconds of it
+ * are written to Saved/Profiling/FlightRecorder/*.bfr in the background. Convert dumps to Chrome trace JSON with
+ * UBotwFlightRecorderCommandlet.
+ */
+namespace BotwFlightRecorder
+{
+	extern BOTW_API int32 GEnabled;
+
+	/** Returns the id of a name for the events, registering it on first use. Takes a lock; cache ids on hot paths. */
+	BOTW_API uint32 RegisterName(FName Name);
+
+	BOTW_API uint32 GetObjectId(const UObject* Object);
+
+	BOTW_API void Record(EBotwFlightEventType Type, uint32 Object = 0, uint32 Name = 0);
+
+	BOTW_API void RecordPhase(uint32 Name, uint32 Object, uint64 StartCycles, uint64 EndCycles);
+
+	/** Writes the last DumpSeconds of events to a new file in the background; returns its name. */
+	BOTW_API FString Dump(float HitchMs);
+
+	/** Dump file contents. Event names and objects index Names. */
+	struct FDump
+	{
+		double SecondsPerCycle = 0.0;
+
+		float HitchMs = 0.f;
+
+		TArray<FString> Names;
+
+		TArray<FBotwFlightEvent> Events;
+	};
+
+	BOTW_API bool LoadDump(const FString& Filename, FDump& OutDump);
+
+	BOTW_API const TCHAR* GetEventTypeName(EBotwFlightEventType Type);
+}
+
+/** Records the time spent in its scope as a phase. */
+struct FBotwFlightPhaseScope
+{
+	FBotwFlightPhaseScope(uint32 InName, uint32 InObject)
+		: Name(InName)
+		, Object(InObject)
+		, StartCycles(BotwFlightRecorder::GEnabled ? FPlatformTime::Cycles64() : 0)
+	{
+	}
+
+	~FBotwFlightPhaseScope()
+	{
+		if (StartCycles != 0)
+		{
+			BotwFlightRecorder::RecordPhase(Name, Object, StartCycles, FPlatformTime::Cycles64());
+		}
+	}
+
+	UE_NONCOPYABLE(FBotwFlightPhaseScope);
+
+private:
+	uint32 Name;
+
+	uint32 Object;
+
+	uint64 StartCycles;
+};
+
+#define BOTW_FLIGHT_PHASE(PhaseName, ObjectId) \
+	static const uint32 PREPROCESSOR_JOIN(BotwFlightPhaseName_, __LINE__) = BotwFlightRecorder::RegisterName(TEXT(#PhaseName)); \
+	const FBotwFlightPhaseScope PREPROCESSOR_JOIN(BotwFlightPhase_, __LINE__)(PREPROCESSOR_JOIN(BotwFlightPhaseName_, __LINE__), ObjectId)
+
+/** Hooks the recorder up to the end of every frame and to synchronous package loads. */
+UCLASS()
+class BOTW_API UBotwFlightRecorderSubsystem : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+private:
+	void OnEndFrame();
+
+	void OnSyncLoadPackage(const FString& PackageName);
+
+	FDelegateHandle EndFrameHandle;
+
+	FDelegateHandle SyncLoadHandle;
+
+	uint64 LastFrameCycles = 0;
+
+	uint64 NextDumpCycles = 0;
+};
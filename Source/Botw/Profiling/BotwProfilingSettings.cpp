@@ -0,0 +1,9 @@
+#include "BotwProfilingSettings.h"
+
+const FBotwProfilingRoute* UBotwProfilingSettings::FindRoute(const FString& MapName) const
+{
+	return Routes.FindByPredicate([&MapName](const FBotwProfilingRoute& Route)
+	{
+		return Route.MapName == MapName;
+	});
+}
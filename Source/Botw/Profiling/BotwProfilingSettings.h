@@ -0,0 +1,43 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DeveloperSettings.h"
+#include "../Bots/BotwBotPlayerController.h"
+#include "BotwProfilingSettings.generated.h"
+
+USTRUCT()
+struct FBotwProfilingRoute
+{
+	GENERATED_BODY()
+
+	/** Short map name the route belongs to, e.g. CastleEnvironment. */
+	UPROPERTY(EditAnywhere, Category = "Profiling")
+	FString MapName;
+
+	UPROPERTY(EditAnywhere, Category = "Profiling")
+	TArray<FBotwBotAction> Actions;
+
+	UPROPERTY(EditAnywhere, Category = "Profiling")
+	int32 Loops = 1;
+};
+
+/** Fixed bot routes used by the scripted profiling run (-BotwProfileRoute). */
+UCLASS(config = Game, defaultconfig, meta = (DisplayName = "Botw Profiling"))
+class BOTW_API UBotwProfilingSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+	const FBotwProfilingRoute* FindRoute(const FString& MapName) const;
+
+	UPROPERTY(config, EditAnywhere, Category = "Profiling")
+	TArray<FBotwProfilingRoute> Routes;
+
+	/** Seconds to let streaming and shader work settle before capturing. */
+	UPROPERTY(config, EditAnywhere, Category = "Profiling")
+	float WarmupSeconds = 5.f;
+
+	/** Hard limit on the capture, in case the bot gets stuck. */
+	UPROPERTY(config, EditAnywhere, Category = "Profiling")
+	float MaxRouteSeconds = 300.f;
+};
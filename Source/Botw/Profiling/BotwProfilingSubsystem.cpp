@@ -0,0 +1,216 @@
+#include "BotwProfilingSubsystem.h"
+#include "BotwProfilingSettings.h"
+#include "../Botw.h"
+#include "../Bots/BotwBotPlayerController.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+void FBotwPhysicsMarkerTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	*Stamp = FPlatformTime::Seconds();
+}
+
+bool UBotwProfilingSubsystem::IsProfilingRun()
+{
+	static const bool bProfilingRun = FParse::Param(FCommandLine::Get(), TEXT("BotwProfileRoute"));
+	return bProfilingRun;
+}
+
+bool UBotwProfilingSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return IsProfilingRun() && Super::ShouldCreateSubsystem(Outer);
+}
+
+bool UBotwProfilingSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UBotwProfilingSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	MapName = UWorld::RemovePIEPrefix(InWorld.GetMapName());
+
+	PhysicsStartMarker.Stamp = &PhysicsStartTime;
+	PhysicsStartMarker.TickGroup = TG_StartPhysics;
+	PhysicsStartMarker.bCanEverTick = true;
+	PhysicsStartMarker.bHighPriority = true;
+	PhysicsStartMarker.RegisterTickFunction(InWorld.PersistentLevel);
+
+	// Runs once the game thread has waited for the physics results of this frame.
+	PhysicsEndMarker.Stamp = &PhysicsEndTime;
+	PhysicsEndMarker.TickGroup = TG_EndPhysics;
+	PhysicsEndMarker.bCanEverTick = true;
+	PhysicsEndMarker.AddPrerequisite(&InWorld, InWorld.EndPhysicsTickFunction);
+	PhysicsEndMarker.RegisterTickFunction(InWorld.PersistentLevel);
+
+	if (!GetDefault<UBotwProfilingSettings>()->FindRoute(MapName))
+	{
+		UE_LOG(LogBotw, Error, TEXT("No profiling route configured for %s"), *MapName);
+		bFinished = true;
+		FPlatformMisc::RequestExit(false);
+	}
+}
+
+void UBotwProfilingSubsystem::Deinitialize()
+{
+	if (bCapturing)
+	{
+		FinishCapture();
+	}
+
+	PhysicsStartMarker.UnRegisterTickFunction();
+	PhysicsEndMarker.UnRegisterTickFunction();
+
+	Super::Deinitialize();
+}
+
+TStatId UBotwProfilingSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UBotwProfilingSubsystem, STATGROUP_Tickables);
+}
+
+ABotwBotPlayerController* UBotwProfilingSubsystem::GetBotController() const
+{
+	return Cast<ABotwBotPlayerController>(GetWorld()->GetFirstPlayerController());
+}
+
+void UBotwProfilingSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (bFinished || !GetWorld()->HasBegunPlay())
+	{
+		return;
+	}
+
+	const UBotwProfilingSettings* Settings = GetDefault<UBotwProfilingSettings>();
+	ElapsedSeconds += DeltaTime;
+
+	if (!bRouteStarted)
+	{
+		ABotwBotPlayerController* Bot = GetBotController();
+		if (ElapsedSeconds < Settings->WarmupSeconds || !Bot || !Bot->GetPawn())
+		{
+			return;
+		}
+
+		const FBotwProfilingRoute* Route = Settings->FindRoute(MapName);
+		Bot->SetActions(Route->Actions, Route->Loops);
+
+		bRouteStarted = true;
+		ElapsedSeconds = 0.f;
+
+		StartCapture();
+		return;
+	}
+
+	FFrameSample& Sample = Samples.AddDefaulted_GetRef();
+	Sample.FrameMs = FApp::GetDeltaTime() * 1000.f;
+	Sample.GameThreadMs = FPlatformTime::ToMilliseconds(GGameThreadTime);
+	Sample.PhysicsMs = PhysicsEndTime >= PhysicsStartTime ? (PhysicsEndTime - PhysicsStartTime) * 1000.f : 0.f;
+
+	const ABotwBotPlayerController* Bot = GetBotController();
+	if (!Bot || Bot->IsFinished() || ElapsedSeconds >= Settings->MaxRouteSeconds)
+	{
+		if (ElapsedSeconds >= Settings->MaxRouteSeconds)
+		{
+			UE_LOG(LogBotw, Warning, TEXT("Profiling route on %s hit the %.0fs limit before finishing"), *MapName, Settings->MaxRouteSeconds);
+		}
+
+		FinishCapture();
+		FPlatformMisc::RequestExit(false);
+	}
+}
+
+void UBotwProfilingSubsystem::StartCapture()
+{
+	UE_LOG(LogBotw, Display, TEXT("Starting profiling route on %s"), *MapName);
+
+#if CSV_PROFILER
+	if (FCsvProfiler* CsvProfiler = FCsvProfiler::Get())
+	{
+		CsvProfiler->BeginCapture(-1, FString(), FString::Printf(TEXT("BotwRoute_%s.csv"), *MapName));
+	}
+#endif
+
+	GEngine->Exec(GetWorld(), TEXT("stat startfile"));
+
+	bCapturing = true;
+}
+
+void UBotwProfilingSubsystem::FinishCapture()
+{
+	bCapturing = false;
+	bFinished = true;
+
+#if CSV_PROFILER
+	if (FCsvProfiler* CsvProfiler = FCsvProfiler::Get())
+	{
+		CsvProfiler->EndCapture();
+	}
+#endif
+
+	GEngine->Exec(GetWorld(), TEXT("stat stopfile"));
+
+	WriteSummary();
+}
+
+void UBotwProfilingSubsystem::WriteSummary() const
+{
+	if (Samples.IsEmpty())
+	{
+		UE_LOG(LogBotw, Warning, TEXT("Profiling route on %s captured no frames"), *MapName);
+		return;
+	}
+
+	auto Summarize = [this](const TCHAR* Name, float FFrameSample::* Field)
+	{
+		TArray<float> Values;
+		Values.Reserve(Samples.Num());
+
+		double Total = 0.0;
+		for (const FFrameSample& Sample : Samples)
+		{
+			Values.Add(Sample.*Field);
+			Total += Sample.*Field;
+		}
+
+		Values.Sort();
+
+		auto Percentile = [&Values](float Fraction)
+		{
+			return Values[FMath::Clamp(FMath::CeilToInt(Fraction * Values.Num()) - 1, 0, Values.Num() - 1)];
+		};
+
+		return FString::Printf(TEXT("%s,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n"), Name, Total / Values.Num(),
+			Percentile(0.5f), Percentile(0.9f), Percentile(0.95f), Percentile(0.99f), Values.Last());
+	};
+
+	float RouteSeconds = 0.f;
+	for (const FFrameSample& Sample : Samples)
+	{
+		RouteSeconds += Sample.FrameMs / 1000.f;
+	}
+
+	FString Summary = FString::Printf(TEXT("# Map=%s Build=%s Changelist=%u Frames=%d Seconds=%.1f\n"), *MapName,
+		FApp::GetBuildVersion(), FEngineVersion::Current().GetChangelist(), Samples.Num(), RouteSeconds);
+	Summary += TEXT("Metric,Mean,P50,P90,P95,P99,Max\n");
+	Summary += Summarize(TEXT("FrameMs"), &FFrameSample::FrameMs);
+	Summary += Summarize(TEXT("GameThreadMs"), &FFrameSample::GameThreadMs);
+	Summary += Summarize(TEXT("PhysicsMs"), &FFrameSample::PhysicsMs);
+
+	const FString Filename = FPaths::ProfilingDir() / TEXT("BotwRoute") /
+		FString::Printf(TEXT("%s_%s.csv"), *MapName, *FDateTime::Now().ToString());
+
+	FFileHelper::SaveStringToFile(Summary, *Filename);
+
+	UE_LOG(LogBotw, Display, TEXT("Profiling route summary written to %s\n%s"), *Filename, *Summary);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "BotwProfilingSubsystem.generated.h"
+
+class ABotwBotPlayerController;
+
+/** Stamps the time when the physics tick groups are reached, to measure the physics span of each frame. */
+struct FBotwPhysicsMarkerTickFunction : public FTickFunction
+{
+	double* Stamp = nullptr;
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+
+	virtual FString DiagnosticMessage() override { return TEXT("FBotwPhysicsMarkerTickFunction"); }
+};
+
+/**
+ * Runs the fixed bot route of the current map and records frame, game thread and physics times.
+ * Only active with -BotwProfileRoute; meant for headless runs with -nullrhi, see Scripts/ProfileRoute.sh.
+ * Captures a CSV profile and a stat file, then writes a percentile summary to Saved/Profiling/BotwRoute and exits.
+ */
+UCLASS()
+class BOTW_API UBotwProfilingSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static bool IsProfilingRun();
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FFrameSample
+	{
+		float FrameMs;
+		float GameThreadMs;
+		float PhysicsMs;
+	};
+
+	void StartCapture();
+
+	void FinishCapture();
+
+	void WriteSummary() const;
+
+	ABotwBotPlayerController* GetBotController() const;
+
+	FString MapName;
+
+	TArray<FFrameSample> Samples;
+
+	FBotwPhysicsMarkerTickFunction PhysicsStartMarker;
+
+	FBotwPhysicsMarkerTickFunction PhysicsEndMarker;
+
+	double PhysicsStartTime = 0.0;
+
+	double PhysicsEndTime = 0.0;
+
+	float ElapsedSeconds = 0.f;
+
+	bool bRouteStarted = false;
+
+	bool bCapturing = false;
+
+	bool bFinished = false;
+};
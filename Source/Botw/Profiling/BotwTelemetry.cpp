@@ -0,0 +1,207 @@
+#include "BotwTelemetry.h"
+#include "../Botw.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+
+DECLARE_CYCLE_STAT(TEXT("Telemetry append"), STAT_BotwTelemetryAppend, STATGROUP_Botw);
+DECLARE_CYCLE_STAT(TEXT("Telemetry flush"), STAT_BotwTelemetryFlush, STATGROUP_Botw);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Telemetry records"), STAT_BotwTelemetryRecords, STATGROUP_Botw);
+
+static TAutoConsoleVariable<bool> CVarTelemetryEnable(
+	TEXT("botw.Telemetry.Enable"),
+	false,
+	TEXT("Records gameplay events to Saved/Profiling/Telemetry. Takes effect when the next map starts; -BotwTelemetry turns it on from the start."),
+	ECVF_Default);
+
+namespace BotwTelemetry
+{
+	constexpr uint32 FileMagic = 0x314C5442; // "BTL1"
+
+	constexpr uint32 FileVersion = 1;
+
+	/** 64KB of records; a busy fight fills this in well under a minute. */
+	constexpr int32 FlushRecords = 2048;
+
+	/** So that little is lost when a session crashes. */
+	constexpr double FlushSeconds = 10.0;
+
+	static void SerializeHeader(FArchive& Ar, FSession& Session)
+	{
+		uint32 Magic = FileMagic;
+		uint32 Version = FileVersion;
+		uint32 RecordSize = sizeof(FBotwTelemetryRecord);
+		Ar << Magic << Version << RecordSize;
+
+		if (Ar.IsLoading() && (Magic != FileMagic || Version != FileVersion || RecordSize != sizeof(FBotwTelemetryRecord)))
+		{
+			Ar.SetError();
+			return;
+		}
+
+		Ar << Session.MapName << Session.StartTime;
+	}
+
+	/** Ids only have to tell actors apart within a session; the weak pointer must not be resolved off the game thread. */
+	static uint32 GetActorId(const TWeakObjectPtr<AActor>& Actor)
+	{
+		return Actor.IsExplicitlyNull() ? 0 : GetTypeHash(Actor);
+	}
+
+	class FWriter
+	{
+	public:
+		FWriter(TUniquePtr<FArchive> InFile, double InStartSeconds)
+			: File(MoveTemp(InFile))
+			, StartSeconds(InStartSeconds)
+			, LastFlushSeconds(InStartSeconds)
+		{
+			Pending.Reserve(FlushRecords);
+		}
+
+		~FWriter()
+		{
+			FBotwTelemetryRecord& End = Pending.AddDefaulted_GetRef();
+			End.Time = float(FPlatformTime::Seconds() - StartSeconds);
+
+			Flush();
+			File->Close();
+		}
+
+		/** Called on the event bus's worker tasks, one batch after the other. */
+		void Append(TConstArrayView<FBotwGameplayEvent> Events)
+		{
+			SCOPE_CYCLE_COUNTER(STAT_BotwTelemetryAppend);
+
+			FScopeLock Lock(&CriticalSection);
+
+			for (const FBotwGameplayEvent& Event : Events)
+			{
+				FBotwTelemetryRecord& Record = Pending.AddDefaulted_GetRef();
+				Record.Time = float(Event.Seconds - StartSeconds);
+				Record.Actor = GetActorId(Event.Instigator);
+				Record.Target = GetActorId(Event.Target);
+				Record.Value = Event.Value;
+				Record.Location = FVector3f(Event.Location);
+				Record.Type = Event.Type;
+			}
+
+			INC_DWORD_STAT_BY(STAT_BotwTelemetryRecords, Events.Num());
+
+			const double Now = FPlatformTime::Seconds();
+			if (Pending.Num() >= FlushRecords || Now - LastFlushSeconds >= FlushSeconds)
+			{
+				Flush();
+				LastFlushSeconds = Now;
+			}
+		}
+
+	private:
+		void Flush()
+		{
+			SCOPE_CYCLE_COUNTER(STAT_BotwTelemetryFlush);
+
+			File->Serialize(Pending.GetData(), Pending.Num() * sizeof(FBotwTelemetryRecord));
+			File->Flush();
+			Pending.Reset();
+		}
+
+		FCriticalSection CriticalSection;
+
+		TUniquePtr<FArchive> File;
+
+		TArray<FBotwTelemetryRecord> Pending;
+
+		double StartSeconds;
+
+		double LastFlushSeconds;
+	};
+}
+
+bool BotwTelemetry::LoadSession(const FString& Filename, FSession& OutSession)
+{
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *Filename))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Bytes);
+	SerializeHeader(Reader, OutSession);
+	if (Reader.IsError())
+	{
+		return false;
+	}
+
+	const int64 NumRecords = (Reader.TotalSize() - Reader.Tell()) / sizeof(FBotwTelemetryRecord);
+	OutSession.Records.SetNumUninitialized(int32(NumRecords));
+	Reader.Serialize(OutSession.Records.GetData(), NumRecords * sizeof(FBotwTelemetryRecord));
+
+	return !Reader.IsError();
+}
+
+bool UBotwTelemetrySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+bool UBotwTelemetrySubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return Super::ShouldCreateSubsystem(Outer) && !IsRunningCommandlet() &&
+		(CVarTelemetryEnable.GetValueOnGameThread() || FParse::Param(FCommandLine::Get(), TEXT("BotwTelemetry")));
+}
+
+void UBotwTelemetrySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Collection.InitializeDependency<UBotwEventBusSubsystem>();
+}
+
+void UBotwTelemetrySubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	UBotwEventBusSubsystem* EventBus = InWorld.GetSubsystem<UBotwEventBusSubsystem>();
+	if (!EventBus)
+	{
+		return;
+	}
+
+	BotwTelemetry::FSession Header;
+	Header.MapName = UWorld::RemovePIEPrefix(InWorld.GetMapName());
+	Header.StartTime = FDateTime::UtcNow();
+
+	const FString Filename = FPaths::CreateTempFilename(*(FPaths::ProfilingDir() / TEXT("Telemetry")),
+		*FString::Printf(TEXT("Session_%s_"), *Header.MapName), TEXT(".btl"));
+
+	TUniquePtr<FArchive> File(IFileManager::Get().CreateFileWriter(*Filename));
+	if (!File)
+	{
+		UE_LOG(LogBotw, Warning, TEXT("Telemetry disabled: could not create %s"), *Filename);
+		return;
+	}
+
+	BotwTelemetry::SerializeHeader(*File, Header);
+
+	UE_LOG(LogBotw, Log, TEXT("Recording telemetry to %s"), *Filename);
+
+	Writer = MakeShared<BotwTelemetry::FWriter, ESPMode::ThreadSafe>(MoveTemp(File), FPlatformTime::Seconds());
+
+	EventBus->AddAsyncConsumer([Writer = Writer.ToSharedRef()](TConstArrayView<FBotwGameplayEvent> Events)
+	{
+		Writer->Append(Events);
+	});
+}
+
+void UBotwTelemetrySubsystem::Deinitialize()
+{
+	// The file is closed by whoever lets go of the writer last: this, or a consumer task still in flight.
+	Writer.Reset();
+
+	Super::Deinitialize();
+}
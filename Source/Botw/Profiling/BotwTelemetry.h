@@ -0,0 +1,79 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "../Events/BotwEventBusSubsystem.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "BotwTelemetry.generated.h"
+
+/** One gameplay event of a session, as written to telemetry files. */
+struct FBotwTelemetryRecord
+{
+	/** Seconds since the session started. */
+	float Time = 0.f;
+
+	/** Session-local ids of the instigator and target, 0 meaning none. */
+	uint32 Actor = 0;
+
+	uint32 Target = 0;
+
+	/** FBotwGameplayEvent::Value. */
+	int32 Value = 0;
+
+	FVector3f Location = FVector3f::ZeroVector;
+
+	/** EBotwGameplayEventType::Num marks the end of the session. */
+	EBotwGameplayEventType Type = EBotwGameplayEventType::Num;
+
+	uint8 Padding[3] = {};
+};
+
+static_assert(sizeof(FBotwTelemetryRecord) == 32, "Telemetry records are written to files as raw bytes");
+
+/**
+ * Session telemetry: every gameplay event of the event bus, written as fixed-size records to
+ * Saved/Profiling/Telemetry/*.btl. The records are built and written on the bus's async consumer tasks, so the game
+ * thread only pays for handing the frame's batch over. Aggregate sessions with UBotwTelemetryCommandlet.
+ */
+namespace BotwTelemetry
+{
+	class FWriter;
+
+	/** Telemetry file contents. */
+	struct FSession
+	{
+		FString MapName;
+
+		FDateTime StartTime;
+
+		TArray<FBotwTelemetryRecord> Records;
+	};
+
+	/** Sessions that did not close cleanly load up to their last complete record. */
+	BOTW_API bool LoadSession(const FString& Filename, FSession& OutSession);
+}
+
+/**
+ * Records the sessions of game worlds while botw.Telemetry.Enable is set or the process runs with -BotwTelemetry.
+ * Off by default, so players, servers and load-test bots write nothing unless a playtest asks for it.
+ */
+UCLASS()
+class BOTW_API UBotwTelemetrySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	virtual void Deinitialize() override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/** Shared with the event bus consumer, which can still be running on a worker when the world goes away. */
+	TSharedPtr<BotwTelemetry::FWriter, ESPMode::ThreadSafe> Writer;
+};
@@ -0,0 +1,66 @@
+#include "../Climbing/BotwClimbContactManifold.h"
+#include "Components/BoxComponent.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBotwClimbContactManifoldTest, "Botw.Climbing.ContactsMergeProbes",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+namespace BotwClimbContactManifoldTest
+{
+	static FHitResult MakeHit(UPrimitiveComponent* Component, const FVector& Point)
+	{
+		FHitResult Hit;
+		Hit.bBlockingHit = true;
+		Hit.Component = Component;
+		Hit.ImpactPoint = Point;
+		Hit.Normal = FVector::BackwardVector;
+		return Hit;
+	}
+
+	static const FBotwClimbContact* FindContact(const FBotwClimbContactManifold& Manifold, const UPrimitiveComponent* Component)
+	{
+		for (const FBotwClimbContact& Contact : Manifold)
+		{
+			if (Contact.ComponentId == Component->GetUniqueID())
+			{
+				return &Contact;
+			}
+		}
+		return nullptr;
+	}
+}
+
+bool FBotwClimbContactManifoldTest::RunTest(const FString& Parameters)
+{
+	using namespace BotwClimbContactManifoldTest;
+
+	UBoxComponent* Left = NewObject<UBoxComponent>();
+	UBoxComponent* Right = NewObject<UBoxComponent>();
+
+	FBotwClimbContactManifold Manifold;
+	Manifold.Update({MakeHit(Left, FVector(100.f, -50.f, 0.f)), MakeHit(Left, FVector(110.f, -50.f, 0.f)),
+		MakeHit(Right, FVector(100.f, 50.f, 0.f))}, FVector::ZeroVector, FQuat::Identity);
+
+	TestEqual(TEXT("One contact per component"), Manifold.Num(), 2);
+	TestEqual(TEXT("The closest hit on a component is kept"), FindContact(Manifold, Left)->Position.X, 100.f);
+
+	Manifold.Keep();
+	Manifold.Update({MakeHit(Left, FVector(90.f, -50.f, 0.f))}, FVector::ZeroVector, FQuat::Identity);
+
+	TestEqual(TEXT("A contact the probe missed is kept"), Manifold.Num(), 2);
+	TestEqual(TEXT("A contact the probe found is refreshed"), FindContact(Manifold, Left)->Position.X, 90.f);
+	TestEqual(TEXT("A contact the probe found is confirmed"), int32(FindContact(Manifold, Left)->Age), 0);
+	TestEqual(TEXT("A contact the probe missed ages"), int32(FindContact(Manifold, Right)->Age), 1);
+
+	const uint32 RightMask = FindContact(Manifold, Right) == Manifold.begin() ? 1u : 2u;
+	Manifold.Remove(RightMask);
+
+	TestEqual(TEXT("Removed contacts are dropped"), Manifold.Num(), 1);
+	TestNotNull(TEXT("Other contacts stay"), FindContact(Manifold, Left));
+
+	return !HasAnyErrors();
+}
+
+#endif
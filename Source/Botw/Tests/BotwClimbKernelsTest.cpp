@@ -0,0 +1,214 @@
+#include "../Climbing/BotwClimbKernels.h"
+#include "../MyCharacterMovementComponent.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBotwClimbKernelsTest, "Botw.Climbing.KernelsMatchScalar",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+namespace BotwClimbKernelsTest
+{
+	/** Whole registers, partial ones and a batch as large as the benchmark's. */
+	constexpr int32 BatchSizes[] = {1, 2, 3, 4, 5, 7, 8, 13, 1000};
+
+	constexpr float SteepnessTolerance = 1e-5f;
+
+	constexpr float NormalTolerance = 1e-5f;
+
+	constexpr float PositionTolerance = 1e-3f;
+
+	/** Per quaternion component, the kernel approximating the arc cosine and sines of FQuat::Slerp. */
+	constexpr float RotationTolerance = 1e-3f;
+
+	/** Facings this close to the climbing limit may fall on either side of it in float. */
+	constexpr float LimitDegreesTolerance = 1e-2f;
+
+	/** Walls, slopes and ceilings, with zero normals and straight up or down ones mixed in. */
+	static FVector3f RandomNormal(FRandomStream& Random)
+	{
+		switch (Random.RandHelper(8))
+		{
+		case 0:
+			return FVector3f::ZeroVector;
+		case 1:
+			return FVector3f::UpVector;
+		case 2:
+			return FVector3f::DownVector;
+		default:
+			return FVector3f(Random.FRandRange(-1.f, 1.f), Random.FRandRange(-1.f, 1.f), Random.FRandRange(-1.f, 1.f)).GetSafeNormal();
+		}
+	}
+
+	/** Unnormalized sums as ComputeSurfaceInfo adds them up, including none at all. */
+	static FVector3f RandomNormalSum(FRandomStream& Random, int32 NumContacts)
+	{
+		FVector3f Sum = FVector3f::ZeroVector;
+		for (int32 Contact = 0; Contact < NumContacts; ++Contact)
+		{
+			Sum += RandomNormal(Random);
+		}
+		return Sum;
+	}
+
+	static void TestClimbStarts(FAutomationTestBase& Test, FRandomStream& Random, int32 Num)
+	{
+		const UMyCharacterMovementComponent* ClimbRules = GetDefault<UMyCharacterMovementComponent>();
+		const float MaxHorizontalDegrees = ClimbRules->GetMinHorizontalDegreesToStartClimbing();
+
+		BotwClimbKernels::FVectorBatch Facings;
+		BotwClimbKernels::FVectorBatch Normals;
+		Facings.Init(Num);
+		Normals.Init(Num);
+		for (int32 Index = 0; Index < Num; ++Index)
+		{
+			// The movement component faces the wall horizontally.
+			const FVector3f Facing = FVector3f(FVector(1.f, 0.f, 0.f).RotateAngleAxis(Random.FRandRange(-180.f, 180.f), FVector::UpVector));
+			Facings.Set(Index, Facing);
+			Normals.Set(Index, RandomNormal(Random));
+		}
+
+		BotwClimbKernels::FScalarBatch Steepness;
+		BotwClimbKernels::EvaluateClimbStarts(Facings, Normals, MaxHorizontalDegrees, Steepness);
+
+		for (int32 Index = 0; Index < Num; ++Index)
+		{
+			const FVector Facing(Facings.Get(Index));
+			const FVector Normal(Normals.Get(Index));
+			const FVector HorizontalNormal = Normal.GetSafeNormal2D();
+
+			const float HorizontalDegrees = FMath::RadiansToDegrees(FMath::Acos(FVector::DotProduct(Facing, -HorizontalNormal)));
+			if (!HorizontalNormal.IsZero() && FMath::IsNearlyEqual(HorizontalDegrees, MaxHorizontalDegrees, LimitDegreesTolerance))
+			{
+				continue;
+			}
+
+			const float Expected = ClimbRules->CanStartClimbingSurface(Facing, Normal)
+				? float(FVector::DotProduct(Normal, HorizontalNormal))
+				: BotwClimbKernels::NotClimbable;
+			const FString What = FString::Printf(TEXT("Climb start %d of %d, normal %s"), Index, Num, *Normal.ToString());
+			if (Expected == BotwClimbKernels::NotClimbable)
+			{
+				Test.TestEqual(What, Steepness[Index], BotwClimbKernels::NotClimbable);
+			}
+			else
+			{
+				Test.TestEqual(What, Steepness[Index], Expected, SteepnessTolerance);
+			}
+		}
+	}
+
+	static void TestSafeNormalize(FAutomationTestBase& Test, FRandomStream& Random, int32 Num)
+	{
+		BotwClimbKernels::FVectorBatch Vectors;
+		Vectors.Init(Num);
+		for (int32 Index = 0; Index < Num; ++Index)
+		{
+			Vectors.Set(Index, RandomNormalSum(Random, Random.RandRange(0, 4)) * Random.FRandRange(0.f, 500.f));
+		}
+
+		const BotwClimbKernels::FVectorBatch Expected = Vectors;
+		BotwClimbKernels::SafeNormalize(Vectors);
+
+		for (int32 Index = 0; Index < Num; ++Index)
+		{
+			const FVector3f Vector = Expected.Get(Index);
+			Test.TestEqual(FString::Printf(TEXT("Normalized %d of %d, %s"), Index, Num, *Vector.ToString()),
+				FVector(Vectors.Get(Index)), FVector(Vector.GetSafeNormal()), NormalTolerance);
+		}
+	}
+
+	static void TestAverageSurfaces(FAutomationTestBase& Test, FRandomStream& Random, int32 Num)
+	{
+		BotwClimbKernels::FVectorBatch Positions;
+		BotwClimbKernels::FVectorBatch Normals;
+		BotwClimbKernels::FScalarBatch NumContacts;
+		Positions.Init(Num);
+		Normals.Init(Num);
+		NumContacts.Init(Num);
+		for (int32 Index = 0; Index < Num; ++Index)
+		{
+			const int32 Contacts = Random.RandRange(0, FBotwClimbContactManifold::MaxContacts);
+			Positions.Set(Index, FVector3f(Random.GetUnitVector() * Random.FRandRange(0.f, 1000.f) * Contacts));
+			Normals.Set(Index, RandomNormalSum(Random, Contacts));
+			NumContacts[Index] = Contacts;
+		}
+
+		const BotwClimbKernels::FVectorBatch PositionSums = Positions;
+		const BotwClimbKernels::FVectorBatch NormalSums = Normals;
+		BotwClimbKernels::AverageSurfaces(Positions, Normals, NumContacts);
+
+		for (int32 Index = 0; Index < Num; ++Index)
+		{
+			// Without contacts there is nothing to divide by and the position stays as it is.
+			const int32 Contacts = int32(NumContacts[Index]);
+			const FVector3f ExpectedPosition = Contacts > 0 ? PositionSums.Get(Index) / Contacts : PositionSums.Get(Index);
+			const FString What = FString::Printf(TEXT("Surface %d of %d with %d contacts"), Index, Num, Contacts);
+
+			Test.TestEqual(What + TEXT(" position"), FVector(Positions.Get(Index)), FVector(ExpectedPosition), PositionTolerance);
+			Test.TestEqual(What + TEXT(" normal"), FVector(Normals.Get(Index)), FVector(NormalSums.Get(Index).GetSafeNormal()),
+				NormalTolerance);
+		}
+	}
+
+	static void TestClimbingRotations(FAutomationTestBase& Test, FRandomStream& Random, int32 Num)
+	{
+		BotwClimbKernels::FQuatBatch Rotations;
+		BotwClimbKernels::FVectorBatch Normals;
+		BotwClimbKernels::FScalarBatch Alphas;
+		Rotations.Init(Num);
+		Normals.Init(Num);
+		Alphas.Init(Num);
+		for (int32 Index = 0; Index < Num; ++Index)
+		{
+			const FRotator Rotation(Random.FRandRange(-89.f, 89.f), Random.FRandRange(-180.f, 180.f), Random.FRandRange(-30.f, 30.f));
+			Rotations.Set(Index, FQuat4f(Rotation.Quaternion()));
+			Normals.Set(Index, RandomNormal(Random));
+			Alphas[Index] = Random.FRand();
+		}
+
+		const BotwClimbKernels::FQuatBatch Expected = Rotations;
+		BotwClimbKernels::InterpolateClimbingRotations(Rotations, Normals, Alphas);
+
+		for (int32 Index = 0; Index < Num; ++Index)
+		{
+			const FVector Normal(Normals.Get(Index));
+			if (Normal.SizeSquared2D() > UE_SMALL_NUMBER && FMath::Abs(Normal.GetSafeNormal().Z) >= 1.f - UE_KINDA_SMALL_NUMBER)
+			{
+				// Within a hair of vertical MakeFromX switches to building from the X axis; climbing has ended on the
+				// ceiling or floor long before, at FVector::Parallel, and the kernel only matches it at exactly vertical.
+				continue;
+			}
+
+			const FQuat Rotation(Expected.Get(Index));
+			const FQuat ExpectedRotation = Normal.IsNearlyZero(UE_SMALL_NUMBER)
+				? Rotation.GetNormalized()
+				: FQuat::Slerp(Rotation, FRotationMatrix::MakeFromX(-Normal).ToQuat(), Alphas[Index]);
+			const FQuat Result(Rotations.Get(Index));
+
+			// Equals takes q and -q as the same rotation.
+			Test.TestTrue(FString::Printf(TEXT("Rotation %d of %d, normal %s, alpha %.3f: %s, expected %s"), Index, Num,
+					*Normal.ToString(), Alphas[Index], *Result.ToString(), *ExpectedRotation.ToString()),
+				Result.Equals(ExpectedRotation, RotationTolerance));
+		}
+	}
+}
+
+bool FBotwClimbKernelsTest::RunTest(const FString& Parameters)
+{
+	using namespace BotwClimbKernelsTest;
+
+	for (const int32 Num : BatchSizes)
+	{
+		FRandomStream Random(Num);
+		TestClimbStarts(*this, Random, Num);
+		TestSafeNormalize(*this, Random, Num);
+		TestAverageSurfaces(*this, Random, Num);
+		TestClimbingRotations(*this, Random, Num);
+	}
+
+	return !HasAnyErrors();
+}
+
+#endif
@@ -0,0 +1,297 @@
+#include "BotwTestWorld.h"
+#include "../BotwCharacter.h"
+#include "../BotwFrameScratch.h"
+#include "../MyCharacterMovementComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBotwClimbingFrameRateTest, "Botw.Climbing.FrameRateIndependence",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBotwClimbingFloorCheckTest, "Botw.Climbing.FloorCheckSkipping",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBotwClimbingScratchTest, "Botw.Climbing.ScratchSteadyState",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBotwClimbingDashTest, "Botw.Climbing.DashAtLowFrameRate",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+namespace BotwClimbingTest
+{
+	constexpr float ClimbingDistance = 60.f;
+
+	/** Across and up the wall, staying clear of its top. */
+	const FVector ClimbInput = FVector(0.f, 1.f, 1.f).GetSafeNormal();
+
+	constexpr float ClimbSeconds = 2.f;
+
+	/** 20, 60 and 144 Hz all have a frame ending every quarter second, where the paths are compared. */
+	constexpr float TrajectorySampleSeconds = 0.25f;
+
+	/** Euler-integrated acceleration differs a little between step lengths; anything beyond this is a different path. */
+	constexpr float TrajectoryTolerance = 5.f;
+
+	/**
+	 * Climbs with the same input for the same time at Hz and returns where the character was, relative to where it
+	 * started, every TrajectorySampleSeconds.
+	 */
+	static bool Climb(FAutomationTestBase& Test, float Hz, TArray<FVector>& OutTrajectory)
+	{
+		const float DeltaTime = 1.f / Hz;
+
+		FBotwTestWorld TestWorld;
+		ABotwCharacter* Character = TestWorld.SpawnCharacter(ClimbingDistance);
+		if (!Test.TestNotNull(TEXT("Player character Blueprint"), Character) ||
+			!Test.TestTrue(FString::Printf(TEXT("Started climbing at %.0f Hz"), Hz), TestWorld.StartClimbing(*Character, DeltaTime)))
+		{
+			return false;
+		}
+
+		const FVector Start = Character->GetActorLocation();
+
+		const int32 NumFrames = FMath::RoundToInt(ClimbSeconds * Hz);
+		const int32 FramesPerSample = FMath::RoundToInt(TrajectorySampleSeconds * Hz);
+		for (int32 Frame = 1; Frame <= NumFrames; ++Frame)
+		{
+			Character->AddMovementInput(ClimbInput, 1.f, true);
+			TestWorld.Tick(DeltaTime);
+
+			if (Frame % FramesPerSample == 0)
+			{
+				OutTrajectory.Add(Character->GetActorLocation() - Start);
+			}
+		}
+
+		return Test.TestTrue(FString::Printf(TEXT("Still climbing at %.0f Hz"), Hz), Character->GetCustomCharacterMovement()->IsClimbing());
+	}
+
+	/** The snap onto the wall trails a dash by a little; a character that went into the wall or let go is off by far more. */
+	constexpr float DashWallGapTolerance = 15.f;
+
+	/** Where and when a climb ended, and the scene queries it took. */
+	struct FClimbDown
+	{
+		int32 EndFrame = INDEX_NONE;
+
+		FVector EndLocation = FVector::ZeroVector;
+
+		uint32 Queries = 0;
+	};
+
+	/**
+	 * Climbs up, then down and sideways onto a step at the foot of the wall until the floor ends the climb, with floor
+	 * traces skipped or not.
+	 */
+	static bool ClimbDown(FAutomationTestBase& Test, bool bSkipFloorChecks, FClimbDown& OutResult)
+	{
+		constexpr float DeltaTime = 1.f / 60.f;
+		constexpr float UpSeconds = 1.5f;
+		constexpr float MaxDownSeconds = 6.f;
+
+		FBotwTestWorld TestWorld;
+		const FVector StepExtent(150.f, 150.f, 20.f);
+		TestWorld.SpawnBox(FVector(FBotwTestWorld::WallX - StepExtent.X, 250.f, StepExtent.Z), StepExtent);
+
+		ABotwCharacter* Character = TestWorld.SpawnCharacter(ClimbingDistance);
+		if (!Test.TestNotNull(TEXT("Player character Blueprint"), Character))
+		{
+			return false;
+		}
+
+		UMyCharacterMovementComponent* Movement = Character->GetCustomCharacterMovement();
+		Movement->SetSkipUnreachableFloorChecks(bSkipFloorChecks);
+
+		if (!Test.TestTrue(TEXT("Started climbing"), TestWorld.StartClimbing(*Character, DeltaTime)))
+		{
+			return false;
+		}
+
+		const uint32 StartQueries = Movement->GetQueryCounter().GetTotalQueries();
+
+		const FVector DownInput = FVector(0.f, 1.f, -1.f).GetSafeNormal();
+		const int32 UpFrames = FMath::RoundToInt(UpSeconds / DeltaTime);
+		const int32 MaxFrames = UpFrames + FMath::RoundToInt(MaxDownSeconds / DeltaTime);
+
+		for (int32 Frame = 0; Frame < MaxFrames && OutResult.EndFrame == INDEX_NONE; ++Frame)
+		{
+			Character->AddMovementInput(Frame < UpFrames ? FVector::UpVector : DownInput, 1.f, true);
+			TestWorld.Tick(DeltaTime);
+
+			if (!Movement->IsClimbing())
+			{
+				OutResult.EndFrame = Frame;
+				OutResult.EndLocation = Character->GetActorLocation();
+			}
+		}
+
+		OutResult.Queries = Movement->GetQueryCounter().GetTotalQueries() - StartQueries;
+
+		return Test.TestTrue(TEXT("Reached the floor"), OutResult.EndFrame != INDEX_NONE);
+	}
+}
+
+bool FBotwClimbingFrameRateTest::RunTest(const FString& Parameters)
+{
+	using namespace BotwClimbingTest;
+
+	// A 20 Hz server splits every frame into substeps; a 144 Hz client takes shorter steps than the 60 Hz reference.
+	TArray<FVector> Reference;
+	if (!Climb(*this, 60.f, Reference))
+	{
+		return false;
+	}
+
+	TestTrue(TEXT("Climbed up and across the wall"), Reference.Last().Y > 0.f && Reference.Last().Z > 0.f);
+
+	for (const float Hz : {20.f, 144.f})
+	{
+		TArray<FVector> Trajectory;
+		if (!Climb(*this, Hz, Trajectory) ||
+			!TestEqual(FString::Printf(TEXT("Samples of the climb at %.0f Hz"), Hz), Trajectory.Num(), Reference.Num()))
+		{
+			continue;
+		}
+
+		for (int32 Sample = 0; Sample < Reference.Num(); ++Sample)
+		{
+			TestEqual(FString::Printf(TEXT("Where the climb is after %.2f s at %.0f Hz"), (Sample + 1) * TrajectorySampleSeconds, Hz),
+				Trajectory[Sample], Reference[Sample], TrajectoryTolerance);
+		}
+	}
+
+	return true;
+}
+
+bool FBotwClimbingFloorCheckTest::RunTest(const FString& Parameters)
+{
+	using namespace BotwClimbingTest;
+
+	FClimbDown Traced;
+	FClimbDown Skipped;
+	if (!ClimbDown(*this, false, Traced) || !ClimbDown(*this, true, Skipped))
+	{
+		return false;
+	}
+
+	// Skipping only drops traces that could not have ended the climb, so the climb has to end the same way.
+	TestEqual(TEXT("Frame the climb ends in"), Skipped.EndFrame, Traced.EndFrame);
+	TestEqual(TEXT("Where the climb ends"), Skipped.EndLocation, Traced.EndLocation, UE_KINDA_SMALL_NUMBER);
+	TestTrue(FString::Printf(TEXT("Fewer scene queries when skipping floor traces (%u, %u)"), Skipped.Queries, Traced.Queries),
+		Skipped.Queries < Traced.Queries);
+
+	return true;
+}
+
+bool FBotwClimbingScratchTest::RunTest(const FString& Parameters)
+{
+	using namespace BotwClimbingTest;
+
+	constexpr float DeltaTime = 1.f / 60.f;
+	constexpr int32 WarmUpFrames = 30;
+	constexpr int32 MeasuredFrames = 60;
+
+	FBotwTestWorld TestWorld;
+	ABotwCharacter* Character = TestWorld.SpawnCharacter(ClimbingDistance);
+	if (!TestNotNull(TEXT("Player character Blueprint"), Character) ||
+		!TestTrue(TEXT("Started climbing"), TestWorld.StartClimbing(*Character, DeltaTime)))
+	{
+		return false;
+	}
+
+	// The first frames on the wall size the scratch arrays; after that, climbing the same wall has to reuse them.
+	for (int32 Frame = 0; Frame < WarmUpFrames; ++Frame)
+	{
+		Character->AddMovementInput(ClimbInput, 1.f, true);
+		TestWorld.Tick(DeltaTime);
+	}
+
+	const uint32 StartGrown = BotwFrameScratch::GetNumGrown();
+
+	for (int32 Frame = 0; Frame < MeasuredFrames; ++Frame)
+	{
+		Character->AddMovementInput(ClimbInput, 1.f, true);
+		TestWorld.Tick(DeltaTime);
+	}
+
+	TestTrue(TEXT("Still climbing"), Character->GetCustomCharacterMovement()->IsClimbing());
+	TestEqual(TEXT("Scratch arrays grown after warming up"), BotwFrameScratch::GetNumGrown(), StartGrown);
+
+	return true;
+}
+
+bool FBotwClimbingDashTest::RunTest(const FString& Parameters)
+{
+	using namespace BotwClimbingTest;
+
+	constexpr float MaxDashSeconds = 2.f;
+
+	const int32 DashBudget = FBotwQueryCounter::GetBudget(EBotwQueryBudgetState::ClimbDashing);
+
+	// 30 Hz splits every frame in two substeps, 10 Hz in six; each substep moves the dash further than a 60 Hz frame.
+	for (const float Hz : {30.f, 10.f})
+	{
+		const float DeltaTime = 1.f / Hz;
+
+		FBotwTestWorld TestWorld;
+		ABotwCharacter* Character = TestWorld.SpawnCharacter(ClimbingDistance);
+		if (!TestNotNull(TEXT("Player character Blueprint"), Character) ||
+			!TestTrue(FString::Printf(TEXT("Started climbing at %.0f Hz"), Hz), TestWorld.StartClimbing(*Character, DeltaTime)))
+		{
+			return false;
+		}
+
+		UMyCharacterMovementComponent* Movement = Character->GetCustomCharacterMovement();
+		const float CapsuleRadius = Character->GetCapsuleComponent()->GetScaledCapsuleRadius();
+
+		// One frame of input first, so the dash takes its direction from it.
+		Character->AddMovementInput(FVector::RightVector, 1.f, true);
+		TestWorld.Tick(DeltaTime);
+
+		const FVector Start = Character->GetActorLocation();
+		const float WallGap = FBotwTestWorld::WallX - Start.X;
+
+		Movement->TryClimbDashing();
+		if (!TestTrue(FString::Printf(TEXT("Started dashing at %.0f Hz"), Hz), Movement->IsClimbDashing()))
+		{
+			return false;
+		}
+
+		int32 WorstQueriesPerStep = 0;
+		const int32 MaxFrames = FMath::CeilToInt(MaxDashSeconds * Hz);
+		for (int32 Frame = 0; Frame < MaxFrames && Movement->IsClimbDashing(); ++Frame)
+		{
+			Character->AddMovementInput(FVector::RightVector, 1.f, true);
+			TestWorld.Tick(DeltaTime);
+
+			const FVector Location = Character->GetActorLocation();
+			const FString When = FString::Printf(TEXT("at %.0f Hz, frame %d"), Hz, Frame);
+			if (!TestTrue(TEXT("Still climbing ") + When, Movement->IsClimbing()) ||
+				!TestTrue(TEXT("In front of the wall ") + When, Location.X + CapsuleRadius <= FBotwTestWorld::WallX + DashWallGapTolerance))
+			{
+				return false;
+			}
+
+			TestEqual(TEXT("Distance to the wall ") + When, FBotwTestWorld::WallX - Location.X, WallGap, DashWallGapTolerance);
+
+			// Frames the dash ended in were budgeted as moving, which allows less than dashing.
+			if (Movement->IsClimbDashing())
+			{
+				const FBotwQueryCounter& Counter = Movement->GetQueryCounter();
+				WorstQueriesPerStep = FMath::Max(WorstQueriesPerStep,
+					FMath::DivideAndRoundUp(Counter.GetQueriesLastFrame(), Counter.GetSimulationStepsLastFrame()));
+			}
+		}
+
+		TestFalse(FString::Printf(TEXT("Dash ended at %.0f Hz"), Hz), Movement->IsClimbDashing());
+		TestTrue(FString::Printf(TEXT("Dashed along the wall at %.0f Hz"), Hz), Character->GetActorLocation().Y - Start.Y > CapsuleRadius);
+		TestTrue(FString::Printf(TEXT("Worst scene queries per substep at %.0f Hz (%d), budget is %d"), Hz, WorstQueriesPerStep,
+			DashBudget), WorstQueriesPerStep <= DashBudget);
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,219 @@
+#include "BotwTestWorld.h"
+#include "../BotwCharacter.h"
+#include "../BotwSceneQuery.h"
+#include "../MyCharacterMovementComponent.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBotwQueryBudgetTest, "Botw.SceneQueries.Budgets",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+namespace BotwQueryBudgetTest
+{
+	/** One simulation step per frame, so every frame gets exactly the allowance of its states. */
+	constexpr float DeltaTime = 1.f / 60.f;
+
+	constexpr int32 NumStates = static_cast<int32>(EBotwQueryBudgetState::Num);
+
+	/** Starts far enough from the wall that walking along it never finds it. */
+	constexpr float WalkingDistance = 300.f;
+
+	/** Starts close enough to the wall to climb it. */
+	constexpr float ClimbingDistance = 60.f;
+
+	/** High enough to open the glider, and low enough to land before gliding along the wall off the far side of the floor. */
+	constexpr float GlideStartHeight = 700.f;
+
+	constexpr float GlideStartY = -1800.f;
+
+	class FRun
+	{
+	public:
+		FRun(FAutomationTestBase& InTest, float DistanceFromWall)
+			: Test(InTest)
+		{
+			Character = TestWorld.SpawnCharacter(DistanceFromWall);
+			Test.TestNotNull(TEXT("Player character Blueprint"), Character);
+		}
+
+		bool IsValid() const { return Character != nullptr; }
+
+		ABotwCharacter& GetCharacter() const { return *Character; }
+
+		UMyCharacterMovementComponent& GetMovement() const { return *Character->GetCustomCharacterMovement(); }
+
+		/**
+		 * Ticks up to MaxFrames frames, adding Input before each, until Done. The queries of every frame are checked
+		 * against the budget of the states the character was in. Returns whether Done was reached.
+		 */
+		bool Tick(int32 MaxFrames, const FVector& Input, TFunctionRef<bool()> Done)
+		{
+			for (int32 Frame = 0; Frame < MaxFrames; ++Frame)
+			{
+				if (!Input.IsZero())
+				{
+					Character->AddMovementInput(Input, 1.f, true);
+				}
+
+				TestWorld.Tick(DeltaTime);
+				CheckFrame();
+
+				if (Done())
+				{
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		void Tick(int32 Frames, const FVector& Input = FVector::ZeroVector)
+		{
+			Tick(Frames, Input, [] { return false; });
+		}
+
+		/** Checks that State was reached and budgeted at least once. */
+		void TestStateReached(EBotwQueryBudgetState State) const
+		{
+			Test.TestTrue(FString::Printf(TEXT("Frames spent %s"), BotwSceneQuery::GetStateName(State)),
+				FramesPerState[static_cast<int32>(State)] > 0);
+		}
+
+	private:
+		/** Budgets the frame by the states the counter recorded during it, as the counter's own check does. */
+		void CheckFrame()
+		{
+			const FBotwQueryCounter& Counter = GetMovement().GetQueryCounter();
+			const uint8 StateMask = Counter.GetStateMaskLastFrame();
+
+			FString States;
+			int32 Budget = 0;
+			for (int32 Index = 0; Index < NumStates; ++Index)
+			{
+				if (StateMask & (1 << Index))
+				{
+					const EBotwQueryBudgetState State = static_cast<EBotwQueryBudgetState>(Index);
+					++FramesPerState[Index];
+					States += States.IsEmpty() ? BotwSceneQuery::GetStateName(State) : FString(TEXT("+")) + BotwSceneQuery::GetStateName(State);
+					Budget += FBotwQueryCounter::GetBudget(State);
+				}
+			}
+
+			Budget *= Counter.GetSimulationStepsLastFrame();
+
+			const int32 Queries = Counter.GetQueriesLastFrame();
+			if (Queries > Budget)
+			{
+				Test.AddError(FString::Printf(TEXT("%d scene queries in a frame spent %s, budget is %d"), Queries, *States, Budget));
+			}
+		}
+
+		FAutomationTestBase& Test;
+
+		FBotwTestWorld TestWorld;
+
+		ABotwCharacter* Character = nullptr;
+
+		int32 FramesPerState[NumStates] = {};
+	};
+
+	/** Lets the character find the wall in front of it and starts climbing. */
+	static bool StartClimbing(FRun& Run)
+	{
+		Run.Tick(2);
+		Run.GetMovement().TryClimbing();
+
+		return Run.Tick(30, FVector::ZeroVector, [&Run] { return Run.GetMovement().IsClimbing(); });
+	}
+}
+
+bool FBotwQueryBudgetTest::RunTest(const FString& Parameters)
+{
+	using namespace BotwQueryBudgetTest;
+
+	// Walking along the wall, then punching while standing.
+	{
+		FRun Run(*this, WalkingDistance);
+		if (!Run.IsValid())
+		{
+			return false;
+		}
+
+		Run.Tick(60, FVector::RightVector);
+		Run.TestStateReached(EBotwQueryBudgetState::Walking);
+
+		Run.GetCharacter().SetPunching(true);
+		Run.Tick(30);
+		Run.GetCharacter().SetPunching(false);
+		Run.TestStateReached(EBotwQueryBudgetState::Punching);
+	}
+
+	// Hanging still on the wall, then climbing sideways along it.
+	{
+		FRun Run(*this, ClimbingDistance);
+		if (!Run.IsValid() || !TestTrue(TEXT("Started climbing"), StartClimbing(Run)))
+		{
+			return false;
+		}
+
+		Run.Tick(90);
+		Run.TestStateReached(EBotwQueryBudgetState::ClimbingIdle);
+
+		Run.Tick(90, FVector::RightVector);
+		Run.TestStateReached(EBotwQueryBudgetState::ClimbingMoving);
+	}
+
+	// A dash, until it ends.
+	{
+		FRun Run(*this, ClimbingDistance);
+		if (!Run.IsValid() || !TestTrue(TEXT("Started climbing"), StartClimbing(Run)))
+		{
+			return false;
+		}
+
+		Run.GetMovement().TryClimbDashing();
+		TestTrue(TEXT("Dash ended"), Run.Tick(180, FVector::RightVector, [&Run] { return !Run.GetMovement().IsClimbDashing(); }));
+		Run.TestStateReached(EBotwQueryBudgetState::ClimbDashing);
+	}
+
+	// Climbing up to the top of the wall and over the ledge.
+	{
+		FRun Run(*this, ClimbingDistance);
+		if (!Run.IsValid() || !TestTrue(TEXT("Started climbing"), StartClimbing(Run)))
+		{
+			return false;
+		}
+
+		TestTrue(TEXT("Reached the ledge"), Run.Tick(600, FVector::UpVector, [&Run] { return Run.GetMovement().IsLedgeClimbing(); }));
+		TestTrue(TEXT("Stood up on the ledge"), Run.Tick(300, FVector::ZeroVector, [&Run] { return !Run.GetMovement().IsLedgeClimbing(); }));
+		Run.TestStateReached(EBotwQueryBudgetState::LedgeUp);
+	}
+
+	// Gliding along the wall from high above the floor until it lands.
+	{
+		FRun Run(*this, WalkingDistance);
+		if (!Run.IsValid())
+		{
+			return false;
+		}
+
+		ABotwCharacter& Character = Run.GetCharacter();
+		Character.SetActorLocation(FVector(Character.GetActorLocation().X, GlideStartY, GlideStartHeight));
+		Run.GetMovement().SetMovementMode(MOVE_Falling);
+		Run.Tick(1);
+
+		Run.GetMovement().TryGliding();
+		if (!TestTrue(TEXT("Started gliding"), Run.GetMovement().IsGliding()))
+		{
+			return false;
+		}
+
+		TestTrue(TEXT("Glided down to the floor"), Run.Tick(600, FVector::RightVector, [&Run] { return !Run.GetMovement().IsGliding(); }));
+		Run.TestStateReached(EBotwQueryBudgetState::Gliding);
+	}
+
+	return true;
+}
+
+#endif
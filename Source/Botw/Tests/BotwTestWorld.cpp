@@ -0,0 +1,113 @@
+#include "BotwTestWorld.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "../BotwCharacter.h"
+#include "../MyCharacterMovementComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/Engine.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "GameFramework/CharacterMovementComponent.h"
+
+namespace BotwTestWorld
+{
+	/** The engine cube is this many units on a side, around its pivot. */
+	constexpr float CubeSize = 100.f;
+
+	constexpr float WallThickness = 400.f;
+
+	constexpr float FloorExtent = 2000.f;
+
+	static const TCHAR* CharacterClassPath = TEXT("/Game/ThirdPerson/Blueprints/BP_ThirdPersonCharacter.BP_ThirdPersonCharacter_C");
+}
+
+FBotwTestWorld::FBotwTestWorld()
+{
+	using namespace BotwTestWorld;
+
+	World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("BotwTestWorld"));
+	GEngine->CreateNewWorldContext(EWorldType::Game).SetCurrentWorld(World);
+
+	World->SetGameMode(FURL());
+	World->InitializeActorsForPlay(FURL());
+
+	SpawnBox(FVector(0.f, 0.f, -CubeSize / 2), FVector(FloorExtent, FloorExtent, CubeSize / 2));
+	SpawnBox(FVector(WallX + WallThickness / 2, 0.f, WallHeight / 2), FVector(WallThickness / 2, FloorExtent, WallHeight / 2));
+
+	World->BeginPlay();
+}
+
+FBotwTestWorld::~FBotwTestWorld()
+{
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+}
+
+ABotwCharacter* FBotwTestWorld::SpawnCharacter(float DistanceFromWall)
+{
+	UClass* CharacterClass = LoadClass<ABotwCharacter>(nullptr, BotwTestWorld::CharacterClassPath);
+	if (!CharacterClass)
+	{
+		return nullptr;
+	}
+
+	const float HalfHeight = CharacterClass->GetDefaultObject<ABotwCharacter>()->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	ABotwCharacter* Character = World->SpawnActor<ABotwCharacter>(CharacterClass, FVector(WallX - DistanceFromWall, 0.f, HalfHeight + 1.f),
+		FRotator::ZeroRotator, SpawnParameters);
+
+	// Nothing renders, but the ledge-up and punch montages still have to play.
+	Character->GetCharacterMovement()->bRunPhysicsWithNoController = true;
+	Character->GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+
+	return Character;
+}
+
+bool FBotwTestWorld::StartClimbing(ABotwCharacter& Character, float DeltaTime)
+{
+	UMyCharacterMovementComponent* Movement = Character.GetCustomCharacterMovement();
+
+	Tick(DeltaTime);
+	Movement->TryClimbing();
+
+	for (float Seconds = 0.f; Seconds < 1.f; Seconds += DeltaTime)
+	{
+		Tick(DeltaTime);
+
+		if (Movement->IsClimbing())
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+AStaticMeshActor* FBotwTestWorld::SpawnBox(const FVector& Center, const FVector& Extent)
+{
+	AStaticMeshActor* Box = World->SpawnActor<AStaticMeshActor>(Center, FRotator::ZeroRotator);
+
+	UStaticMeshComponent* Mesh = Box->GetStaticMeshComponent();
+	Mesh->SetMobility(EComponentMobility::Movable);
+	Mesh->SetStaticMesh(LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube")));
+	Mesh->SetWorldScale3D(Extent * 2.f / BotwTestWorld::CubeSize);
+	Mesh->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+
+	return Box;
+}
+
+void FBotwTestWorld::Tick(float DeltaTime)
+{
+	World->Tick(LEVELTICK_All, DeltaTime);
+	++GFrameCounter;
+}
+
+#endif
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+class ABotwCharacter;
+class AStaticMeshActor;
+class UWorld;
+
+/**
+ * A game world for tests of the Botw characters: a floor, and a climbable wall thick enough to ledge up onto, ticked
+ * by hand at whatever rate a test asks for. Characters are the game's player Blueprint, run without a controller;
+ * tests add their input before each tick.
+ */
+class FBotwTestWorld
+{
+public:
+	/** X of the wall's face, which faces -X and rises from the floor at Z = 0. */
+	static constexpr float WallX = 400.f;
+
+	static constexpr float WallHeight = 500.f;
+
+	FBotwTestWorld();
+
+	~FBotwTestWorld();
+
+	UE_NONCOPYABLE(FBotwTestWorld);
+
+	UWorld* GetWorld() const { return World; }
+
+	/** Spawns a character standing on the floor, DistanceFromWall in front of the wall and facing it. */
+	ABotwCharacter* SpawnCharacter(float DistanceFromWall);
+
+	/** Lets the character find the wall in front of it and asks it to climb. Returns whether it started within a second. */
+	bool StartClimbing(ABotwCharacter& Character, float DeltaTime);
+
+	/** Adds a box that blocks everything, climbing queries included. */
+	AStaticMeshActor* SpawnBox(const FVector& Center, const FVector& Extent);
+
+	/** Ticks the world once and starts the next frame. */
+	void Tick(float DeltaTime);
+
+private:
+	UWorld* World = nullptr;
+};
+
+#endif